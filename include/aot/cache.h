@@ -18,20 +18,45 @@
 #include "common/span.h"
 #include "common/types.h"
 
+#include <cstdint>
 #include <string_view>
 
 namespace WasmEdge {
 namespace AOT {
 
 /// Caching compiled module.
+///
+/// Each entry has a metadata file next to it, with the AOT binary version,
+/// the target features of the running CPU, and the size, modification time
+/// and BLAKE3 hash of the entry. The hash is only checked for an entry
+/// modified since its commit. The modification time of the metadata file is
+/// the last use of the entry.
+/// The updates are serialized across the processes by a lock file in the
+/// root of the scope.
 class Cache {
 public:
   enum class StorageScope {
     Global,
     Local,
   };
+  /// Get the path of the compiled module of the data. An existing entry which
+  /// fails the verification against its metadata, or has none as not filled
+  /// by commit, is removed, so the module can be compiled again to the path.
+  /// Compiler::compile fills the cache through this and commit.
   static Expect<std::filesystem::path>
   getPath(Span<const Byte> Data, StorageScope Scope, std::string_view Key = {});
+  /// Move a compiled module into the path from getPath, and write its
+  /// metadata. The module should be compiled to another file in the same
+  /// directory, so the entry is replaced atomically. If the size limit in
+  /// bytes is not 0, the least recently used entries of the scope, other than
+  /// the committed one, are evicted to keep the scope under the limit.
+  static Expect<void> commit(const std::filesystem::path &Compiled,
+                             const std::filesystem::path &Path,
+                             StorageScope Scope, uint64_t SizeLimit = 0);
+  /// Evict the least recently used entries of the scope, or only of the key
+  /// if given, until the entries are no larger than the size limit in bytes.
+  static void evict(StorageScope Scope, uint64_t SizeLimit,
+                    std::string_view Key = {});
   static void clear(StorageScope Scope, std::string_view Key = {});
 };
 
@@ -13,13 +13,20 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "aot/cache.h"
 #include "ast/module.h"
 #include "common/configure.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
+#include "common/pgo.h"
 #include "common/span.h"
 
 #include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace WasmEdge {
 namespace AOT {
@@ -32,9 +39,43 @@ public:
   Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
                        std::filesystem::path OutputPath);
 
+  /// Compile the module into the AOT cache of the scope, unless the cache has
+  /// a verified entry of the data, and return the path of the entry. The
+  /// least recently used entries are evicted to keep the scope under the
+  /// cache size limit of the configuration.
+  Expect<std::filesystem::path> compile(Span<const Byte> Data,
+                                        const AST::Module &Module,
+                                        Cache::StorageScope Scope,
+                                        std::string_view Key = {});
+
+  /// Set the workload profile of the module. The function entry counts and
+  /// the branch weights of the compiled code follow the profile.
+  void setProfile(PGO::ModuleProfile P) { Profile = std::move(P); }
+
+  /// Add a module to be linked by the name, as registered by
+  /// VM::registerModule. The imported functions of the linked module, which
+  /// only compute on their arguments, are compiled into the module and called
+  /// directly. The linked module should be validated and outlive the
+  /// compilation. The output records the code hash of the module, and can
+  /// only be instantiated with the same module registered by the name.
+  void addLinkedModule(std::string_view Name, const AST::Module &Module) {
+    LinkedModules.emplace_back(Name, &Module);
+  }
+
+  /// Add a target CPU, named as in LLVM, such as `skylake-avx512`. The
+  /// module is compiled once for each target CPU, and the universal wasm
+  /// output carries an AOT section for each of them. The loader selects the
+  /// one best matching the running CPU. Without any target CPU, the module is
+  /// compiled for the host CPU, or the generic one if configured.
+  void addTargetCPU(std::string_view CPU) { TargetCPUs.emplace_back(CPU); }
+
   struct CompileContext;
+  struct TargetObject;
 
 private:
+  Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
+                       const std::filesystem::path &OutputPath,
+                       const std::string &TargetCPU, TargetObject &Target);
   void compile(const AST::ImportSection &ImportSection);
   void compile(const AST::ExportSection &ExportSection);
   void compile(const AST::TypeSection &TypeSection);
@@ -49,6 +90,9 @@ private:
   std::mutex Mutex;
   CompileContext *Context;
   const Configure Conf;
+  std::optional<PGO::ModuleProfile> Profile;
+  std::vector<std::pair<std::string, const AST::Module *>> LinkedModules;
+  std::vector<std::string> TargetCPUs;
 };
 
 } // namespace AOT
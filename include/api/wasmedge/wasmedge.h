@@ -77,6 +77,9 @@ typedef struct WasmEdge_ConfigureContext WasmEdge_ConfigureContext;
 /// Opaque struct of WasmEdge statistics.
 typedef struct WasmEdge_StatisticsContext WasmEdge_StatisticsContext;
 
+/// Opaque struct of WasmEdge metrics snapshot.
+typedef struct WasmEdge_MetricsSnapshotContext WasmEdge_MetricsSnapshotContext;
+
 /// Opaque struct of WasmEdge AST module.
 typedef struct WasmEdge_ASTModuleContext WasmEdge_ASTModuleContext;
 
@@ -135,6 +138,9 @@ typedef struct WasmEdge_CallingFrameContext WasmEdge_CallingFrameContext;
 /// Opaque struct of WasmEdge asynchronous result.
 typedef struct WasmEdge_Async WasmEdge_Async;
 
+/// Opaque struct of WasmEdge resolved function handle.
+typedef struct WasmEdge_FunctionHandleContext WasmEdge_FunctionHandleContext;
+
 /// Opaque struct of WasmEdge VM.
 typedef struct WasmEdge_VMContext WasmEdge_VMContext;
 
@@ -582,6 +588,101 @@ WasmEdge_ConfigureSetMaxMemoryPage(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern uint32_t
 WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the worker thread count of the asynchronous execution thread pool.
+///
+/// The VM contexts created with this configuration run the asynchronous
+/// executions, such as `WasmEdge_VMAsyncExecute`, on a pool of reused worker
+/// threads. The default value 0 creates a new thread for every asynchronous
+/// execution.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread pool size.
+/// \param Count the worker thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetAsyncThreadPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                         const uint32_t Count);
+
+/// Get the worker thread count of the asynchronous execution thread pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread pool size.
+///
+/// \returns the worker thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ConfigureGetAsyncThreadPoolSize(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the queue limit of the asynchronous execution thread pool.
+///
+/// Limit the count of pending asynchronous executions in the thread pool. The
+/// asynchronous execution functions block while the queue is full. The default
+/// value 0 means unbounded.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the queue limit.
+/// \param Limit the maximum count of pending asynchronous executions.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetAsyncQueueLimit(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Limit);
+
+/// Get the queue limit of the asynchronous execution thread pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the queue limit.
+///
+/// \returns the maximum count of pending asynchronous executions.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetAsyncQueueLimit(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the CPU affinity option of the asynchronous execution thread pool.
+///
+/// Pin the N-th worker thread to the N-th CPU if the platform supports it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsPinned the boolean value to pin the worker threads.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetAsyncThreadAffinity(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsPinned);
+
+/// Get the CPU affinity option of the asynchronous execution thread pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to pin the worker threads.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsAsyncThreadAffinity(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the perf map option of the loaded AOT codes.
+///
+/// If enabled, the symbols of the AOT codes loaded from the universal WASM
+/// format are appended to `/tmp/perf-<pid>.map`, so that the Linux `perf` tool
+/// can attribute the samples to the WASM functions. This only works on Linux.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsPerfMap the boolean value to write the perf map.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetPerfMap(WasmEdge_ConfigureContext *Cxt,
+                             const bool IsPerfMap);
+
+/// Get the perf map option of the loaded AOT codes.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to write the perf map.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsPerfMap(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the optimization level of AOT compiler.
 ///
 /// This function is thread-safe.
@@ -689,6 +790,28 @@ WasmEdge_ConfigureCompilerSetInterruptible(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureCompilerIsInterruptible(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the size limit of the AOT cache filled by the compiler.
+///
+/// The least recently used entries of the cache are evicted to keep the cache
+/// under the limit. This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the size limit.
+/// \param Limit the size limit in bytes, or 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetCacheSizeLimit(WasmEdge_ConfigureContext *Cxt,
+                                            const uint64_t Limit);
+
+/// Get the size limit of the AOT cache filled by the compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the size limit.
+///
+/// \returns the size limit in bytes, or 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureCompilerGetCacheSizeLimit(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the instruction counting option.
 ///
 /// This function is thread-safe.
@@ -841,6 +964,103 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt);
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge metrics functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Turn on or off the metrics of the host function calls.
+///
+/// The metrics are process-wide. The host function call counts and latencies
+/// are only recorded when turned on, which is off by default. The other
+/// metrics are always recorded.
+///
+/// \param IsEnable the boolean value to turn on the host call metrics.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_MetricsSetEnabled(const bool IsEnable);
+
+/// Get the boolean value of the host call metrics turned on.
+///
+/// \returns true if the host call metrics are turned on, false if not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_MetricsIsEnabled(void);
+
+/// Take a snapshot of the current values of the metrics.
+///
+/// The samples are named as in the Prometheus text format. Every histogram is
+/// expanded into its `_bucket`, `_sum` and `_count` samples.
+///
+/// The caller owns the object and should call `WasmEdge_MetricsSnapshotDelete`
+/// to destroy it.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_MetricsSnapshotContext *
+WasmEdge_MetricsSnapshotCreate(void);
+
+/// Get the sample count of the metrics snapshot.
+///
+/// \param Cxt the WasmEdge_MetricsSnapshotContext.
+///
+/// \returns the sample count.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_MetricsSnapshotGetLength(const WasmEdge_MetricsSnapshotContext *Cxt);
+
+/// Get the name of a sample in the metrics snapshot.
+///
+/// The returned string object is linked to the name in the snapshot, and the
+/// caller should __NOT__ call the `WasmEdge_StringDelete`.
+///
+/// \param Cxt the WasmEdge_MetricsSnapshotContext.
+/// \param Index the sample index.
+///
+/// \returns the sample name. Empty if the index is out of range.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_String
+WasmEdge_MetricsSnapshotGetName(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                const uint32_t Index);
+
+/// Get the labels of a sample in the metrics snapshot.
+///
+/// The labels are formatted as `key="value"` pairs separated by commas. The
+/// returned string object is linked to the labels in the snapshot, and the
+/// caller should __NOT__ call the `WasmEdge_StringDelete`.
+///
+/// \param Cxt the WasmEdge_MetricsSnapshotContext.
+/// \param Index the sample index.
+///
+/// \returns the sample labels. Empty if none or the index is out of range.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_String
+WasmEdge_MetricsSnapshotGetLabels(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                  const uint32_t Index);
+
+/// Get the value of a sample in the metrics snapshot.
+///
+/// \param Cxt the WasmEdge_MetricsSnapshotContext.
+/// \param Index the sample index.
+///
+/// \returns the sample value. 0 if the index is out of range.
+WASMEDGE_CAPI_EXPORT extern double
+WasmEdge_MetricsSnapshotGetValue(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                 const uint32_t Index);
+
+/// Deletion of the WasmEdge_MetricsSnapshotContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_MetricsSnapshotContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_MetricsSnapshotDelete(WasmEdge_MetricsSnapshotContext *Cxt);
+
+/// Write the metrics in the Prometheus text exposition format.
+///
+/// This function copy at most `Len` characters of the text to the buffer. The
+/// buffer is not terminated by `\0'.
+///
+/// \param Buf the buffer to fill the text, NULL for getting the length only.
+/// \param Len the buffer length.
+///
+/// \returns the length of the whole text.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_MetricsDumpPrometheus(char *Buf, const uint32_t Len);
+
+// <<<<<<<< WasmEdge metrics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge AST module functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 /// Get the length of imports list of the AST module.
@@ -2634,6 +2854,123 @@ WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncDelete(WasmEdge_Async *Cxt);
 
 // <<<<<<<< WasmEdge Async functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge function handle functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Creation of the WasmEdge_FunctionHandleContext.
+///
+/// The function handle binds a function instance to an executor and caches its
+/// function type, so that the function can be invoked repeatedly by
+/// `WasmEdge_FunctionHandleInvoke` without the name lookup, allocation, and
+/// type checking of every call. The function handle refers to the executor and
+/// the function instance, which should outlive it.
+///
+/// The caller owns the object and should call `WasmEdge_FunctionHandleDelete`
+/// to destroy it.
+///
+/// \param ExecCxt the WasmEdge_ExecutorContext to invoke the function.
+/// \param FuncCxt the function instance context to invoke.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_FunctionHandleContext *
+WasmEdge_FunctionHandleCreate(WasmEdge_ExecutorContext *ExecCxt,
+                              const WasmEdge_FunctionInstanceContext *FuncCxt);
+
+/// Get the function type of the function handle.
+///
+/// The function type context links to the function type in the function
+/// instance of the handle and owned by the function instance. The caller should
+/// __NOT__ call the `WasmEdge_FunctionTypeDelete`.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern const WasmEdge_FunctionTypeContext *
+WasmEdge_FunctionHandleGetFunctionType(
+    const WasmEdge_FunctionHandleContext *Cxt);
+
+/// Get the parameter count of the function handle.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext.
+///
+/// \returns the parameter count, 0 if `Cxt` is NULL.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_FunctionHandleGetParametersLength(
+    const WasmEdge_FunctionHandleContext *Cxt);
+
+/// Get the return count of the function handle.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext.
+///
+/// \returns the return count, 0 if `Cxt` is NULL.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_FunctionHandleGetReturnsLength(
+    const WasmEdge_FunctionHandleContext *Cxt);
+
+/// Invoke the function of the function handle with raw value slots.
+///
+/// Every parameter and return value takes one 128-bit slot, in the same
+/// representation as the `Value` field of `WasmEdge_Value`. For example, an
+/// `i32` value is in the low 32 bits, and an `f64` value is its bit pattern in
+/// the low 64 bits. The types of the parameters are not checked, so the slots
+/// must match the function type of the handle.
+///
+/// This function is thread-safe if the executor is.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext.
+/// \param Params the slot buffer with the parameter values.
+/// \param ParamLen the parameter buffer length, which should be the parameter
+/// count of the function.
+/// \param [out] Returns the slot buffer to fill the return values.
+/// \param ReturnLen the return buffer length, which should not be smaller than
+/// the return count of the function.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_FunctionHandleInvoke(
+    const WasmEdge_FunctionHandleContext *Cxt, const uint128_t *Params,
+    const uint32_t ParamLen, uint128_t *Returns, const uint32_t ReturnLen);
+
+/// Invoke the function of the function handle for a batch of calls.
+///
+/// The parameters of the calls are laid one after another in the `Params`
+/// buffer, which holds `Count` times the parameter count of slots. The return
+/// values are written into the `Returns` buffer in the same layout, which
+/// should hold `Count` times the return count of slots. The slots are in the
+/// representation described in `WasmEdge_FunctionHandleInvoke`. The frame
+/// setup, the statistics and the profiling are done once for the whole batch.
+///
+/// If the `Results` buffer is NULL, the batch stops at the first failed call
+/// and returns its error. Otherwise, the result of every call is written into
+/// the `Results` buffer, which should hold `Count` results, and the batch goes
+/// on after the failed calls. The batch always stops when the execution is
+/// terminated or interrupted, and the calls not run get the same result.
+///
+/// This function is thread-safe if the executor is.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext.
+/// \param Params the slot buffer with the parameter values of all calls.
+/// \param [out] Returns the slot buffer to fill the return values of all calls.
+/// \param Count the number of calls.
+/// \param [out] Results the WasmEdge_Result buffer to fill the result of every
+/// call, or NULL to stop at the first failed call.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_FunctionHandleInvokeBatch(
+    const WasmEdge_FunctionHandleContext *Cxt, const uint128_t *Params,
+    uint128_t *Returns, const uint32_t Count, WasmEdge_Result *Results);
+
+/// Deletion of the WasmEdge_FunctionHandleContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_FunctionHandleContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_FunctionHandleDelete(WasmEdge_FunctionHandleContext *Cxt);
+
+// <<<<<<<< WasmEdge function handle functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge VM functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 /// Creation of the WasmEdge_VMContext.
@@ -3051,6 +3388,47 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_VMExecuteRegistered(
     const WasmEdge_String FuncName, const WasmEdge_Value *Params,
     const uint32_t ParamLen, WasmEdge_Value *Returns, const uint32_t ReturnLen);
 
+/// Resolve an exported function of the instantiated module into a function
+/// handle.
+///
+/// The function handle refers to the executor in the VM context and the
+/// function instance, and can be invoked by `WasmEdge_FunctionHandleInvoke`
+/// until the VM context is reset or a new WASM module is instantiated.
+///
+/// The caller owns the object and should call `WasmEdge_FunctionHandleDelete`
+/// to destroy it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param FuncName the function name WasmEdge_String.
+///
+/// \returns pointer to context, NULL if the function is not found.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_FunctionHandleContext *
+WasmEdge_VMGetFunctionHandle(WasmEdge_VMContext *Cxt,
+                             const WasmEdge_String FuncName);
+
+/// Resolve an exported function of a registered module into a function handle.
+///
+/// The function handle refers to the executor in the VM context and the
+/// function instance, and can be invoked by `WasmEdge_FunctionHandleInvoke`
+/// until the VM context is reset.
+///
+/// The caller owns the object and should call `WasmEdge_FunctionHandleDelete`
+/// to destroy it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param ModuleName the module name WasmEdge_String.
+/// \param FuncName the function name WasmEdge_String.
+///
+/// \returns pointer to context, NULL if the function is not found.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_FunctionHandleContext *
+WasmEdge_VMGetFunctionHandleRegistered(WasmEdge_VMContext *Cxt,
+                                       const WasmEdge_String ModuleName,
+                                       const WasmEdge_String FuncName);
+
 /// Asynchronous invoke a WASM function by name.
 ///
 /// This is the final step to invoke a WASM function step by step.
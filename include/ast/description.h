@@ -16,6 +16,7 @@
 
 #include "ast/type.h"
 #include "common/enum_types.hpp"
+#include "common/name_index.h"
 
 #include <string>
 #include <string_view>
@@ -33,13 +34,19 @@ public:
 
   /// Getter and setter of external name.
   std::string_view getExternalName() const noexcept { return ExtName; }
-  void setExternalName(std::string_view Name) { ExtName = Name; }
+  void setExternalName(std::string_view Name) {
+    ExtName = Name;
+    ExtNameHash = hashName(Name);
+  }
+  /// Getter of the hash of external name.
+  uint64_t getExternalNameHash() const noexcept { return ExtNameHash; }
 
 protected:
   /// \name Data of Desc: rxternal name and external type.
   /// @{
   ExternalType ExtType;
   std::string ExtName;
+  uint64_t ExtNameHash = hashName({});
   /// @}
 };
 
@@ -48,7 +55,12 @@ class ImportDesc : public Desc {
 public:
   /// Getter and setter of module name.
   std::string_view getModuleName() const noexcept { return ModName; }
-  void setModuleName(std::string_view Name) { ModName = Name; }
+  void setModuleName(std::string_view Name) {
+    ModName = Name;
+    ModNameHash = hashName(Name);
+  }
+  /// Getter of the hash of module name.
+  uint64_t getModuleNameHash() const noexcept { return ModNameHash; }
 
   /// Getter and setter of external contents.
   uint32_t getExternalFuncTypeIdx() const noexcept { return FuncTypeIdx; }
@@ -64,6 +76,7 @@ private:
   /// \name Data of ImportDesc: Module name, External name, and content node.
   /// @{
   std::string ModName;
+  uint64_t ModNameHash = hashName({});
   uint32_t FuncTypeIdx = 0;
   TableType TabType;
   MemoryType MemType;
@@ -16,6 +16,9 @@
 
 #include "ast/section.h"
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace WasmEdge {
@@ -39,6 +42,16 @@ public:
   std::vector<CustomSection> &getCustomSections() noexcept {
     return CustomSecs;
   }
+
+  /// Getter of the function names in the name section, by the indices in the
+  /// function index space.
+  const std::unordered_map<uint32_t, std::string> &
+  getFunctionNames() const noexcept {
+    return FuncNames;
+  }
+  std::unordered_map<uint32_t, std::string> &getFunctionNames() noexcept {
+    return FuncNames;
+  }
   const TypeSection &getTypeSection() const { return TypeSec; }
   TypeSection &getTypeSection() { return TypeSec; }
   const ImportSection &getImportSection() const { return ImportSec; }
@@ -88,6 +101,7 @@ public:
     kPtrFunc,
     kMemoryAtomicNotify,
     kMemoryAtomicWait,
+    kProfileBlock,
     kIntrinsicMax,
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
@@ -98,6 +112,12 @@ public:
     IntrSymbol = std::move(S);
   }
 
+  /// Getter and setter of the hash of the code, over the type, import,
+  /// function, export and code sections. The hash tells if the functions
+  /// copied from a linked module by the AOT compiler are the same.
+  uint64_t getCodeHash() const noexcept { return CodeHash; }
+  void setCodeHash(uint64_t Hash) noexcept { CodeHash = Hash; }
+
   /// Getter and setter of validated flag.
   bool getIsValidated() const noexcept { return IsValidated; }
   void setIsValidated(bool V = true) noexcept { IsValidated = V; }
@@ -126,12 +146,22 @@ private:
   DataCountSection DataCountSec;
   /// @}
 
+  /// \name Function names of the name section.
+  /// @{
+  std::unordered_map<uint32_t, std::string> FuncNames;
+  /// @}
+
   /// \name Data of AOT.
   /// @{
   AOTSection AOTSec;
   Symbol<const IntrinsicsTable *> IntrSymbol;
   /// @}
 
+  /// \name Hash of the code.
+  /// @{
+  uint64_t CodeHash = 0;
+  /// @}
+
   /// \name Validated flag.
   /// @{
   bool IsValidated = false;
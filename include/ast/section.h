@@ -17,6 +17,8 @@
 #include "ast/segment.h"
 
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
@@ -242,6 +244,17 @@ public:
   uint8_t getArchType() const noexcept { return ArchType; }
   void setArchType(uint8_t Type) noexcept { ArchType = Type; }
 
+  /// Getter of the required target features, named as in LLVM.
+  constexpr const auto &getFeatures() const noexcept { return Features; }
+  constexpr auto &getFeatures() noexcept { return Features; }
+
+  /// Getter of the linked modules, by the names and the code hashes, whose
+  /// functions are compiled into the code.
+  constexpr const auto &getLinkedModules() const noexcept {
+    return LinkedModules;
+  }
+  constexpr auto &getLinkedModules() noexcept { return LinkedModules; }
+
   /// Getter and setter of version address.
   uint64_t getVersionAddress() const noexcept { return VersionAddress; }
   void setVersionAddress(uint64_t Addr) noexcept { VersionAddress = Addr; }
@@ -268,18 +281,27 @@ public:
   constexpr const auto &getSections() const noexcept { return Sections; }
   constexpr auto &getSections() noexcept { return Sections; }
 
+  /// Getter of the offsets of the section contents in the file.
+  constexpr const auto &getContentOffsets() const noexcept {
+    return ContentOffsets;
+  }
+  constexpr auto &getContentOffsets() noexcept { return ContentOffsets; }
+
 private:
   /// \name Data of AOTSection.
   /// @{
   uint32_t Version;
   uint8_t OSType;
   uint8_t ArchType;
+  std::vector<std::string> Features;
+  std::vector<std::pair<std::string, uint64_t>> LinkedModules;
   uint64_t VersionAddress;
   uint64_t IntrinsicsAddress;
   std::vector<uintptr_t> TypesAddress;
   std::vector<uintptr_t> CodesAddress;
   std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::vector<Byte>>>
       Sections;
+  std::vector<uint64_t> ContentOffsets;
   /// @}
 };
 
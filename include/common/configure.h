@@ -34,7 +34,9 @@ public:
         OFormat(RHS.OFormat.load(std::memory_order_relaxed)),
         DumpIR(RHS.DumpIR.load(std::memory_order_relaxed)),
         GenericBinary(RHS.GenericBinary.load(std::memory_order_relaxed)),
-        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)) {}
+        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)),
+        Instrumentation(RHS.Instrumentation.load(std::memory_order_relaxed)),
+        CacheSizeLimit(RHS.CacheSizeLimit.load(std::memory_order_relaxed)) {}
 
   /// AOT compiler optimization level enum class.
   enum class OptimizationLevel : uint8_t {
@@ -98,19 +100,46 @@ public:
     return Interruptible.load(std::memory_order_relaxed);
   }
 
+  /// Generate the code counting the executed opcodes and basic blocks into
+  /// the instrumenting profiler of the executor.
+  void setInstrumentation(bool IsInstrumentation) noexcept {
+    Instrumentation.store(IsInstrumentation, std::memory_order_relaxed);
+  }
+
+  bool isInstrumentation() const noexcept {
+    return Instrumentation.load(std::memory_order_relaxed);
+  }
+
+  /// Size limit in bytes of the AOT cache filled by the compiler. The least
+  /// recently used entries are evicted to keep under the limit. 0 for no
+  /// limit.
+  void setCacheSizeLimit(uint64_t Limit) noexcept {
+    CacheSizeLimit.store(Limit, std::memory_order_relaxed);
+  }
+
+  uint64_t getCacheSizeLimit() const noexcept {
+    return CacheSizeLimit.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<OptimizationLevel> OptLevel = OptimizationLevel::O3;
   std::atomic<OutputFormat> OFormat = OutputFormat::Wasm;
   std::atomic<bool> DumpIR = false;
   std::atomic<bool> GenericBinary = false;
   std::atomic<bool> Interruptible = false;
+  std::atomic<bool> Instrumentation = false;
+  std::atomic<uint64_t> CacheSizeLimit = 0;
 };
 
 class RuntimeConfigure {
 public:
   RuntimeConfigure() noexcept = default;
   RuntimeConfigure(const RuntimeConfigure &RHS) noexcept
-      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)) {}
+      : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)),
+        AsyncThreads(RHS.AsyncThreads.load(std::memory_order_relaxed)),
+        AsyncQueueLimit(RHS.AsyncQueueLimit.load(std::memory_order_relaxed)),
+        AsyncAffinity(RHS.AsyncAffinity.load(std::memory_order_relaxed)),
+        PerfMap(RHS.PerfMap.load(std::memory_order_relaxed)) {}
 
   void setMaxMemoryPage(const uint32_t Page) noexcept {
     MaxMemPage.store(Page, std::memory_order_relaxed);
@@ -120,8 +149,51 @@ public:
     return MaxMemPage.load(std::memory_order_relaxed);
   }
 
+  /// Worker count of the asynchronous execution thread pool. 0 means every
+  /// asynchronous execution runs on a newly created thread.
+  void setAsyncThreadPoolSize(const uint32_t Count) noexcept {
+    AsyncThreads.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getAsyncThreadPoolSize() const noexcept {
+    return AsyncThreads.load(std::memory_order_relaxed);
+  }
+
+  /// Maximum count of pending asynchronous executions in the thread pool
+  /// queue. Submitting to a full queue blocks. 0 means unbounded.
+  void setAsyncQueueLimit(const uint32_t Limit) noexcept {
+    AsyncQueueLimit.store(Limit, std::memory_order_relaxed);
+  }
+
+  uint32_t getAsyncQueueLimit() const noexcept {
+    return AsyncQueueLimit.load(std::memory_order_relaxed);
+  }
+
+  /// Pin the thread pool workers to CPUs.
+  void setAsyncThreadAffinity(const bool IsPinned) noexcept {
+    AsyncAffinity.store(IsPinned, std::memory_order_relaxed);
+  }
+
+  bool isAsyncThreadAffinity() const noexcept {
+    return AsyncAffinity.load(std::memory_order_relaxed);
+  }
+
+  /// Write the symbols of the loaded AOT codes to `/tmp/perf-<pid>.map`
+  /// for the Linux perf tool.
+  void setPerfMap(const bool IsPerfMap) noexcept {
+    PerfMap.store(IsPerfMap, std::memory_order_relaxed);
+  }
+
+  bool isPerfMap() const noexcept {
+    return PerfMap.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> MaxMemPage = 65536;
+  std::atomic<uint32_t> AsyncThreads = 0;
+  std::atomic<uint32_t> AsyncQueueLimit = 0;
+  std::atomic<bool> AsyncAffinity = false;
+  std::atomic<bool> PerfMap = false;
 };
 
 class StatisticsConfigure {
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/epoch.h - Epoch-based reclamation -----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the process-wide epoch-based reclamation, for the data
+/// structures which are read without locks and replaced by copies.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <type_traits>
+
+namespace WasmEdge {
+namespace Epoch {
+
+/// Enter and leave a read-side critical section. The sections can be nested.
+/// Entering only writes the record of the current thread, so the readers do
+/// not contend on any shared cache line.
+void enter() noexcept;
+void leave() noexcept;
+
+/// Scoped read-side critical section.
+class Guard {
+public:
+  Guard() noexcept { enter(); }
+  ~Guard() noexcept { leave(); }
+  Guard(const Guard &) = delete;
+  Guard &operator=(const Guard &) = delete;
+};
+
+/// Retire an object which is no longer reachable from the shared pointers.
+/// The deleter is called once all the readers which may have loaded the
+/// object have left their critical sections. The object should be unlinked
+/// by a sequentially consistent store or exchange before the retirement.
+void retire(void *Ptr, void (*Deleter)(void *));
+template <typename T> void retire(T *Ptr) {
+  using ObjT = std::remove_const_t<T>;
+  retire(const_cast<ObjT *>(Ptr),
+         [](void *Obj) { delete static_cast<ObjT *>(Obj); });
+}
+
+/// Delete the retired objects which are no longer referenced by any reader.
+/// Called by retire(), so it only needs to be called to release the memory
+/// earlier.
+void reclaim();
+
+} // namespace Epoch
+} // namespace WasmEdge
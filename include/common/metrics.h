@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/metrics.h - Runtime metrics definition ------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the process-wide registry of the runtime metrics.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace WasmEdge {
+namespace Metrics {
+
+/// Monotonic counter. The value is striped over cache lines, so that the
+/// threads updating the same counter do not contend.
+class Counter {
+public:
+  void add(uint64_t Value = 1) noexcept {
+    Shards[shardIndex()].Value.fetch_add(Value, std::memory_order_relaxed);
+  }
+
+  uint64_t get() const noexcept {
+    uint64_t Total = 0;
+    for (const auto &Shard : Shards) {
+      Total += Shard.Value.load(std::memory_order_relaxed);
+    }
+    return Total;
+  }
+
+private:
+  static inline constexpr uint32_t kShards = 8;
+  struct alignas(64) Shard {
+    std::atomic_uint64_t Value = 0;
+  };
+
+  static uint32_t shardIndex() noexcept {
+    static std::atomic_uint32_t NextIndex = 0;
+    static thread_local const uint32_t Index =
+        NextIndex.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return Index;
+  }
+
+  std::array<Shard, kShards> Shards;
+};
+
+/// Value which goes up and down.
+class Gauge {
+public:
+  void add(int64_t Value) noexcept {
+    Current.fetch_add(Value, std::memory_order_relaxed);
+  }
+  void sub(int64_t Value) noexcept {
+    Current.fetch_sub(Value, std::memory_order_relaxed);
+  }
+  int64_t get() const noexcept {
+    return Current.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic_int64_t Current = 0;
+};
+
+/// Latency histogram with decimal buckets from 1us to 10s.
+class Histogram {
+public:
+  /// Upper bounds of the buckets in nanoseconds. The last bucket is +Inf.
+  static inline constexpr std::array<uint64_t, 8> kBounds = {
+      UINT64_C(1000),      UINT64_C(10000),      UINT64_C(100000),
+      UINT64_C(1000000),   UINT64_C(10000000),   UINT64_C(100000000),
+      UINT64_C(1000000000), UINT64_C(10000000000)};
+
+  void observe(std::chrono::nanoseconds Duration) noexcept {
+    const auto Nano = static_cast<uint64_t>(std::max<int64_t>(
+        static_cast<int64_t>(Duration.count()), INT64_C(0)));
+    uint32_t I = 0;
+    while (I < kBounds.size() && Nano > kBounds[I]) {
+      ++I;
+    }
+    Buckets[I].fetch_add(1, std::memory_order_relaxed);
+    Sum.fetch_add(Nano, std::memory_order_relaxed);
+  }
+
+  /// Getter of the count of observations in the bucket, not cumulative.
+  uint64_t getBucket(uint32_t Index) const noexcept {
+    return Buckets[Index].load(std::memory_order_relaxed);
+  }
+  uint64_t getCount() const noexcept {
+    uint64_t Total = 0;
+    for (const auto &Bucket : Buckets) {
+      Total += Bucket.load(std::memory_order_relaxed);
+    }
+    return Total;
+  }
+  std::chrono::nanoseconds getSum() const noexcept {
+    return std::chrono::nanoseconds(Sum.load(std::memory_order_relaxed));
+  }
+
+private:
+  std::array<std::atomic_uint64_t, kBounds.size() + 1> Buckets = {};
+  std::atomic_uint64_t Sum = 0;
+};
+
+/// One value of a snapshot, in the naming of the Prometheus text format.
+struct Sample {
+  std::string Name;
+  /// Labels as `key="value",...`, may be empty.
+  std::string Labels;
+  double Value;
+};
+
+/// Process-wide registry of the metrics. A metric is identified by its name
+/// and labels, and lives until the process exits, so the references to it
+/// can be cached.
+class Registry {
+public:
+  /// Get the registry of this process.
+  static Registry &global() noexcept;
+
+  /// Find or create a metric. \p Labels is formatted by label().
+  Counter &counter(std::string_view Name, std::string_view Help,
+                   std::string_view Labels = {});
+  Gauge &gauge(std::string_view Name, std::string_view Help,
+               std::string_view Labels = {});
+  Histogram &histogram(std::string_view Name, std::string_view Help,
+                       std::string_view Labels = {});
+
+  /// Get the current values of all metrics. Histograms are expanded into
+  /// their `_bucket`, `_sum` and `_count` samples.
+  std::vector<Sample> snapshot() const;
+
+  /// Write all metrics in the Prometheus text exposition format.
+  void dumpPrometheus(std::ostream &OS) const;
+
+private:
+  using Metric = std::variant<Counter, Gauge, Histogram>;
+  struct Family {
+    std::string Help;
+    std::map<std::string, std::unique_ptr<Metric>, std::less<>> Series;
+  };
+
+  template <typename T>
+  T &get(std::string_view Name, std::string_view Help,
+         std::string_view Labels);
+
+  mutable std::mutex Mutex;
+  std::map<std::string, Family, std::less<>> Families;
+};
+
+/// Format a label as `key="value"`, with the value escaped.
+std::string label(std::string_view Key, std::string_view Value);
+
+/// Turn the optional metrics on the hot paths on or off. The metrics of rare
+/// events, such as instantiations and memory growth, are always recorded.
+void setEnabled(bool Enable) noexcept;
+bool isEnabled() noexcept;
+
+/// The metrics of the runtime.
+struct RuntimeMetrics {
+  Counter &InstancesCreated;
+  Counter &InstancesDestroyed;
+  Histogram &InstantiationLatency;
+  Gauge &MemoryPages;
+  Counter &GasConsumed;
+  Counter &AOTCacheHits;
+  Counter &AOTCacheMisses;
+};
+const RuntimeMetrics &runtime() noexcept;
+
+/// The metrics of calls to a host function.
+struct HostCallMetrics {
+  Counter &Calls;
+  Histogram &Latency;
+};
+/// Get the metrics of a host function named `module.name`.
+const HostCallMetrics &hostCall(std::string_view ModName,
+                                std::string_view FuncName);
+
+/// Count an execution failed with the error \p Code, labeled by its name.
+void addTrap(std::string_view Code);
+
+} // namespace Metrics
+} // namespace WasmEdge
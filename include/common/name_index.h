@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/name_index.h - Hashed name index definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the open-addressing hash index from names to instances.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+
+/// FNV-1a hash of a name. The names in the AST nodes carry their hashes, so
+/// that the lookups during linking do not hash them again.
+inline constexpr uint64_t hashName(std::string_view Name) noexcept {
+  uint64_t Hash = UINT64_C(0xCBF29CE484222325);
+  for (const char C : Name) {
+    Hash ^= static_cast<uint8_t>(C);
+    Hash *= UINT64_C(0x100000001B3);
+  }
+  return Hash;
+}
+
+/// Open-addressing hash index from names to pointers, with linear probing.
+/// The names are not copied, so the strings should outlive their entries,
+/// such as the keys of the map owning the names. Null pointers can not be
+/// stored.
+template <typename T> class NameIndex {
+public:
+  /// Insert or assign the pointer of a name.
+  void insert(std::string_view Name, uint64_t Hash, T *Ptr) {
+    if ((Count + 1) * 2 > Slots.size()) {
+      rehash(Slots.empty() ? 16 : Slots.size() * 2);
+    }
+    const auto Mask = Slots.size() - 1;
+    for (auto I = Hash & Mask;; I = (I + 1) & Mask) {
+      auto &S = Slots[I];
+      if (S.Ptr == nullptr) {
+        S = Slot{Hash, Name, Ptr};
+        ++Count;
+        return;
+      }
+      if (S.Hash == Hash && S.Name == Name) {
+        S.Name = Name;
+        S.Ptr = Ptr;
+        return;
+      }
+    }
+  }
+
+  /// Find the pointer of a name, or null if not found.
+  T *find(std::string_view Name, uint64_t Hash) const noexcept {
+    if (Count == 0) {
+      return nullptr;
+    }
+    const auto Mask = Slots.size() - 1;
+    for (auto I = Hash & Mask;; I = (I + 1) & Mask) {
+      const auto &S = Slots[I];
+      if (S.Ptr == nullptr) {
+        return nullptr;
+      }
+      if (S.Hash == Hash && S.Name == Name) {
+        return S.Ptr;
+      }
+    }
+  }
+
+  /// Erase a name. The following entries of the probe sequence are shifted
+  /// back, so no tombstones are left.
+  void erase(std::string_view Name, uint64_t Hash) noexcept {
+    if (Count == 0) {
+      return;
+    }
+    const auto Mask = Slots.size() - 1;
+    auto I = Hash & Mask;
+    while (true) {
+      const auto &S = Slots[I];
+      if (S.Ptr == nullptr) {
+        return;
+      }
+      if (S.Hash == Hash && S.Name == Name) {
+        break;
+      }
+      I = (I + 1) & Mask;
+    }
+    for (auto J = (I + 1) & Mask; Slots[J].Ptr != nullptr; J = (J + 1) & Mask) {
+      // Move the entry back if its home slot is not in (I, J].
+      const auto Home = Slots[J].Hash & Mask;
+      if (((J - Home) & Mask) >= ((J - I) & Mask)) {
+        Slots[I] = Slots[J];
+        I = J;
+      }
+    }
+    Slots[I] = Slot{};
+    --Count;
+  }
+
+  void clear() noexcept {
+    Slots.clear();
+    Count = 0;
+  }
+
+  size_t size() const noexcept { return Count; }
+
+private:
+  struct Slot {
+    uint64_t Hash = 0;
+    std::string_view Name;
+    T *Ptr = nullptr;
+  };
+
+  void rehash(size_t Size) {
+    std::vector<Slot> Old(Size);
+    std::swap(Old, Slots);
+    const auto Mask = Size - 1;
+    for (const auto &S : Old) {
+      if (S.Ptr != nullptr) {
+        auto I = S.Hash & Mask;
+        while (Slots[I].Ptr != nullptr) {
+          I = (I + 1) & Mask;
+        }
+        Slots[I] = S;
+      }
+    }
+  }
+
+  std::vector<Slot> Slots;
+  size_t Count = 0;
+};
+
+} // namespace WasmEdge
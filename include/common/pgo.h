@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/pgo.h - Workload profile definition ---------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the workload profile recorded by the runtime and used
+/// by the AOT compiler for the profile-guided optimization.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace WasmEdge {
+namespace PGO {
+
+/// Profile of a function. The branch counts are keyed by the wasm byte offset
+/// of the branch instruction. `if` and `br_if` have the counts of the taken
+/// branch and of the fall-through, and `br_table` has a count per label with
+/// the default label last.
+struct FunctionProfile {
+  uint64_t EntryCount = 0;
+  std::map<uint32_t, std::vector<uint64_t>> Branches;
+};
+
+/// Profile of a module, keyed by the function index.
+struct ModuleProfile {
+  std::map<uint32_t, FunctionProfile> Functions;
+};
+
+/// Profile of the executed modules, keyed by the module name. The module run
+/// by the runtime tool has an empty name.
+///
+/// The text format starts with a `wasmedge-profile 1` line, followed by the
+/// modules:
+///
+///     module NAME
+///     function INDEX ENTRY_COUNT
+///     branch INDEX OFFSET COUNT...
+struct Profile {
+  std::map<std::string, ModuleProfile, std::less<>> Modules;
+
+  void write(std::ostream &OS) const;
+  /// Read a profile in the text format. Return false if it is malformed.
+  bool read(std::istream &IS);
+};
+
+} // namespace PGO
+} // namespace WasmEdge
@@ -15,78 +15,200 @@
 
 #include "errcode.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 
 namespace WasmEdge {
 namespace Timer {
 
 enum class TimerTag : uint32_t { Wasm, HostFunc, Max };
 
+/// Timer accumulating the elapsed time of each tag over all threads.
+///
+/// Every thread records into its own slot, which it finds through a small
+/// thread-local cache. Starting and stopping a record only touch the slot of
+/// the calling thread and take no lock. The slots are summed up on read. When
+/// a thread exits, its slot is folded into the retired totals and freed.
 class Timer {
 public:
   using Clock = std::chrono::steady_clock;
 
-  Timer() noexcept { unsafeReset(); }
+  Timer() noexcept
+      : Id(NextId.fetch_add(1, std::memory_order_relaxed)),
+        Shared(std::make_shared<State>()) {}
+  /// The slots are found by the id, so a copy would record into the slots of
+  /// the original.
+  Timer(const Timer &) = delete;
+  Timer &operator=(const Timer &) = delete;
 
   void startRecord(const TimerTag TT) noexcept {
     assuming(TT < TimerTag::Max);
-    std::unique_lock Lock(Mutex);
     const uint32_t Index = static_cast<uint32_t>(TT);
-    StartTime[Index].emplace(std::this_thread::get_id(), Clock::now());
+    auto &Start = localSlot().Start[Index];
+    // Keep the earliest start if the record is already running.
+    if (Start.load(std::memory_order_relaxed) == kIdle) {
+      Start.store(now(), std::memory_order_relaxed);
+    }
   }
 
   void stopRecord(const TimerTag TT) noexcept {
     assuming(TT < TimerTag::Max);
-    std::unique_lock Lock(Mutex);
     const uint32_t Index = static_cast<uint32_t>(TT);
-    auto &Map = StartTime[Index];
-    if (auto Iter = Map.find(std::this_thread::get_id()); Iter != Map.end()) {
-      const auto Diff = Clock::now() - Iter->second;
-      RecTime[Index] += Diff;
-      Map.erase(Iter);
+    auto &S = localSlot();
+    if (const auto Begin = S.Start[Index].exchange(kIdle,
+                                                   std::memory_order_relaxed);
+        Begin != kIdle) {
+      S.Elapsed[Index].fetch_add(now() - Begin, std::memory_order_relaxed);
     }
   }
 
   void clearRecord(const TimerTag TT) noexcept {
     assuming(TT < TimerTag::Max);
-    std::unique_lock Lock(Mutex);
+    std::shared_lock Lock(Shared->Mutex);
     const uint32_t Index = static_cast<uint32_t>(TT);
-    StartTime[Index].clear();
-    RecTime[Index] = Clock::duration::zero();
+    Shared->Retired[Index].store(0, std::memory_order_relaxed);
+    for (auto &S : Shared->Slots) {
+      S->Start[Index].store(kIdle, std::memory_order_relaxed);
+      S->Elapsed[Index].store(0, std::memory_order_relaxed);
+    }
   }
 
   Clock::duration getRecord(const TimerTag TT) const noexcept {
     assuming(TT < TimerTag::Max);
-    std::shared_lock Lock(Mutex);
+    std::shared_lock Lock(Shared->Mutex);
     const uint32_t Index = static_cast<uint32_t>(TT);
-    return RecTime[Index];
+    Clock::rep Total = Shared->Retired[Index].load(std::memory_order_relaxed);
+    for (const auto &S : Shared->Slots) {
+      Total += S->Elapsed[Index].load(std::memory_order_relaxed);
+    }
+    return Clock::duration(Total);
   }
 
   void reset() noexcept {
-    std::unique_lock Lock(Mutex);
-    unsafeReset();
+    for (uint32_t I = 0; I < uint32_t(TimerTag::Max); ++I) {
+      clearRecord(static_cast<TimerTag>(I));
+    }
   }
 
 private:
-  void unsafeReset() noexcept {
-    for (auto &Start : StartTime) {
-      Start.clear();
+  static inline constexpr Clock::rep kIdle =
+      std::numeric_limits<Clock::rep>::min();
+
+  /// Records of one thread. Only the owner thread starts and stops them.
+  struct alignas(64) Slot {
+    Slot() noexcept {
+      for (uint32_t I = 0; I < uint32_t(TimerTag::Max); ++I) {
+        Start[I].store(kIdle, std::memory_order_relaxed);
+        Elapsed[I].store(0, std::memory_order_relaxed);
+      }
+    }
+    std::array<std::atomic<Clock::rep>, uint32_t(TimerTag::Max)> Start;
+    std::array<std::atomic<Clock::rep>, uint32_t(TimerTag::Max)> Elapsed;
+  };
+
+  /// Slots of a timer, shared with the exiting threads retiring their slots.
+  struct State {
+    State() noexcept {
+      for (auto &R : Retired) {
+        R.store(0, std::memory_order_relaxed);
+      }
+    }
+    /// Guards the slot list.
+    mutable std::shared_mutex Mutex;
+    std::vector<std::unique_ptr<Slot>> Slots;
+    /// Elapsed time of the exited threads.
+    std::array<std::atomic<Clock::rep>, uint32_t(TimerTag::Max)> Retired;
+  };
+
+  /// Slots registered by a thread, retired when the thread exits. A record
+  /// still running at the exit is dropped.
+  struct ThreadSlots {
+    struct Entry {
+      uint64_t TimerId;
+      std::weak_ptr<State> Owner;
+      Slot *S;
+    };
+    std::vector<Entry> Entries;
+
+    ~ThreadSlots() noexcept {
+      for (auto &E : Entries) {
+        if (auto Owner = E.Owner.lock()) {
+          std::unique_lock Lock(Owner->Mutex);
+          for (uint32_t I = 0; I < uint32_t(TimerTag::Max); ++I) {
+            Owner->Retired[I].fetch_add(
+                E.S->Elapsed[I].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+          }
+          auto &Slots = Owner->Slots;
+          Slots.erase(std::find_if(
+              Slots.begin(), Slots.end(),
+              [&E](const auto &S) noexcept { return S.get() == E.S; }));
+        }
+      }
+    }
+  };
+
+  struct CacheEntry {
+    const Timer *Owner;
+    uint64_t TimerId;
+    Slot *S;
+  };
+
+  static Clock::rep now() noexcept {
+    return Clock::now().time_since_epoch().count();
+  }
+
+  Slot &localSlot() noexcept {
+    auto &Entry = LocalCache[Id % LocalCache.size()];
+    if (likely(Entry.Owner == this && Entry.TimerId == Id)) {
+      return *Entry.S;
     }
-    for (auto &Rec : RecTime) {
-      Rec = Clock::duration::zero();
+    return registerThread(Entry);
+  }
+
+  Slot &registerThread(CacheEntry &Entry) noexcept {
+    // Look up the slot of this thread, which may be evicted from the cache
+    // by another timer, and drop the entries of the destroyed timers.
+    auto &Entries = LocalSlots.Entries;
+    Slot *Found = nullptr;
+    for (auto Iter = Entries.begin(); Iter != Entries.end();) {
+      if (Iter->Owner.expired()) {
+        Iter = Entries.erase(Iter);
+        continue;
+      }
+      if (Iter->TimerId == Id) {
+        Found = Iter->S;
+      }
+      ++Iter;
     }
+    if (Found == nullptr) {
+      std::unique_lock Lock(Shared->Mutex);
+      Found = Shared->Slots.emplace_back(std::make_unique<Slot>()).get();
+      Entries.push_back({Id, Shared, Found});
+    }
+    Entry.Owner = this;
+    Entry.TimerId = Id;
+    Entry.S = Found;
+    return *Found;
   }
 
-  mutable std::shared_mutex Mutex;
-  std::array<std::unordered_map<std::thread::id, Clock::time_point>,
-             uint32_t(TimerTag::Max)>
-      StartTime{};
-  std::array<Clock::duration, uint32_t(TimerTag::Max)> RecTime{};
+  /// Id of this timer. Ids are not reused, so a cache entry can not refer to
+  /// a destroyed timer allocated at the same address.
+  const uint64_t Id;
+  std::shared_ptr<State> Shared;
+
+  static inline std::atomic_uint64_t NextId{1};
+  static inline thread_local std::array<CacheEntry, 4> LocalCache{};
+  static inline thread_local ThreadSlots LocalSlots;
 };
 
 } // namespace Timer
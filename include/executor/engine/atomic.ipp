@@ -14,9 +14,9 @@ template <typename T>
 TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::MemoryInstance &MemInst,
                                    const AST::Instruction &Instr) {
-  ValVariant RawAddress = StackMgr.pop();
+  ValVariant RawTimeout = StackMgr.pop();
   ValVariant RawValue = StackMgr.pop();
-  ValVariant &RawTimeout = StackMgr.getTop();
+  ValVariant &RawAddress = StackMgr.getTop();
 
   uint32_t Address = RawAddress.get<uint32_t>();
   if (Address >
@@ -54,7 +54,7 @@ TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
   } else {
-    RawTimeout.emplace<uint32_t>(*Res);
+    RawAddress.emplace<uint32_t>(*Res);
   }
   return {};
 }
@@ -447,7 +447,7 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
     return Unexpect(ErrCode::Value::WaitOnUnsharedMemory);
   }
 
-  std::optional<std::chrono::time_point<std::chrono::steady_clock>> Until;
+  std::optional<WaitTimePoint> Until;
   if (Timeout >= 0) {
     Until.emplace(std::chrono::steady_clock::now() +
                   std::chrono::nanoseconds(Timeout));
@@ -456,41 +456,23 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
   auto *AtomicObj = MemInst.getPointer<std::atomic<T> *>(Address);
   assuming(AtomicObj);
 
-  if (AtomicObj->load() != Expected) {
-    return UINT32_C(1); // NotEqual
-  }
-
-  decltype(WaiterMap)::iterator WaiterIterator;
+  Waiter W(&MemInst, Address);
+  WaiterBucket &Bucket = getWaiterBucket(&MemInst, Address);
   {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterIterator = WaiterMap.emplace(Address, &MemInst);
-  }
-
-  cxx20::scope_exit ScopeExitHolder([&]() noexcept {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterMap.erase(WaiterIterator);
-  });
-
-  while (true) {
-    std::unique_lock<decltype(WaiterIterator->second.Mutex)> Locker(
-        WaiterIterator->second.Mutex);
-    std::cv_status WaitResult = std::cv_status::no_timeout;
-    if (!Until) {
-      WaiterIterator->second.Cond.wait(Locker);
-    } else {
-      WaitResult = WaiterIterator->second.Cond.wait_until(Locker, *Until);
-    }
+    // Compare and enqueue under the bucket lock, so that a notifier which
+    // stores the new value and then notifies can not miss this waiter.
+    std::unique_lock<decltype(Bucket.Mutex)> Locker(Bucket.Mutex);
     if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
       spdlog::error(ErrCode::Value::Interrupted);
       return Unexpect(ErrCode::Value::Interrupted);
     }
-    if (likely(AtomicObj->load() != Expected)) {
-      return UINT32_C(0); // ok
-    }
-    if (WaitResult == std::cv_status::timeout) {
-      return UINT32_C(2); // Timed-out
+    if (AtomicObj->load() != Expected) {
+      return UINT32_C(1); // NotEqual
     }
+    Bucket.push(W);
   }
+
+  return waitNotified(Bucket, W, Until);
 }
 
 } // namespace Executor
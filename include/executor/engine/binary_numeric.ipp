@@ -291,6 +291,12 @@ Expect<void> Executor::runVectorNarrowOp(ValVariant &Val1,
   using HVTOut [[gnu::vector_size(8)]] = TOut;
   using VTOut [[gnu::vector_size(16)]] = TOut;
 
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  if (detail::vectorNarrow<TOut>(Val1.get<VTIn>(), Val2.get<VTIn>(),
+                                 Val1.get<VTOut>())) {
+    return {};
+  }
+#endif
   const VTIn Min = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::min());
   const VTIn Max = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::max());
   VTIn V1 = Val1.get<VTIn>();
@@ -349,6 +355,10 @@ template <typename T>
 Expect<void> Executor::runVectorAddSatOp(ValVariant &Val1,
                                          const ValVariant &Val2) const {
   using VT [[gnu::vector_size(16)]] = T;
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  VT &V1 = Val1.get<VT>();
+  V1 = detail::vectorAddSat(V1, Val2.get<VT>());
+#else
   using UVT [[gnu::vector_size(16)]] = std::make_unsigned_t<T>;
   UVT &V1 = Val1.get<UVT>();
   const UVT &V2 = Val2.get<UVT>();
@@ -362,6 +372,7 @@ Expect<void> Executor::runVectorAddSatOp(ValVariant &Val1,
   } else {
     V1 = Result | (Result < V1);
   }
+#endif
 
   return {};
 }
@@ -380,6 +391,10 @@ template <typename T>
 Expect<void> Executor::runVectorSubSatOp(ValVariant &Val1,
                                          const ValVariant &Val2) const {
   using VT [[gnu::vector_size(16)]] = T;
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  VT &V1 = Val1.get<VT>();
+  V1 = detail::vectorSubSat(V1, Val2.get<VT>());
+#else
   using UVT [[gnu::vector_size(16)]] = std::make_unsigned_t<T>;
   UVT &V1 = Val1.get<UVT>();
   const UVT &V2 = Val2.get<UVT>();
@@ -393,6 +408,7 @@ Expect<void> Executor::runVectorSubSatOp(ValVariant &Val1,
   } else {
     V1 = Result & (Result <= V1);
   }
+#endif
 
   return {};
 }
@@ -446,6 +462,9 @@ Expect<void> Executor::runVectorFMinOp(ValVariant &Val1,
   using VT [[gnu::vector_size(16)]] = T;
   VT &V1 = Val1.get<VT>();
   const VT &V2 = Val2.get<VT>();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  V1 = detail::vectorFMin(V1, V2);
+#else
   VT R = reinterpret_cast<VT>(reinterpret_cast<uint64x2_t>(V1) |
                               reinterpret_cast<uint64x2_t>(V2));
   R = detail::vectorSelect(V1 < V2, V1, R);
@@ -453,6 +472,7 @@ Expect<void> Executor::runVectorFMinOp(ValVariant &Val1,
   R = detail::vectorSelect(V1 == V1, R, V1);
   R = detail::vectorSelect(V2 == V2, R, V2);
   V1 = R;
+#endif
 
   return {};
 }
@@ -463,6 +483,9 @@ Expect<void> Executor::runVectorFMaxOp(ValVariant &Val1,
   using VT [[gnu::vector_size(16)]] = T;
   VT &V1 = Val1.get<VT>();
   const VT &V2 = Val2.get<VT>();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  V1 = detail::vectorFMax(V1, V2);
+#else
   VT R = reinterpret_cast<VT>(reinterpret_cast<uint64x2_t>(V1) &
                               reinterpret_cast<uint64x2_t>(V2));
   R = detail::vectorSelect(V1 < V2, V2, R);
@@ -470,6 +493,7 @@ Expect<void> Executor::runVectorFMaxOp(ValVariant &Val1,
   R = detail::vectorSelect(V1 == V1, R, V1);
   R = detail::vectorSelect(V2 == V2, R, V2);
   V1 = R;
+#endif
 
   return {};
 }
@@ -479,13 +503,17 @@ Expect<void> Executor::runVectorAvgrOp(ValVariant &Val1,
                                        const ValVariant &Val2) const {
   static_assert(sizeof(T) * 2 == sizeof(ET));
   using VT [[gnu::vector_size(16)]] = T;
-  using EVT [[gnu::vector_size(32)]] = ET;
   VT &V1 = Val1.get<VT>();
   const VT &V2 = Val2.get<VT>();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  V1 = detail::vectorAvgr(V1, V2);
+#else
+  using EVT [[gnu::vector_size(32)]] = ET;
   const EVT EV1 = __builtin_convertvector(V1, EVT);
   const EVT EV2 = __builtin_convertvector(V2, EVT);
   // Add 1 for rounding up .5
   V1 = __builtin_convertvector((EV1 + EV2 + 1) / 2, VT);
+#endif
 
   return {};
 }
@@ -554,6 +582,11 @@ Expect<void> Executor::runVectorExtMulHighOp(ValVariant &Val1,
 
 inline Expect<void>
 Executor::runVectorQ15MulSatOp(ValVariant &Val1, const ValVariant &Val2) const {
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+  if (detail::vectorQ15MulrSat(Val1.get<int16x8_t>(), Val2.get<int16x8_t>())) {
+    return {};
+  }
+#endif
   using int32x8_t [[gnu::vector_size(32)]] = int32_t;
   const auto &V1 = Val1.get<int16x8_t>();
   const auto &V2 = Val2.get<int16x8_t>();
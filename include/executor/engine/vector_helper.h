@@ -3,8 +3,18 @@
 
 #pragma once
 
+#include "common/types.h"
+
 #include <type_traits>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define WASMEDGE_VECTOR_INTRINSICS 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define WASMEDGE_VECTOR_INTRINSICS 1
+#endif
+
 namespace WasmEdge {
 namespace Executor {
 namespace detail {
@@ -21,6 +31,318 @@ vectorSelect(U Cond, V A, V B) noexcept {
 #endif
 }
 
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+// Native kernels of the v128 operations which the vector extensions lower to
+// scalar loops. SSE2 and NEON are the baselines of x86-64 and AArch64. The
+// kernels needing later x86 extensions are checked at runtime, unless the
+// build already targets them, and return false if not supported.
+
+#if defined(__x86_64__)
+#if defined(__SSSE3__)
+inline constexpr bool HasSSSE3 = true;
+#else
+inline const bool HasSSSE3 = []() noexcept {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}();
+#endif
+#if defined(__SSE4_1__)
+inline constexpr bool HasSSE4_1 = true;
+#else
+inline const bool HasSSE4_1 = []() noexcept {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.1");
+}();
+#endif
+
+template <typename V> inline __m128i toM128i(V Value) noexcept {
+  return reinterpret_cast<__m128i>(Value);
+}
+
+inline int8x16_t vectorAddSat(int8x16_t A, int8x16_t B) noexcept {
+  return reinterpret_cast<int8x16_t>(_mm_adds_epi8(toM128i(A), toM128i(B)));
+}
+inline uint8x16_t vectorAddSat(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(_mm_adds_epu8(toM128i(A), toM128i(B)));
+}
+inline int16x8_t vectorAddSat(int16x8_t A, int16x8_t B) noexcept {
+  return reinterpret_cast<int16x8_t>(_mm_adds_epi16(toM128i(A), toM128i(B)));
+}
+inline uint16x8_t vectorAddSat(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(_mm_adds_epu16(toM128i(A), toM128i(B)));
+}
+
+inline int8x16_t vectorSubSat(int8x16_t A, int8x16_t B) noexcept {
+  return reinterpret_cast<int8x16_t>(_mm_subs_epi8(toM128i(A), toM128i(B)));
+}
+inline uint8x16_t vectorSubSat(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(_mm_subs_epu8(toM128i(A), toM128i(B)));
+}
+inline int16x8_t vectorSubSat(int16x8_t A, int16x8_t B) noexcept {
+  return reinterpret_cast<int16x8_t>(_mm_subs_epi16(toM128i(A), toM128i(B)));
+}
+inline uint16x8_t vectorSubSat(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(_mm_subs_epu16(toM128i(A), toM128i(B)));
+}
+
+inline uint8x16_t vectorAvgr(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(_mm_avg_epu8(toM128i(A), toM128i(B)));
+}
+inline uint16x8_t vectorAvgr(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(_mm_avg_epu16(toM128i(A), toM128i(B)));
+}
+
+inline int32x4_t vectorDot(int16x8_t A, int16x8_t B) noexcept {
+  return reinterpret_cast<int32x4_t>(_mm_madd_epi16(toM128i(A), toM128i(B)));
+}
+
+[[gnu::target("sse4.1")]] inline __m128i packusEpi32(__m128i A,
+                                                     __m128i B) noexcept {
+  return _mm_packus_epi32(A, B);
+}
+
+/// Narrow the lanes of A and B with saturation to the lanes of TOut.
+template <typename TOut, typename VIn, typename VOut>
+inline bool vectorNarrow(VIn A, VIn B, VOut &Result) noexcept {
+  const __m128i MA = toM128i(A);
+  const __m128i MB = toM128i(B);
+  if constexpr (std::is_same_v<TOut, int8_t>) {
+    Result = reinterpret_cast<VOut>(_mm_packs_epi16(MA, MB));
+  } else if constexpr (std::is_same_v<TOut, uint8_t>) {
+    Result = reinterpret_cast<VOut>(_mm_packus_epi16(MA, MB));
+  } else if constexpr (std::is_same_v<TOut, int16_t>) {
+    Result = reinterpret_cast<VOut>(_mm_packs_epi32(MA, MB));
+  } else {
+    static_assert(std::is_same_v<TOut, uint16_t>);
+    if (!HasSSE4_1) {
+      return false;
+    }
+    Result = reinterpret_cast<VOut>(packusEpi32(MA, MB));
+  }
+  return true;
+}
+
+// The minps and maxps instructions return the second operand if any operand
+// is NaN, and do not order the zeros. Compute in both orders, merge the
+// results, and clear the payloads of the NaNs.
+inline floatx4_t vectorFMin(floatx4_t A, floatx4_t B) noexcept {
+  const __m128 L = _mm_min_ps(A, B);
+  const __m128 M = _mm_or_ps(_mm_min_ps(B, A), L);
+  const __m128 NaN = _mm_cmpunord_ps(L, M);
+  const __m128 Payload =
+      _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(NaN), 10));
+  return _mm_andnot_ps(Payload, _mm_or_ps(M, NaN));
+}
+inline doublex2_t vectorFMin(doublex2_t A, doublex2_t B) noexcept {
+  const __m128d L = _mm_min_pd(A, B);
+  const __m128d M = _mm_or_pd(_mm_min_pd(B, A), L);
+  const __m128d NaN = _mm_cmpunord_pd(L, M);
+  const __m128d Payload =
+      _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(NaN), 13));
+  return _mm_andnot_pd(Payload, _mm_or_pd(M, NaN));
+}
+inline floatx4_t vectorFMax(floatx4_t A, floatx4_t B) noexcept {
+  const __m128 R = _mm_max_ps(B, A);
+  // The orders differ only for the NaNs and the zeros of different signs.
+  const __m128 Diff = _mm_xor_ps(_mm_max_ps(A, B), R);
+  const __m128 M = _mm_sub_ps(_mm_or_ps(R, Diff), Diff);
+  const __m128 NaN = _mm_cmpunord_ps(Diff, M);
+  const __m128 Payload =
+      _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(NaN), 10));
+  return _mm_andnot_ps(Payload, M);
+}
+inline doublex2_t vectorFMax(doublex2_t A, doublex2_t B) noexcept {
+  const __m128d R = _mm_max_pd(B, A);
+  const __m128d Diff = _mm_xor_pd(_mm_max_pd(A, B), R);
+  const __m128d M = _mm_sub_pd(_mm_or_pd(R, Diff), Diff);
+  const __m128d NaN = _mm_cmpunord_pd(Diff, M);
+  const __m128d Payload =
+      _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(NaN), 13));
+  return _mm_andnot_pd(Payload, M);
+}
+
+[[gnu::target("ssse3")]] inline __m128i swizzleSSSE3(__m128i V,
+                                                     __m128i Index) noexcept {
+  // Set the highest bit of the indexes out of range to select zeros.
+  return _mm_shuffle_epi8(V, _mm_adds_epu8(Index, _mm_set1_epi8(0x70)));
+}
+inline bool vectorSwizzle(uint8x16_t &V, uint8x16_t Index) noexcept {
+  if (!HasSSSE3) {
+    return false;
+  }
+  V = reinterpret_cast<uint8x16_t>(swizzleSSSE3(toM128i(V), toM128i(Index)));
+  return true;
+}
+
+[[gnu::target("ssse3")]] inline __m128i
+shuffleSSSE3(__m128i A, __m128i B, __m128i Index) noexcept {
+  // The indexes are validated to be less than 32.
+  const __m128i IndexA =
+      _mm_or_si128(Index, _mm_cmpgt_epi8(Index, _mm_set1_epi8(15)));
+  const __m128i IndexB = _mm_sub_epi8(Index, _mm_set1_epi8(16));
+  return _mm_or_si128(_mm_shuffle_epi8(A, IndexA),
+                      _mm_shuffle_epi8(B, IndexB));
+}
+inline bool vectorShuffle(uint8x16_t &A, uint8x16_t B,
+                          uint8x16_t Index) noexcept {
+  if (!HasSSSE3) {
+    return false;
+  }
+  A = reinterpret_cast<uint8x16_t>(
+      shuffleSSSE3(toM128i(A), toM128i(B), toM128i(Index)));
+  return true;
+}
+
+[[gnu::target("ssse3")]] inline __m128i q15MulrSatSSSE3(__m128i A,
+                                                        __m128i B) noexcept {
+  // Only 0x8000 * 0x8000 overflows to 0x8000, which saturates to 0x7fff.
+  const __m128i R = _mm_mulhrs_epi16(A, B);
+  return _mm_xor_si128(R, _mm_cmpeq_epi16(R, _mm_set1_epi16(-0x8000)));
+}
+inline bool vectorQ15MulrSat(int16x8_t &A, int16x8_t B) noexcept {
+  if (!HasSSSE3) {
+    return false;
+  }
+  A = reinterpret_cast<int16x8_t>(q15MulrSatSSSE3(toM128i(A), toM128i(B)));
+  return true;
+}
+
+#elif defined(__aarch64__)
+
+inline int8x16_t vectorAddSat(int8x16_t A, int8x16_t B) noexcept {
+  return reinterpret_cast<int8x16_t>(
+      vqaddq_s8(reinterpret_cast<::int8x16_t>(A),
+                reinterpret_cast<::int8x16_t>(B)));
+}
+inline uint8x16_t vectorAddSat(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(
+      vqaddq_u8(reinterpret_cast<::uint8x16_t>(A),
+                reinterpret_cast<::uint8x16_t>(B)));
+}
+inline int16x8_t vectorAddSat(int16x8_t A, int16x8_t B) noexcept {
+  return reinterpret_cast<int16x8_t>(
+      vqaddq_s16(reinterpret_cast<::int16x8_t>(A),
+                 reinterpret_cast<::int16x8_t>(B)));
+}
+inline uint16x8_t vectorAddSat(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(
+      vqaddq_u16(reinterpret_cast<::uint16x8_t>(A),
+                 reinterpret_cast<::uint16x8_t>(B)));
+}
+
+inline int8x16_t vectorSubSat(int8x16_t A, int8x16_t B) noexcept {
+  return reinterpret_cast<int8x16_t>(
+      vqsubq_s8(reinterpret_cast<::int8x16_t>(A),
+                reinterpret_cast<::int8x16_t>(B)));
+}
+inline uint8x16_t vectorSubSat(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(
+      vqsubq_u8(reinterpret_cast<::uint8x16_t>(A),
+                reinterpret_cast<::uint8x16_t>(B)));
+}
+inline int16x8_t vectorSubSat(int16x8_t A, int16x8_t B) noexcept {
+  return reinterpret_cast<int16x8_t>(
+      vqsubq_s16(reinterpret_cast<::int16x8_t>(A),
+                 reinterpret_cast<::int16x8_t>(B)));
+}
+inline uint16x8_t vectorSubSat(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(
+      vqsubq_u16(reinterpret_cast<::uint16x8_t>(A),
+                 reinterpret_cast<::uint16x8_t>(B)));
+}
+
+inline uint8x16_t vectorAvgr(uint8x16_t A, uint8x16_t B) noexcept {
+  return reinterpret_cast<uint8x16_t>(
+      vrhaddq_u8(reinterpret_cast<::uint8x16_t>(A),
+                 reinterpret_cast<::uint8x16_t>(B)));
+}
+inline uint16x8_t vectorAvgr(uint16x8_t A, uint16x8_t B) noexcept {
+  return reinterpret_cast<uint16x8_t>(
+      vrhaddq_u16(reinterpret_cast<::uint16x8_t>(A),
+                  reinterpret_cast<::uint16x8_t>(B)));
+}
+
+inline int32x4_t vectorDot(int16x8_t A, int16x8_t B) noexcept {
+  const auto NA = reinterpret_cast<::int16x8_t>(A);
+  const auto NB = reinterpret_cast<::int16x8_t>(B);
+  const ::int32x4_t L = vmull_s16(vget_low_s16(NA), vget_low_s16(NB));
+  const ::int32x4_t H = vmull_high_s16(NA, NB);
+  return reinterpret_cast<int32x4_t>(vpaddq_s32(L, H));
+}
+
+/// Narrow the lanes of A and B with saturation to the lanes of TOut.
+template <typename TOut, typename VIn, typename VOut>
+inline bool vectorNarrow(VIn A, VIn B, VOut &Result) noexcept {
+  if constexpr (std::is_same_v<TOut, int8_t>) {
+    const auto NA = reinterpret_cast<::int16x8_t>(A);
+    const auto NB = reinterpret_cast<::int16x8_t>(B);
+    Result = reinterpret_cast<VOut>(vqmovn_high_s16(vqmovn_s16(NA), NB));
+  } else if constexpr (std::is_same_v<TOut, uint8_t>) {
+    const auto NA = reinterpret_cast<::int16x8_t>(A);
+    const auto NB = reinterpret_cast<::int16x8_t>(B);
+    Result = reinterpret_cast<VOut>(vqmovun_high_s16(vqmovun_s16(NA), NB));
+  } else if constexpr (std::is_same_v<TOut, int16_t>) {
+    const auto NA = reinterpret_cast<::int32x4_t>(A);
+    const auto NB = reinterpret_cast<::int32x4_t>(B);
+    Result = reinterpret_cast<VOut>(vqmovn_high_s32(vqmovn_s32(NA), NB));
+  } else {
+    static_assert(std::is_same_v<TOut, uint16_t>);
+    const auto NA = reinterpret_cast<::int32x4_t>(A);
+    const auto NB = reinterpret_cast<::int32x4_t>(B);
+    Result = reinterpret_cast<VOut>(vqmovun_high_s32(vqmovun_s32(NA), NB));
+  }
+  return true;
+}
+
+// The NEON minimum and maximum propagate NaNs and order the zeros.
+inline floatx4_t vectorFMin(floatx4_t A, floatx4_t B) noexcept {
+  return reinterpret_cast<floatx4_t>(
+      vminq_f32(reinterpret_cast<::float32x4_t>(A),
+                reinterpret_cast<::float32x4_t>(B)));
+}
+inline doublex2_t vectorFMin(doublex2_t A, doublex2_t B) noexcept {
+  return reinterpret_cast<doublex2_t>(
+      vminq_f64(reinterpret_cast<::float64x2_t>(A),
+                reinterpret_cast<::float64x2_t>(B)));
+}
+inline floatx4_t vectorFMax(floatx4_t A, floatx4_t B) noexcept {
+  return reinterpret_cast<floatx4_t>(
+      vmaxq_f32(reinterpret_cast<::float32x4_t>(A),
+                reinterpret_cast<::float32x4_t>(B)));
+}
+inline doublex2_t vectorFMax(doublex2_t A, doublex2_t B) noexcept {
+  return reinterpret_cast<doublex2_t>(
+      vmaxq_f64(reinterpret_cast<::float64x2_t>(A),
+                reinterpret_cast<::float64x2_t>(B)));
+}
+
+inline bool vectorSwizzle(uint8x16_t &V, uint8x16_t Index) noexcept {
+  // The table lookup selects zeros for the indexes out of range.
+  V = reinterpret_cast<uint8x16_t>(
+      vqtbl1q_u8(reinterpret_cast<::uint8x16_t>(V),
+                 reinterpret_cast<::uint8x16_t>(Index)));
+  return true;
+}
+
+inline bool vectorShuffle(uint8x16_t &A, uint8x16_t B,
+                          uint8x16_t Index) noexcept {
+  const ::uint8x16x2_t Table = {{reinterpret_cast<::uint8x16_t>(A),
+                                 reinterpret_cast<::uint8x16_t>(B)}};
+  A = reinterpret_cast<uint8x16_t>(
+      vqtbl2q_u8(Table, reinterpret_cast<::uint8x16_t>(Index)));
+  return true;
+}
+
+inline bool vectorQ15MulrSat(int16x8_t &A, int16x8_t B) noexcept {
+  A = reinterpret_cast<int16x8_t>(
+      vqrdmulhq_s16(reinterpret_cast<::int16x8_t>(A),
+                    reinterpret_cast<::int16x8_t>(B)));
+  return true;
+}
+
+#endif
+#endif
+
 } // namespace detail
 } // namespace Executor
 } // namespace WasmEdge
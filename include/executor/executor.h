@@ -19,12 +19,15 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 #include "common/statistics.h"
+#include "executor/profiler.h"
 #include "runtime/callingframe.h"
 #include "runtime/instance/module.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <csignal>
 #include <cstdint>
@@ -92,7 +95,6 @@ class Executor {
 public:
   Executor(const Configure &Conf, Statistics::Statistics *S = nullptr) noexcept
       : Conf(Conf) {
-    assuming(This == nullptr);
     if (Conf.getStatisticsConfigure().isInstructionCounting() ||
         Conf.getStatisticsConfigure().isCostMeasuring() ||
         Conf.getStatisticsConfigure().isTimeMeasuring()) {
@@ -111,6 +113,7 @@ public:
     ExecutionContext.InstrCount = nullptr;
     ExecutionContext.CostTable = nullptr;
     ExecutionContext.Gas = nullptr;
+    ExecutionContext.OpCodeCounts = nullptr;
   }
 
   /// Instantiate a WASM Module into an anonymous module instance.
@@ -131,6 +134,26 @@ public:
   invoke(const Runtime::Instance::FunctionInstance &FuncInst,
          Span<const ValVariant> Params, Span<const ValType> ParamTypes);
 
+  /// Invoke a WASM function by function instance, with the parameters already
+  /// checked against the function type. The return values are written into
+  /// \p Returns, which must hold at least the return count of the function.
+  /// Nothing is allocated on this path.
+  Expect<void>
+  invokeUnchecked(const Runtime::Instance::FunctionInstance &FuncInst,
+                  Span<const ValVariant> Params, Span<ValVariant> Returns);
+
+  /// Invoke a WASM function for a batch of \p Count calls. \p Params holds
+  /// the parameters of the calls one after another, and the return values are
+  /// written into \p Returns in the same layout. The parameter types are not
+  /// checked. Without \p Errors, the batch stops at the first failed call and
+  /// returns its error. Otherwise, the result of every call is recorded into
+  /// \p Errors and the batch goes on, unless the execution is terminated or
+  /// interrupted. The calls not run then get the same error.
+  Expect<void> invokeBatch(const Runtime::Instance::FunctionInstance &FuncInst,
+                           uint32_t Count, Span<const ValVariant> Params,
+                           Span<ValVariant> Returns,
+                           Span<ErrCode> Errors = {});
+
   /// Register new thread
   void newThread() noexcept {
     This = this;
@@ -143,6 +166,16 @@ public:
     }
   }
 
+  /// Setter of the sampling profiler. The profiler must outlive the
+  /// executions.
+  void setProfiler(Profiler *P) noexcept { Prof = P; }
+
+  /// Getter of the native entries of the imported host functions, which the
+  /// compiled code of the module calls directly. Null if the host calls are
+  /// timed, which needs the full path.
+  const Runtime::Instance::ModuleInstance::HostNative *getHostNatives(
+      const Runtime::Instance::ModuleInstance &ModInst) const noexcept;
+
   /// Stop execution
   void stop() noexcept {
     StopToken.store(1, std::memory_order_relaxed);
@@ -159,6 +192,18 @@ private:
                            const Runtime::Instance::FunctionInstance &Func,
                            Span<const ValVariant> Params);
 
+  /// Run Wasm function for a batch of parameters. See invokeBatch().
+  Expect<void> runFunctionBatch(Runtime::StackManager &StackMgr,
+                                const Runtime::Instance::FunctionInstance &Func,
+                                uint32_t Count, Span<const ValVariant> Params,
+                                Span<ValVariant> Returns,
+                                Span<ErrCode> Errors);
+
+  /// Push the parameters, and enter and execute the function.
+  Expect<void> enterAndExecute(Runtime::StackManager &StackMgr,
+                               const Runtime::Instance::FunctionInstance &Func,
+                               Span<const ValVariant> Params);
+
   /// Execute instructions.
   Expect<void> execute(Runtime::StackManager &StackMgr,
                        const AST::InstrView::iterator Start,
@@ -225,6 +270,10 @@ private:
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator RetIt, bool IsTailCall = false);
 
+  /// Helper function for suspending the running fiber on a pending host
+  /// function until the event loop resumes it.
+  Expect<void> suspendHostFunction() noexcept;
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StackManager &StackMgr,
                              uint32_t EraseBegin, uint32_t EraseEnd,
@@ -622,6 +671,9 @@ public:
   Expect<void *> ptrFunc(Runtime::StackManager &StackMgr,
                          const uint32_t TableIdx, const uint32_t FuncTypeIdx,
                          const uint32_t FuncIdx) noexcept;
+  Expect<void> profileBlock(Runtime::StackManager &StackMgr,
+                            const uint32_t FuncIdx, const uint32_t Offset,
+                            const uint32_t Instrs) noexcept;
   Expect<uint32_t> memoryAtomicNotify(Runtime::StackManager &StackMgr,
                                       const uint32_t MemIdx,
                                       const uint32_t Offset,
@@ -645,14 +697,79 @@ private:
                               int64_t Timeout) noexcept;
   void atomicNotifyAll() noexcept;
 
+  using WaitTimePoint = std::chrono::steady_clock::time_point;
+
+  /// Parked thread of `memory.atomic.wait`. Lives on the waiting thread's
+  /// stack and is linked into the bucket of its (memory, address) pair.
   struct Waiter {
+    Runtime::Instance::MemoryInstance *MemInst;
+    uint32_t Address;
+    /// Set to 1 by the notifier after unlinking this waiter from its bucket.
+    /// On Linux this word is also the futex the waiter sleeps on.
+    std::atomic_uint32_t Notified = 0;
+    Waiter *Prev = nullptr;
+    Waiter *Next = nullptr;
+#if !WASMEDGE_OS_LINUX
     std::mutex Mutex;
     std::condition_variable Cond;
-    Runtime::Instance::MemoryInstance *MemInst;
-    Waiter(Runtime::Instance::MemoryInstance *Inst) noexcept : MemInst(Inst) {}
+#endif
+    Waiter(Runtime::Instance::MemoryInstance *Inst, uint32_t Addr) noexcept
+        : MemInst(Inst), Address(Addr) {}
+  };
+
+  /// One shard of the parking lot: a FIFO queue of waiters guarded by its own
+  /// lock. Aligned to a cache line to avoid false sharing between shards.
+  struct alignas(64) WaiterBucket {
+    std::mutex Mutex;
+    Waiter *Head = nullptr;
+    Waiter *Tail = nullptr;
+
+    void push(Waiter &W) noexcept {
+      W.Prev = Tail;
+      W.Next = nullptr;
+      if (Tail) {
+        Tail->Next = &W;
+      } else {
+        Head = &W;
+      }
+      Tail = &W;
+    }
+    void erase(Waiter &W) noexcept {
+      if (W.Prev) {
+        W.Prev->Next = W.Next;
+      } else {
+        Head = W.Next;
+      }
+      if (W.Next) {
+        W.Next->Prev = W.Prev;
+      } else {
+        Tail = W.Prev;
+      }
+      W.Prev = W.Next = nullptr;
+    }
   };
-  std::mutex WaiterMapMutex;
-  std::unordered_multimap<uint32_t, Waiter> WaiterMap;
+
+  /// Get the bucket of the parking lot for the (memory, address) pair.
+  WaiterBucket &
+  getWaiterBucket(const Runtime::Instance::MemoryInstance *MemInst,
+                  uint32_t Address) noexcept;
+
+  /// Block the current thread until the waiter is notified, the deadline
+  /// passed, or a spurious wakeup occurred. Callers must re-check the state.
+  static void parkWaiter(Waiter &W,
+                         const std::optional<WaitTimePoint> &Until) noexcept;
+
+  /// Mark the waiter as notified and wake it. The waiter must already be
+  /// unlinked, and the lock of its bucket must be held.
+  static void unparkWaiter(Waiter &W) noexcept;
+
+  /// Wait on a queued waiter until notified, timed out or interrupted.
+  Expect<uint32_t>
+  waitNotified(WaiterBucket &Bucket, Waiter &W,
+               const std::optional<WaitTimePoint> &Until) noexcept;
+
+  static inline constexpr size_t WaiterBucketCount = 256;
+  std::array<WaiterBucket, WaiterBucketCount> WaiterBuckets;
 
 private:
   /// Execution context for compiled functions
@@ -664,6 +781,8 @@ private:
     std::atomic_uint64_t *Gas;
     uint64_t GasLimit;
     std::atomic_uint32_t *StopToken;
+    std::atomic_uint64_t *OpCodeCounts;
+    const Runtime::Instance::ModuleInstance::HostNative *HostNatives;
   };
 
   /// Pointer to current object.
@@ -679,6 +798,8 @@ private:
   const Configure Conf;
   /// Executor statistics
   Statistics::Statistics *Stat;
+  /// Sampling profiler
+  Profiler *Prof = nullptr;
   /// Stop Execution
   std::atomic_uint32_t StopToken = 0;
 };
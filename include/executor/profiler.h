@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/executor/profiler.h - Sampling profiler definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the sampling profiler of wasm call stacks.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/enum_ast.hpp"
+#include "common/pgo.h"
+#include "runtime/instance/function.h"
+#include "runtime/instance/module.h"
+#include "runtime/stackmgr.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+/// Sampling profiler with per wasm function attribution.
+///
+/// Executors attach the stack managers they run on. A sampler thread wakes up
+/// every interval, copies the shadow function stacks of the attached stack
+/// managers and counts every distinct call stack. The samples are taken in
+/// wall-clock time, so time blocked in host functions is attributed too.
+///
+/// With the instrumentation turned on, the interpreter also counts every
+/// executed opcode, every executed basic block, the function calls and the
+/// targets taken at the conditional branches. The AOT code compiled with the
+/// instrumentation counts the opcodes and the basic blocks.
+class Profiler {
+public:
+  using FuncStack = std::vector<const Runtime::Instance::FunctionInstance *>;
+
+  /// Basic block key: the function and the wasm byte offset of the first
+  /// instruction of the block.
+  using BlockKey =
+      std::pair<const Runtime::Instance::FunctionInstance *, uint32_t>;
+  struct BlockCount {
+    /// Times the block was entered.
+    uint64_t Count = 0;
+    /// Instructions executed in the block.
+    uint64_t Instrs = 0;
+  };
+
+  explicit Profiler(std::chrono::microseconds Interval =
+                        std::chrono::microseconds(1000)) noexcept
+      : Interval(Interval), Id(newId()) {}
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+  ~Profiler() noexcept { stop(); }
+
+  /// Start and stop the sampler thread.
+  void start();
+  void stop() noexcept;
+
+  /// Attach and detach a running stack manager.
+  void attach(const Runtime::StackManager &StackMgr);
+  void detach(const Runtime::StackManager &StackMgr) noexcept;
+
+  /// Register the function names in the name section of the module. Functions
+  /// without a name fall back to their export name or their index.
+  void addNameSection(const Runtime::Instance::ModuleInstance &ModInst,
+                      const AST::Module &Mod);
+
+  /// Getter of the count of non-empty samples.
+  uint64_t getSampleCount() const noexcept;
+
+  /// Getter of the sample count of every distinct call stack, outermost
+  /// function first.
+  std::map<FuncStack, uint64_t> getSamples() const;
+
+  /// Write the samples in the folded stack format of flamegraph.pl, one
+  /// `outer;inner count` line per call stack. The function instances must
+  /// still be alive.
+  void dumpFolded(std::ostream &OS) const;
+
+  /// Get the symbol of a function as `module::name`.
+  std::string symbolize(const Runtime::Instance::FunctionInstance &Func) const;
+
+  /// \name Instrumentation of the interpreter.
+  /// @{
+  /// Turn on the instrumentation. Should be set before the executions start.
+  void setInstrumentation(bool Enable);
+  bool isInstrumenting() const noexcept { return Instrumenting; }
+
+  /// Count an executed opcode.
+  void addOpCode(OpCode Code) noexcept {
+    (*OpCodeCounts)[static_cast<uint16_t>(Code)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  /// Getter of the opcode counters indexed by the opcodes, which the
+  /// instrumented AOT code adds to. Null without the instrumentation.
+  std::atomic_uint64_t *getOpCodeCounters() noexcept {
+    return Instrumenting ? OpCodeCounts->data() : nullptr;
+  }
+
+  /// Count an executed basic block of \p Instrs instructions. The counters of
+  /// the blocks, the calls and the branches are kept per thread, and merged
+  /// when they are read.
+  void addBlock(const Runtime::Instance::FunctionInstance &Func,
+                uint32_t Offset, uint32_t Instrs);
+
+  /// Count a call of an interpreted function.
+  void addCall(const Runtime::Instance::FunctionInstance &Func);
+
+  /// Count the target \p Target out of \p Targets taken at the branch at
+  /// \p Offset.
+  void addBranch(const Runtime::Instance::FunctionInstance &Func,
+                 uint32_t Offset, uint32_t Target, uint32_t Targets);
+
+  /// Getter of the execution count of an opcode.
+  uint64_t getOpCodeCount(OpCode Code) const noexcept;
+
+  /// Getter of the counts of the executed basic blocks.
+  std::map<BlockKey, BlockCount> getBlocks() const;
+
+  /// Write the opcode, function and basic block counts, ordered by the most
+  /// executed first.
+  void dumpInstrJSON(std::ostream &OS) const;
+  void dumpInstrCSV(std::ostream &OS) const;
+
+  /// Getter of the function call and branch counts as the workload profile
+  /// of the AOT compiler.
+  PGO::Profile getPGOProfile() const;
+  /// @}
+
+private:
+  struct BlockKeyHash {
+    size_t operator()(const BlockKey &Key) const noexcept {
+      return std::hash<const void *>()(Key.first) ^
+             (static_cast<size_t>(Key.second) * UINT64_C(0x9E3779B97F4A7C15));
+    }
+  };
+  /// Counters of one thread. The lock is only contended by the readers.
+  struct Shard {
+    std::mutex Mutex;
+    std::unordered_map<BlockKey, BlockCount, BlockKeyHash> Blocks;
+    std::unordered_map<const Runtime::Instance::FunctionInstance *, uint64_t>
+        Calls;
+    std::unordered_map<BlockKey, std::vector<uint64_t>, BlockKeyHash>
+        Branches;
+  };
+
+  static uint64_t newId() noexcept;
+  /// Get the counters of the calling thread.
+  Shard &getShard();
+  /// Call \p Func with every locked shard.
+  template <typename FuncT> void forEachShard(FuncT &&Func) const;
+
+  void run() noexcept;
+
+  /// Counts of the functions, summed up from the basic blocks.
+  std::vector<std::pair<const Runtime::Instance::FunctionInstance *,
+                        BlockCount>>
+  getFunctionCounts(const std::map<BlockKey, BlockCount> &AllBlocks) const;
+  /// Counts of the executed opcodes, the most executed first.
+  std::vector<std::pair<OpCode, uint64_t>> getOpCodeCounts() const;
+  /// Basic blocks ordered by the most executed instructions first.
+  static std::vector<std::pair<BlockKey, BlockCount>>
+  getSortedBlocks(const std::map<BlockKey, BlockCount> &AllBlocks);
+
+  const std::chrono::microseconds Interval;
+  /// Unique identifier of the profiler, for the per thread caches.
+  const uint64_t Id;
+  mutable std::mutex Mutex;
+  std::condition_variable StopCond;
+  std::thread Sampler;
+  bool Stopping = false;
+  std::vector<const Runtime::StackManager *> Stacks;
+  std::map<FuncStack, uint64_t> Samples;
+  uint64_t SampleCount = 0;
+  std::unordered_map<const Runtime::Instance::ModuleInstance *,
+                     std::unordered_map<uint32_t, std::string>>
+      Names;
+
+  bool Instrumenting = false;
+  std::unique_ptr<std::array<std::atomic_uint64_t, UINT16_MAX + 1>>
+      OpCodeCounts;
+  std::unordered_map<std::thread::id, std::unique_ptr<Shard>> Shards;
+};
+
+} // namespace Executor
+} // namespace WasmEdge
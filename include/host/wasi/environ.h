@@ -971,6 +971,20 @@ public:
     }
   }
 
+  /// Prepare to suspend the running fiber on a socket operation.
+  ///
+  /// @param[in] Write Wait for sending instead of receiving.
+  /// @return Nothing, or __WASI_ERRNO_AGAIN if the operation would block.
+  WasiExpect<void> sockSuspendIfBusy(__wasi_fd_t Fd,
+                                     bool Write) const noexcept {
+    auto Node = getNodeOrNull(Fd);
+    if (unlikely(!Node)) {
+      return WasiUnexpect(__WASI_ERRNO_BADF);
+    } else {
+      return Node->sockSuspendIfBusy(Write);
+    }
+  }
+
   /// Send a message on a socket.
   ///
   /// Note: This is similar to `sendto` in POSIX, though it also supports
@@ -553,6 +553,15 @@ public:
                                 uint8_t AddressLength, __wasi_size_t &NRead,
                                 __wasi_roflags_t &RoFlags) const noexcept;
 
+  /// Prepare to suspend the running fiber on a socket operation.
+  ///
+  /// If the current thread runs on a fiber and the blocking socket is not
+  /// ready, record the socket as the wait condition of the fiber.
+  ///
+  /// @param[in] Write Wait for sending instead of receiving.
+  /// @return Nothing, or __WASI_ERRNO_AGAIN if the operation would block.
+  WasiExpect<void> sockSuspendIfBusy(bool Write) const noexcept;
+
   /// Send a message on a socket.
   ///
   /// Note: This is similar to `send` in POSIX, though it also supports writing
@@ -622,6 +622,14 @@ public:
     return Node.sockSend(SiData, SiFlags, NWritten);
   }
 
+  /// Prepare to suspend the running fiber on a socket operation.
+  ///
+  /// @param[in] Write Wait for sending instead of receiving.
+  /// @return Nothing, or __WASI_ERRNO_AGAIN if the operation would block.
+  WasiExpect<void> sockSuspendIfBusy(bool Write) const noexcept {
+    return Node.sockSuspendIfBusy(Write);
+  }
+
   /// Send a message on a socket.
   ///
   /// Note: This is similar to `send` in POSIX, though it also supports writing
@@ -54,7 +54,9 @@ public:
 
 class WasiClockTimeGet : public Wasi<WasiClockTimeGet> {
 public:
-  WasiClockTimeGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  WasiClockTimeGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {
+    enableNativeEntry();
+  }
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t ClockId,
                         uint64_t Precision, uint32_t /* Out */ TimePtr);
@@ -224,7 +226,9 @@ public:
 
 class WasiFdWrite : public Wasi<WasiFdWrite> {
 public:
-  WasiFdWrite(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  WasiFdWrite(WASI::Environ &HostEnv) : Wasi(HostEnv) {
+    enableNativeEntry();
+  }
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t IOVSPtr, uint32_t IOVSLen,
@@ -353,7 +357,9 @@ public:
 
 class WasiRandomGet : public Wasi<WasiRandomGet> {
 public:
-  WasiRandomGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  WasiRandomGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {
+    enableNativeEntry();
+  }
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t BufPtr,
                         uint32_t BufLen);
@@ -84,6 +84,12 @@ public:
   /// Get the file header type.
   FileHeader getHeaderType();
 
+  /// Get the descriptor of the mapped file, or -1 if the data is not from a
+  /// file.
+  int getFileDescriptor() const noexcept {
+    return FileMap ? FileMap->descriptor() : -1;
+  }
+
   /// Get current offset.
   uint64_t getOffset() const noexcept { return Pos; }
 
@@ -93,6 +99,11 @@ public:
   /// Get remain size.
   uint64_t getRemainSize() const noexcept { return Size - Pos; }
 
+  /// Get the bytes read from the offset to the current offset.
+  Span<const Byte> getReadBytes(uint64_t Offset) const noexcept {
+    return Span<const Byte>(Data + Offset, static_cast<size_t>(Pos - Offset));
+  }
+
   /// Jump the content with size (size + content).
   Expect<void> jumpContent();
 
@@ -18,10 +18,13 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
+#include "common/span.h"
 #include "common/symbol.h"
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #if WASMEDGE_OS_WINDOWS
@@ -48,7 +51,9 @@ public:
   SharedLibrary() noexcept = default;
   ~SharedLibrary() noexcept { unload(); }
   Expect<void> load(const std::filesystem::path &Path) noexcept;
-  Expect<void> load(const AST::AOTSection &AOTSec) noexcept;
+  /// Load the AOT section. If \p File is the descriptor of the file the
+  /// section is parsed from, the text sections are mapped from it if possible.
+  Expect<void> load(const AST::AOTSection &AOTSec, int File = -1) noexcept;
   void unload() noexcept;
 
   template <typename T> Symbol<T> get(const char *Name) {
@@ -58,6 +63,11 @@ public:
 
   uintptr_t getOffset() const noexcept;
 
+  /// Append the loaded codes to the perf map of this process,
+  /// `/tmp/perf-<pid>.map`, so that `perf report` can symbolize them. The
+  /// symbols are in the order of the codes. Only works on Linux.
+  void writePerfMap(Span<const std::string> Symbols) const noexcept;
+
   template <typename T> T *getPointer(uint64_t Address) const noexcept {
     return reinterpret_cast<T *>(getOffset() + Address);
   }
@@ -100,6 +110,8 @@ private:
   uint64_t IntrinsicsAddress = 0;
   std::vector<uintptr_t> TypesAddress;
   std::vector<uintptr_t> CodesAddress;
+  /// Offsets and sizes of the text sections.
+  std::vector<std::pair<uint64_t, uint64_t>> TextRanges;
 };
 
 } // namespace Loader
@@ -15,8 +15,10 @@
 
 #include "ast/type.h"
 #include "common/errcode.h"
+#include "common/metrics.h"
 #include "common/span.h"
 #include "common/types.h"
+#include "system/fault.h"
 
 #include <memory>
 #include <tuple>
@@ -44,9 +46,25 @@ public:
   /// Getter of host function cost.
   uint64_t getCost() const { return Cost; }
 
+  /// Getter and setter of the call metrics, set when added into a module.
+  const Metrics::HostCallMetrics *getMetrics() const noexcept {
+    return CallMetrics;
+  }
+  void setMetrics(const Metrics::HostCallMetrics *M) noexcept {
+    CallMetrics = M;
+  }
+
+  /// Getter of the raw native entry, or null if not declared. The entry is
+  /// called by the AOT code with the arguments in registers, as
+  /// `R(HostFunctionBase *, const CallingFrame &, Args...)`, and raises the
+  /// errors as faults.
+  void *getNativeEntry() const noexcept { return NativeEntry; }
+
 protected:
   AST::FunctionType FuncType;
   const uint64_t Cost;
+  const Metrics::HostCallMetrics *CallMetrics = nullptr;
+  void *NativeEntry = nullptr;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
@@ -68,6 +86,13 @@ public:
   }
 
 protected:
+  /// Declare the raw native signature of the body, for the direct calls from
+  /// the AOT code. Only for the bodies with number arguments and at most one
+  /// number result, which never return `HostFuncPending`.
+  void enableNativeEntry() noexcept {
+    NativeEntry = reinterpret_cast<void *>(&Native<decltype(&T::body)>::entry);
+  }
+
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(const CallingFrame &CallFrame, SpanA &&Args,
                       SpanR &&Rets) {
@@ -126,6 +151,24 @@ private:
     static inline constexpr const bool hasReturn = false;
   };
 
+  template <typename> struct Native;
+  template <typename R, typename C, typename... A>
+  struct Native<Expect<R> (C::*)(const CallingFrame &, A...)> {
+    static_assert((std::is_arithmetic_v<A> && ...) &&
+                      (std::is_void_v<R> || std::is_arithmetic_v<R>),
+                  "Native entries only take and return numbers.");
+    static R entry(HostFunctionBase *Self, const CallingFrame &CallFrame,
+                   A... Args) {
+      auto Res = static_cast<T *>(Self)->body(CallFrame, Args...);
+      if (unlikely(!Res)) {
+        Fault::emitFault(Res.error());
+      }
+      if constexpr (!std::is_void_v<R>) {
+        return *Res;
+      }
+    }
+  };
+
   template <typename Tuple, typename SpanT, size_t... Indices>
   static Tuple toTuple(SpanT &&Args, std::index_sequence<Indices...>) {
     return Tuple(std::forward<SpanT>(Args)[Indices]
@@ -17,6 +17,7 @@
 #include "common/errcode.h"
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "system/allocator.h"
 
 #include <algorithm>
@@ -56,8 +57,12 @@ public:
       spdlog::error("Unable to find usable memory address");
       return;
     }
+    Metrics::runtime().MemoryPages.add(MemType.getLimit().getMin());
   }
   ~MemoryInstance() noexcept {
+    if (DataPtr != nullptr) {
+      Metrics::runtime().MemoryPages.sub(MemType.getLimit().getMin());
+    }
     Allocator::release(DataPtr, MemType.getLimit().getMin());
   }
 
@@ -113,6 +118,7 @@ public:
       DataPtr = NewPtr;
     }
     MemType.getLimit().setMin(Min + Count);
+    Metrics::runtime().MemoryPages.add(Count);
     return true;
   }
 
@@ -15,6 +15,8 @@
 
 #include "ast/type.h"
 #include "common/errcode.h"
+#include "common/metrics.h"
+#include "common/name_index.h"
 #include "runtime/hostfunc.h"
 #include "runtime/instance/data.h"
 #include "runtime/instance/elem.h"
@@ -24,6 +26,7 @@
 #include "runtime/instance/table.h"
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
@@ -38,6 +41,7 @@ namespace WasmEdge {
 
 namespace Executor {
 class Executor;
+class Profiler;
 }
 
 namespace Runtime {
@@ -65,8 +69,11 @@ inline constexpr const bool IsInstanceV =
 
 class ModuleInstance {
 public:
-  ModuleInstance(std::string_view Name) : ModName(Name) {}
+  ModuleInstance(std::string_view Name) : ModName(Name) {
+    Metrics::runtime().InstancesCreated.add();
+  }
   virtual ~ModuleInstance() noexcept {
+    Metrics::runtime().InstancesDestroyed.add();
     // When destroying this module instance, call the callbacks to unlink to the
     // store managers.
     for (auto &&Pair : LinkedStore) {
@@ -80,11 +87,18 @@ public:
     return ModName;
   }
 
+  /// Getter and setter of the hash of the code of the instantiated module, or
+  /// 0 if not instantiated from a module. See AST::Module::getCodeHash().
+  uint64_t getCodeHash() const noexcept { return CodeHash; }
+  void setCodeHash(uint64_t Hash) noexcept { CodeHash = Hash; }
+
   /// Add exist instances and move ownership with exporting name.
   void addHostFunc(std::string_view Name,
                    std::unique_ptr<HostFunctionBase> &&Func) {
     std::unique_lock Lock(Mutex);
+    Func->setMetrics(&Metrics::hostCall(ModName, Name));
     unsafeAddHostInstance(Name, OwnedFuncInsts, FuncInsts, ExpFuncs,
+                          ExpFuncIndex,
                           std::make_unique<Runtime::Instance::FunctionInstance>(
                               this, std::move(Func)));
   }
@@ -92,44 +106,64 @@ public:
                    std::unique_ptr<Instance::FunctionInstance> &&Func) {
     std::unique_lock Lock(Mutex);
     Func->setModule(this);
+    if (Func->isHostFunction()) {
+      Func->getHostFunc().setMetrics(&Metrics::hostCall(ModName, Name));
+    }
     unsafeAddHostInstance(Name, OwnedFuncInsts, FuncInsts, ExpFuncs,
-                          std::move(Func));
+                          ExpFuncIndex, std::move(Func));
   }
   void addHostTable(std::string_view Name,
                     std::unique_ptr<Instance::TableInstance> &&Tab) {
     std::unique_lock Lock(Mutex);
     unsafeAddHostInstance(Name, OwnedTabInsts, TabInsts, ExpTables,
-                          std::move(Tab));
+                          ExpTableIndex, std::move(Tab));
   }
   void addHostMemory(std::string_view Name,
                      std::unique_ptr<Instance::MemoryInstance> &&Mem) {
     std::unique_lock Lock(Mutex);
-    unsafeAddHostInstance(Name, OwnedMemInsts, MemInsts, ExpMems,
+    unsafeAddHostInstance(Name, OwnedMemInsts, MemInsts, ExpMems, ExpMemIndex,
                           std::move(Mem));
   }
   void addHostGlobal(std::string_view Name,
                      std::unique_ptr<Instance::GlobalInstance> &&Glob) {
     std::unique_lock Lock(Mutex);
     unsafeAddHostInstance(Name, OwnedGlobInsts, GlobInsts, ExpGlobals,
-                          std::move(Glob));
+                          ExpGlobalIndex, std::move(Glob));
   }
 
-  /// Find and get the exported instance by name.
+  /// Find and get the exported instance by name, and optionally the hash of
+  /// the name by hashName().
   FunctionInstance *findFuncExports(std::string_view ExtName) const noexcept {
+    return findFuncExports(ExtName, hashName(ExtName));
+  }
+  FunctionInstance *findFuncExports(std::string_view ExtName,
+                                    uint64_t Hash) const noexcept {
     std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpFuncs, ExtName);
+    return ExpFuncIndex.find(ExtName, Hash);
   }
   TableInstance *findTableExports(std::string_view ExtName) const noexcept {
+    return findTableExports(ExtName, hashName(ExtName));
+  }
+  TableInstance *findTableExports(std::string_view ExtName,
+                                  uint64_t Hash) const noexcept {
     std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpTables, ExtName);
+    return ExpTableIndex.find(ExtName, Hash);
   }
   MemoryInstance *findMemoryExports(std::string_view ExtName) const noexcept {
+    return findMemoryExports(ExtName, hashName(ExtName));
+  }
+  MemoryInstance *findMemoryExports(std::string_view ExtName,
+                                    uint64_t Hash) const noexcept {
     std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpMems, ExtName);
+    return ExpMemIndex.find(ExtName, Hash);
   }
   GlobalInstance *findGlobalExports(std::string_view ExtName) const noexcept {
+    return findGlobalExports(ExtName, hashName(ExtName));
+  }
+  GlobalInstance *findGlobalExports(std::string_view ExtName,
+                                    uint64_t Hash) const noexcept {
     std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpGlobals, ExtName);
+    return ExpGlobalIndex.find(ExtName, Hash);
   }
 
   /// Get the exported instances count.
@@ -172,8 +206,20 @@ public:
     return std::forward<CallbackT>(CallBack)(ExpGlobals);
   }
 
+  /// Native entry of an imported host function for the compiled code.
+  struct HostNative {
+    /// Raw native entry of the host function, or null if the import is called
+    /// through the full path.
+    void *Entry = nullptr;
+    /// The host function passed to the entry.
+    HostFunctionBase *Self = nullptr;
+    /// Storage of the Runtime::CallingFrame passed to the entry.
+    alignas(void *) std::byte Frame[2 * sizeof(void *)] = {};
+  };
+
 private:
   friend class Executor::Executor;
+  friend class Executor::Profiler;
   friend class Runtime::CallingFrame;
 
   /// Copy the function types in type section to this module instance.
@@ -228,22 +274,23 @@ private:
     unsafeImportInstance(GlobInsts, Glob);
   }
 
-  /// Export instances with name from this module instance.
-  void exportFunction(std::string_view Name, uint32_t Idx) {
+  /// Export instances with name and its hash from this module instance.
+  void exportFunction(std::string_view Name, uint64_t Hash, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
-    ExpFuncs.insert_or_assign(std::string(Name), FuncInsts[Idx]);
+    unsafeExportInstance(Name, Hash, ExpFuncs, ExpFuncIndex, FuncInsts[Idx]);
   }
-  void exportTable(std::string_view Name, uint32_t Idx) {
+  void exportTable(std::string_view Name, uint64_t Hash, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
-    ExpTables.insert_or_assign(std::string(Name), TabInsts[Idx]);
+    unsafeExportInstance(Name, Hash, ExpTables, ExpTableIndex, TabInsts[Idx]);
   }
-  void exportMemory(std::string_view Name, uint32_t Idx) {
+  void exportMemory(std::string_view Name, uint64_t Hash, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
-    ExpMems.insert_or_assign(std::string(Name), MemInsts[Idx]);
+    unsafeExportInstance(Name, Hash, ExpMems, ExpMemIndex, MemInsts[Idx]);
   }
-  void exportGlobal(std::string_view Name, uint32_t Idx) {
+  void exportGlobal(std::string_view Name, uint64_t Hash, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
-    ExpGlobals.insert_or_assign(std::string(Name), GlobInsts[Idx]);
+    unsafeExportInstance(Name, Hash, ExpGlobals, ExpGlobalIndex,
+                         GlobInsts[Idx]);
   }
 
   /// Get function type by index.
@@ -373,28 +420,29 @@ private:
                         std::vector<std::unique_ptr<T>> &OwnedInstsVec,
                         std::vector<T *> &InstsVec,
                         std::map<std::string, T *, std::less<>> &InstsMap,
-                        std::unique_ptr<T> &&Inst) {
+                        NameIndex<T> &InstsIndex, std::unique_ptr<T> &&Inst) {
     OwnedInstsVec.push_back(std::move(Inst));
     InstsVec.push_back(OwnedInstsVec.back().get());
-    InstsMap.insert_or_assign(std::string(Name), InstsVec.back());
+    unsafeExportInstance(Name, hashName(Name), InstsMap, InstsIndex,
+                         InstsVec.back());
   }
 
-  /// Unsafe find and get the exported instance by name.
+  /// Unsafe export the instance by name into the map and the index.
   template <typename T>
-  std::enable_if_t<IsEntityV<T>, T *>
-  unsafeFindExports(const std::map<std::string, T *, std::less<>> &Map,
-                    std::string_view ExtName) const noexcept {
-    auto Iter = Map.find(ExtName);
-    if (likely(Iter != Map.cend())) {
-      return Iter->second;
-    }
-    return nullptr;
+  std::enable_if_t<IsEntityV<T>, void>
+  unsafeExportInstance(std::string_view Name, uint64_t Hash,
+                       std::map<std::string, T *, std::less<>> &InstsMap,
+                       NameIndex<T> &InstsIndex, T *Inst) {
+    // The index refers to the name owned by the map node.
+    auto Iter = InstsMap.insert_or_assign(std::string(Name), Inst).first;
+    InstsIndex.insert(Iter->first, Hash, Inst);
   }
 
   /// \name Data for compiled functions.
   /// @{
   std::vector<uint8_t *> MemoryPtrs;
   std::vector<ValVariant *> GlobalPtrs;
+  std::vector<HostNative> HostNatives;
   /// @}
 
   friend class Runtime::StoreManager;
@@ -419,6 +467,9 @@ private:
   /// Module name.
   const std::string ModName;
 
+  /// Hash of the code of the instantiated module.
+  uint64_t CodeHash = 0;
+
   /// Function types.
   std::vector<AST::FunctionType> FuncTypes;
 
@@ -446,6 +497,11 @@ private:
   std::map<std::string, TableInstance *, std::less<>> ExpTables;
   std::map<std::string, MemoryInstance *, std::less<>> ExpMems;
   std::map<std::string, GlobalInstance *, std::less<>> ExpGlobals;
+  /// The hashed indexes of the exported names for the lookups.
+  NameIndex<FunctionInstance> ExpFuncIndex;
+  NameIndex<TableInstance> ExpTableIndex;
+  NameIndex<MemoryInstance> ExpMemIndex;
+  NameIndex<GlobalInstance> ExpGlobalIndex;
 
   /// Start function instance.
   FunctionInstance *StartFunc = nullptr;
@@ -16,6 +16,9 @@
 #include "ast/instruction.h"
 #include "runtime/instance/module.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <vector>
 
 namespace WasmEdge {
@@ -26,9 +29,11 @@ public:
   struct Frame {
     Frame() = delete;
     Frame(const Instance::ModuleInstance *Mod, AST::InstrView::iterator FromIt,
-          uint32_t L, uint32_t A, uint32_t V) noexcept
-        : Module(Mod), From(FromIt), Locals(L), Arity(A), VPos(V) {}
+          uint32_t L, uint32_t A, uint32_t V,
+          const Instance::FunctionInstance *F) noexcept
+        : Module(Mod), Func(F), From(FromIt), Locals(L), Arity(A), VPos(V) {}
     const Instance::ModuleInstance *Module;
+    const Instance::FunctionInstance *Func;
     AST::InstrView::iterator From;
     uint32_t Locals;
     uint32_t Arity;
@@ -68,6 +73,12 @@ public:
     ValueStack.push_back(std::forward<T>(Val));
   }
 
+  /// Push N zero value entries and return the span of them.
+  Span<Value> pushSpan(uint32_t N) {
+    ValueStack.resize(ValueStack.size() + N);
+    return getTopSpan(N);
+  }
+
   /// Unsafe Pop and return the top entry.
   Value pop() {
     Value V = std::move(ValueStack.back());
@@ -78,10 +89,22 @@ public:
   /// Push a new frame entry to stack.
   void pushFrame(const Instance::ModuleInstance *Module,
                  AST::InstrView::iterator From, uint32_t LocalNum = 0,
-                 uint32_t Arity = 0, bool IsTailCall = false) noexcept {
+                 uint32_t Arity = 0, bool IsTailCall = false,
+                 const Instance::FunctionInstance *Func = nullptr) noexcept {
     if (likely(!IsTailCall)) {
-      FrameStack.emplace_back(Module, From, LocalNum, Arity, ValueStack.size());
+      const auto Depth = static_cast<uint32_t>(FrameStack.size());
+      if (likely(Depth < kShadowDepth)) {
+        Shadow[Depth].store(Func, std::memory_order_relaxed);
+      }
+      FrameStack.emplace_back(Module, From, LocalNum, Arity, ValueStack.size(),
+                              Func);
+      ShadowSize.store(std::min(Depth + 1, kShadowDepth),
+                       std::memory_order_release);
     } else {
+      if (const auto Depth = static_cast<uint32_t>(FrameStack.size());
+          likely(Depth <= kShadowDepth)) {
+        Shadow[Depth - 1].store(Func, std::memory_order_release);
+      }
       assuming(!FrameStack.empty());
       assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
       assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
@@ -90,6 +113,7 @@ public:
                            FrameStack.back().Locals,
                        ValueStack.end() - LocalNum);
       FrameStack.back().Module = Module;
+      FrameStack.back().Func = Func;
       FrameStack.back().Locals = LocalNum;
       FrameStack.back().Arity = Arity;
       FrameStack.back().VPos = static_cast<uint32_t>(ValueStack.size());
@@ -107,6 +131,9 @@ public:
                      ValueStack.end() - FrameStack.back().Arity);
     auto From = FrameStack.back().From;
     FrameStack.pop_back();
+    ShadowSize.store(
+        std::min(static_cast<uint32_t>(FrameStack.size()), kShadowDepth),
+        std::memory_order_release);
     return From;
   }
 
@@ -132,10 +159,31 @@ public:
     return FrameStack.back().Module;
   }
 
+  /// Getter of the function of the top frame. Returns nullptr for the frames
+  /// without function.
+  const Instance::FunctionInstance *getFunction() const noexcept {
+    return FrameStack.empty() ? nullptr : FrameStack.back().Func;
+  }
+
   /// Reset stack.
   void reset() noexcept {
     ValueStack.clear();
     FrameStack.clear();
+    ShadowSize.store(0, std::memory_order_release);
+  }
+
+  /// Copy the functions of the frames, outermost first. Frames without
+  /// function and frames deeper than the shadow depth are skipped. This can
+  /// be called from other threads while the stack is running.
+  void getShadowStack(
+      std::vector<const Instance::FunctionInstance *> &Funcs) const {
+    Funcs.clear();
+    const uint32_t Size = ShadowSize.load(std::memory_order_acquire);
+    for (uint32_t I = 0; I < Size; ++I) {
+      if (const auto *Func = Shadow[I].load(std::memory_order_relaxed)) {
+        Funcs.push_back(Func);
+      }
+    }
   }
 
 private:
@@ -144,6 +192,14 @@ private:
   std::vector<Value> ValueStack;
   std::vector<Frame> FrameStack;
   /// @}
+
+  /// \name Shadow function stack for the sampling profiler.
+  /// @{
+  static inline constexpr uint32_t kShadowDepth = 128;
+  std::array<std::atomic<const Instance::FunctionInstance *>, kShadowDepth>
+      Shadow = {};
+  std::atomic<uint32_t> ShadowSize = 0;
+  /// @}
 };
 
 } // namespace Runtime
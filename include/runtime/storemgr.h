@@ -13,10 +13,11 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/epoch.h"
 #include "runtime/instance/module.h"
 
+#include <atomic>
 #include <mutex>
-#include <shared_mutex>
 #include <vector>
 
 namespace WasmEdge {
@@ -29,58 +30,96 @@ namespace Runtime {
 
 class StoreManager {
 public:
-  StoreManager() = default;
+  StoreManager() : Table(new ModuleTable()) {}
   ~StoreManager() {
     // When destroying this store manager, unlink all the registered module
     // instances.
-    for (auto &&Pair : NamedMod) {
+    std::unique_lock Lock(Mutex);
+    const auto *Current = Table.load(std::memory_order_relaxed);
+    for (auto &&Pair : Current->NamedMod) {
       (const_cast<Instance::ModuleInstance *>(Pair.second))->unlinkStore(this);
     }
+    Epoch::retire(Current);
   }
 
   /// Get the length of the list of registered modules.
   uint32_t getModuleListSize() const noexcept {
-    std::shared_lock Lock(Mutex);
-    return static_cast<uint32_t>(NamedMod.size());
+    Epoch::Guard Guard;
+    return static_cast<uint32_t>(
+        Table.load(std::memory_order_acquire)->NamedMod.size());
   }
 
   /// Get list of registered modules.
   template <typename CallbackT> auto getModuleList(CallbackT &&CallBack) const {
-    std::shared_lock Lock(Mutex);
-    return std::forward<CallbackT>(CallBack)(NamedMod);
+    Epoch::Guard Guard;
+    return std::forward<CallbackT>(CallBack)(
+        Table.load(std::memory_order_acquire)->NamedMod);
   }
 
-  /// Find module by name.
+  /// Find module by name, and optionally the hash of the name by hashName().
   const Instance::ModuleInstance *findModule(std::string_view Name) const {
-    std::shared_lock Lock(Mutex);
-    auto Iter = NamedMod.find(Name);
-    if (likely(Iter != NamedMod.cend())) {
-      return Iter->second;
-    }
-    return nullptr;
+    return findModule(Name, hashName(Name));
+  }
+  const Instance::ModuleInstance *findModule(std::string_view Name,
+                                             uint64_t Hash) const {
+    Epoch::Guard Guard;
+    return Table.load(std::memory_order_acquire)->NamedModIndex.find(Name,
+                                                                     Hash);
   }
 
 private:
-  /// \name Mutex for thread-safe.
-  mutable std::shared_mutex Mutex;
+  /// Snapshot of the registered modules. The snapshots are immutable once
+  /// published, and replaced by the modified copies. The names refer to the
+  /// names owned by the module instances, which outlive their registration.
+  struct ModuleTable {
+    void insert(const Instance::ModuleInstance *ModInst) {
+      const auto Name = ModInst->getModuleName();
+      NamedMod.emplace(Name, ModInst);
+      NamedModIndex.insert(Name, hashName(Name), ModInst);
+    }
+    void erase(std::string_view Name) {
+      NamedModIndex.erase(Name, hashName(Name));
+      NamedMod.erase(Name);
+    }
+
+    /// \name Module name mapping.
+    std::map<std::string_view, const Instance::ModuleInstance *, std::less<>>
+        NamedMod;
+    /// Hashed index of the module names for the lookups.
+    NameIndex<const Instance::ModuleInstance> NamedModIndex;
+  };
+
+  /// Publish the new snapshot and retire the current one. Should be called
+  /// with the mutex locked.
+  void publish(const ModuleTable *NewTable) {
+    Epoch::retire(Table.exchange(NewTable));
+  }
+
+  /// \name Mutex for the writers. The readers go through the epochs.
+  std::mutex Mutex;
 
   friend class Executor::Executor;
 
   /// Register named module into this store.
   Expect<void> registerModule(const Instance::ModuleInstance *ModInst) {
     std::unique_lock Lock(Mutex);
-    auto Iter = NamedMod.find(ModInst->getModuleName());
-    if (likely(Iter != NamedMod.cend())) {
+    const auto *Current = Table.load(std::memory_order_relaxed);
+    if (Current->NamedMod.count(ModInst->getModuleName())) {
       return Unexpect(ErrCode::Value::ModuleNameConflict);
     }
-    NamedMod.emplace(ModInst->getModuleName(), ModInst);
+    auto NewTable = std::make_unique<ModuleTable>(*Current);
+    NewTable->insert(ModInst);
+    publish(NewTable.release());
     // Link the module instance to this store manager.
     (const_cast<Instance::ModuleInstance *>(ModInst))
         ->linkStore(this, [](StoreManager *Store,
                              const Instance::ModuleInstance *Inst) {
           // The unlink callback.
           std::unique_lock CallbackLock(Store->Mutex);
-          (Store->NamedMod).erase(std::string(Inst->getModuleName()));
+          auto NewTable = std::make_unique<ModuleTable>(
+              *Store->Table.load(std::memory_order_relaxed));
+          NewTable->erase(Inst->getModuleName());
+          Store->publish(NewTable.release());
         });
     return {};
   }
@@ -90,8 +129,8 @@ private:
     FailedMod = std::move(Mod);
   }
 
-  /// \name Module name mapping.
-  std::map<std::string, const Instance::ModuleInstance *, std::less<>> NamedMod;
+  /// \name Current snapshot of the registered modules.
+  std::atomic<const ModuleTable *> Table;
 
   /// \name Last instantiation failed module.
   /// According to the current spec, the instances should be able to be
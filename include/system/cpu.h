@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/cpu.h - CPU feature detection ---------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the detection of the target features of the running
+/// CPU, for selecting the AOT code compiled for the best matched target.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge {
+namespace CPU {
+
+/// Check if the running CPU supports a target feature, named as in LLVM, such
+/// as `avx2` or `dotprod`. The features not known by the detection are not
+/// supported.
+bool hasFeature(std::string_view Feature) noexcept;
+
+/// Check if a target feature is known by the detection on this architecture.
+bool isKnownFeature(std::string_view Feature) noexcept;
+
+/// List the known target features supported by the running CPU.
+std::vector<std::string_view> features();
+
+/// List the target features known by the detection on this architecture.
+std::vector<std::string_view> knownFeatures();
+
+} // namespace CPU
+} // namespace WasmEdge
@@ -28,6 +28,10 @@ public:
 
   [[noreturn]] static void emitFault(ErrCode Error);
 
+  /// Replace the handler chain of the current thread and return the old one.
+  /// Used when switching the thread between fiber stacks.
+  static Fault *exchangeLocalHandler(Fault *Handler) noexcept;
+
   std::jmp_buf &buffer() noexcept { return Buffer; }
 
 private:
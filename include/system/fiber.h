@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/fiber.h - Stackful coroutine ----------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the stackful coroutine used to suspend a running wasm
+/// execution inside a host function and resume it later on the same thread.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/defines.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#if WASMEDGE_OS_LINUX
+#include <ucontext.h>
+#endif
+
+namespace WasmEdge {
+
+class Fault;
+
+class Fiber {
+public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /// Condition a suspended fiber is waiting for before it can be resumed.
+  struct WaitCondition {
+    /// Native file descriptor to poll, or -1 for none.
+    int Fd = -1;
+    /// Wait for writability instead of readability.
+    bool Write = false;
+    /// Resume no later than this time point.
+    std::optional<TimePoint> Until;
+  };
+
+  static inline constexpr size_t kDefaultStackSize = 2 * 1024 * 1024;
+
+  /// Whether the fibers can really suspend on this platform. If not, resume()
+  /// runs the entry to completion and current() is always nullptr.
+  static bool isSupported() noexcept;
+
+  explicit Fiber(std::function<void()> Entry,
+                 size_t StackSize = kDefaultStackSize);
+  Fiber(const Fiber &) = delete;
+  Fiber &operator=(const Fiber &) = delete;
+  ~Fiber() noexcept;
+
+  /// Switch to this fiber. Returns when the fiber yields or finishes.
+  void resume() noexcept;
+
+  /// Suspend the running fiber and return to the caller of its resume().
+  static void yield() noexcept;
+
+  /// Record what the running fiber waits for before its next yield. The
+  /// condition is cleared when the fiber is resumed.
+  static void setWaitCondition(const WaitCondition &Cond) noexcept;
+
+  /// Get the fiber running on the current thread, or nullptr.
+  static Fiber *current() noexcept;
+
+  bool isFinished() const noexcept { return Finished; }
+
+  /// Get the condition the fiber is suspended on.
+  const WaitCondition &getWaitCondition() const noexcept { return Wait; }
+
+private:
+  std::function<void()> Entry;
+  WaitCondition Wait;
+  bool Finished = false;
+#if WASMEDGE_OS_LINUX
+  static void trampoline() noexcept;
+
+  /// The fiber which resumed this one, for nested fibers.
+  Fiber *Parent = nullptr;
+  /// Fault handler chain of this fiber while it is switched out.
+  Fault *FaultHandler = nullptr;
+  uint8_t *Stack = nullptr;
+  size_t StackSize = 0;
+  ucontext_t Context;
+  ucontext_t ReturnContext;
+#endif
+};
+
+} // namespace WasmEdge
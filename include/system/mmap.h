@@ -23,6 +23,9 @@ public:
   MMap(const std::filesystem::path &Path) noexcept;
   ~MMap() noexcept;
   void *address() const noexcept;
+  /// Get the descriptor of the mapped file, or -1 if there is no POSIX
+  /// descriptor.
+  int descriptor() const noexcept;
   static bool supported() noexcept;
 
 private:
@@ -30,14 +30,22 @@ public:
       : VMPtr(&TargetVM) {
     std::promise<T> Promise;
     Future = Promise.get_future();
-    Thread =
-        std::thread([FPtr, P = std::move(Promise),
-                     Tuple = std::tuple(
-                         &TargetVM, std::forward<ArgsT>(Args)...)]() mutable {
-          std::get<0>(Tuple)->newThread();
-          P.set_value(std::apply(FPtr, Tuple));
-        });
-    Thread.detach();
+    auto Task = [FPtr, P = std::move(Promise),
+                 Tuple = std::tuple(&TargetVM,
+                                    std::forward<ArgsT>(Args)...)]() mutable {
+      std::get<0>(Tuple)->newThread();
+      P.set_value(std::apply(FPtr, Tuple));
+    };
+    if (auto *Pool = TargetVM.getAsyncThreadPool()) {
+      if (!Pool->submit(std::packaged_task<void()>(std::move(Task)))) {
+        std::promise<T> Failed;
+        Failed.set_value(Unexpect(ErrCode::Value::RuntimeError));
+        Future = Failed.get_future();
+      }
+    } else {
+      Thread = std::thread(std::move(Task));
+      Thread.detach();
+    }
   }
   Async(const Async &) noexcept = delete;
   Async(Async &&Other) noexcept : Async() { swap(*this, Other); }
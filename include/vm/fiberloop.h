@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/vm/fiberloop.h - Fiber event loop class definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of FiberLoop class, which multiplexes
+/// many VM executions on a single thread. Each execution runs on its own
+/// fiber, and a host function that would block suspends the fiber until its
+/// file descriptor or deadline is ready.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "system/fiber.h"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+class VM;
+
+/// Single thread scheduler of fibers.
+class FiberLoop {
+public:
+  explicit FiberLoop(size_t StackSize = Fiber::kDefaultStackSize) noexcept
+      : StackSize(StackSize) {}
+  FiberLoop(const FiberLoop &) = delete;
+  FiberLoop &operator=(const FiberLoop &) = delete;
+
+  /// Queue a task to run on a new fiber.
+  void spawn(std::function<void()> Task);
+
+  /// Queue an execution of a function of the VM on a new fiber. A VM should
+  /// only be driven by one fiber at a time.
+  std::future<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+  spawnExecute(VM &TargetVM, std::string_view Func,
+               Span<const ValVariant> Params = {},
+               Span<const ValType> ParamTypes = {});
+
+  /// Run the fibers on the calling thread until all of them finished.
+  void run();
+
+  /// Getter of the count of unfinished fibers.
+  size_t size() const noexcept { return Ready.size() + Waiting.size(); }
+
+private:
+  /// Wait for the conditions of the suspended fibers and move the satisfied
+  /// ones to the ready queue.
+  void pollWaiting();
+
+  const size_t StackSize;
+  std::deque<std::unique_ptr<Fiber>> Ready;
+  std::vector<std::unique_ptr<Fiber>> Waiting;
+};
+
+} // namespace VM
+} // namespace WasmEdge
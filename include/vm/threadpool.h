@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/vm/threadpool.h - Thread pool class definition -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of ThreadPool class, which runs the
+/// asynchronous executions of a VM on reused worker threads.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+/// Fixed size worker pool with a bounded FIFO task queue.
+class ThreadPool {
+public:
+  /// Create the pool with `ThreadCount` workers. A `QueueLimit` of 0 means the
+  /// queue is unbounded. If `Affinity` is set, the N-th worker is pinned to
+  /// the N-th online CPU (modulo the CPU count) where the platform supports it.
+  ThreadPool(uint32_t ThreadCount, uint32_t QueueLimit, bool Affinity);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  /// Run the remaining queued tasks and join all workers.
+  ~ThreadPool() noexcept;
+
+  /// Enqueue a task. Blocks while the queue is full. A worker of the pool
+  /// does not wait, since all the workers could end up waiting for each
+  /// other: the task is dropped and false is returned.
+  bool submit(std::packaged_task<void()> Task);
+
+  /// Getter of the worker count.
+  uint32_t size() const noexcept {
+    return static_cast<uint32_t>(Workers.size());
+  }
+
+private:
+  void run() noexcept;
+
+  std::mutex Mutex;
+  std::condition_variable NotEmpty;
+  std::condition_variable NotFull;
+  std::deque<std::packaged_task<void()>> Queue;
+  std::vector<std::thread> Workers;
+  const uint32_t QueueLimit;
+  bool Stopping = false;
+};
+
+} // namespace VM
+} // namespace WasmEdge
@@ -25,6 +25,8 @@
 #include "runtime/instance/module.h"
 #include "runtime/storemgr.h"
 
+#include "vm/threadpool.h"
+
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -150,6 +152,24 @@ public:
     return unsafeExecute(ModName, Func, Params, ParamTypes);
   }
 
+  /// Execute wasm with a batch of inputs. See Executor::invokeBatch().
+  Expect<void> executeBatch(std::string_view Func, uint32_t Count,
+                            Span<const ValVariant> Params,
+                            Span<ValVariant> Returns,
+                            Span<ErrCode> Errors = {}) {
+    std::shared_lock Lock(Mutex);
+    return unsafeExecuteBatch(Func, Count, Params, Returns, Errors);
+  }
+
+  /// Execute function of registered module with a batch of inputs.
+  Expect<void> executeBatch(std::string_view ModName, std::string_view Func,
+                            uint32_t Count, Span<const ValVariant> Params,
+                            Span<ValVariant> Returns,
+                            Span<ErrCode> Errors = {}) {
+    std::shared_lock Lock(Mutex);
+    return unsafeExecuteBatch(ModName, Func, Count, Params, Returns, Errors);
+  }
+
   /// Asynchronous execute wasm with given input.
   Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
   asyncExecute(std::string_view Func, Span<const ValVariant> Params = {},
@@ -211,6 +231,10 @@ public:
   /// Getter of statistics.
   Statistics::Statistics &getStatistics() noexcept { return Stat; }
 
+  /// Getter of the asynchronous execution thread pool. Returns nullptr if the
+  /// pool is disabled by the configuration.
+  ThreadPool *getAsyncThreadPool() noexcept { return AsyncPool.get(); }
+
 private:
   Expect<void> unsafeRegisterModule(std::string_view Name,
                                     const std::filesystem::path &Path);
@@ -251,6 +275,16 @@ private:
                 Span<const ValVariant> Params = {},
                 Span<const ValType> ParamTypes = {});
 
+  Expect<void> unsafeExecuteBatch(std::string_view Func, uint32_t Count,
+                                  Span<const ValVariant> Params,
+                                  Span<ValVariant> Returns,
+                                  Span<ErrCode> Errors);
+
+  Expect<void> unsafeExecuteBatch(std::string_view Mod, std::string_view Func,
+                                  uint32_t Count, Span<const ValVariant> Params,
+                                  Span<ValVariant> Returns,
+                                  Span<ErrCode> Errors);
+
   void unsafeCleanup();
 
   std::vector<std::pair<std::string, const AST::FunctionType &>>
@@ -271,6 +305,13 @@ private:
                 std::string_view Func, Span<const ValVariant> Params = {},
                 Span<const ValType> ParamTypes = {});
 
+  /// Helper function for execution with a batch of inputs.
+  Expect<void>
+  unsafeExecuteBatch(const Runtime::Instance::ModuleInstance *ModInst,
+                     std::string_view Func, uint32_t Count,
+                     Span<const ValVariant> Params, Span<ValVariant> Returns,
+                     Span<ErrCode> Errors);
+
   /// VM environment.
   const Configure Conf;
   Statistics::Statistics Stat;
@@ -290,6 +331,10 @@ private:
   Runtime::StoreManager &StoreRef;
   std::map<HostRegistration, std::unique_ptr<Runtime::Instance::ModuleInstance>>
       ImpObjs;
+
+  /// Worker pool for asynchronous executions. Declared last to be destroyed
+  /// first, so that the pending executions finish while the VM is alive.
+  std::unique_ptr<ThreadPool> AsyncPool;
 };
 
 } // namespace VM
@@ -4,19 +4,38 @@
 #include "aot/cache.h"
 
 #include "aot/blake3.h"
+#include "aot/version.h"
 #include "common/config.h"
 #include "common/defines.h"
 #include "common/hexstr.h"
+#include "common/log.h"
+#include "common/metrics.h"
+#include "system/cpu.h"
 #include "system/path.h"
 
+#include <algorithm>
 #include <array>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <system_error>
+#include <tuple>
+#include <vector>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
 
 namespace WasmEdge {
 namespace AOT {
 
 namespace {
+
+static inline constexpr std::string_view kMetaHeader = "wasmedge-cache 1"sv;
+static inline constexpr std::string_view kMetaExtension = ".meta"sv;
+
 std::filesystem::path getRoot(Cache::StorageScope Scope) {
   switch (Scope) {
   case Cache::StorageScope::Global:
@@ -31,12 +50,184 @@ std::filesystem::path getRoot(Cache::StorageScope Scope) {
     assumingUnreachable();
   }
 }
+
+std::filesystem::path getMetaPath(const std::filesystem::path &Path) {
+  auto MetaPath = Path;
+  MetaPath += kMetaExtension;
+  return MetaPath;
+}
+
+/// Exclusive lock of the root of a scope, held by a process while updating
+/// the entries. The lock is advisory and released when the file is closed.
+/// Without the file locks, only the renames of the updates are atomic.
+class RootLock {
+public:
+  RootLock(const std::filesystem::path &Root) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+    std::error_code ErrCode;
+    std::filesystem::create_directories(Root, ErrCode);
+    Fd = ::open((Root / "lock"sv).u8string().c_str(),
+                O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (Fd >= 0 && ::flock(Fd, LOCK_EX) != 0) {
+      spdlog::warn("lock of aot cache failed:{}", Root.u8string());
+    }
+#endif
+  }
+  ~RootLock() noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+    if (Fd >= 0) {
+      ::close(Fd);
+    }
+#endif
+  }
+  RootLock(const RootLock &) = delete;
+  RootLock &operator=(const RootLock &) = delete;
+
+private:
+  [[maybe_unused]] int Fd = -1;
+};
+
+/// Hash the file in BLAKE3, or return an empty string if it can not be read.
+std::string hashFile(const std::filesystem::path &Path) {
+  std::ifstream IS(Path, std::ios::binary);
+  if (!IS) {
+    return {};
+  }
+  Blake3 Hasher;
+  std::vector<Byte> Buffer(UINT32_C(1) << 16);
+  auto *Ptr = reinterpret_cast<char *>(Buffer.data());
+  while (IS.read(Ptr, static_cast<std::streamsize>(Buffer.size())) ||
+         IS.gcount() > 0) {
+    Hasher.update(
+        Span<const Byte>(Buffer.data(), static_cast<size_t>(IS.gcount())));
+  }
+  if (IS.bad()) {
+    return {};
+  }
+  std::array<Byte, 32> Hash;
+  Hasher.finalize(Hash);
+  std::string HexStr;
+  convertBytesToHexStr(Hash, HexStr);
+  return HexStr;
+}
+
+/// Modification time of the file in the ticks of the file clock, or 0 if it
+/// can not be read.
+int64_t getModifiedTime(const std::filesystem::path &Path) {
+  std::error_code ErrCode;
+  const auto Time = std::filesystem::last_write_time(Path, ErrCode);
+  if (ErrCode) {
+    return 0;
+  }
+  return static_cast<int64_t>(Time.time_since_epoch().count());
+}
+
+/// Check the entry against its metadata. The entry should be compiled by the
+/// same AOT binary version, for the target features supported by the running
+/// CPU, and have the recorded size and hash. The hash is only checked if the
+/// entry is modified since the commit, to keep the hits cheap.
+bool verify(const std::filesystem::path &Path) {
+  std::ifstream IS(getMetaPath(Path));
+  std::string Line;
+  if (!std::getline(IS, Line) || Line != kMetaHeader) {
+    return false;
+  }
+  uint32_t Version = 0;
+  uint64_t Size = 0;
+  int64_t ModifiedTime = 0;
+  std::string Hash;
+  bool FeaturesSupported = true;
+  while (std::getline(IS, Line)) {
+    std::istringstream LS(Line);
+    std::string Field;
+    LS >> Field;
+    if (Field == "version"sv) {
+      LS >> Version;
+    } else if (Field == "size"sv) {
+      LS >> Size;
+    } else if (Field == "mtime"sv) {
+      LS >> ModifiedTime;
+    } else if (Field == "hash"sv) {
+      LS >> Hash;
+    } else if (Field == "features"sv) {
+      for (std::string Feature; LS >> Feature;) {
+        FeaturesSupported = FeaturesSupported && CPU::hasFeature(Feature);
+      }
+    }
+  }
+  if (Version != kBinaryVersion || !FeaturesSupported) {
+    return false;
+  }
+  std::error_code ErrCode;
+  if (std::filesystem::file_size(Path, ErrCode) != Size || ErrCode) {
+    return false;
+  }
+  if (Hash.empty()) {
+    return false;
+  }
+  if (ModifiedTime != 0 && getModifiedTime(Path) == ModifiedTime) {
+    return true;
+  }
+  return hashFile(Path) == Hash;
+}
+
+void removeEntry(const std::filesystem::path &Path) {
+  std::error_code ErrCode;
+  std::filesystem::remove(Path, ErrCode);
+  std::filesystem::remove(getMetaPath(Path), ErrCode);
+}
+
+/// Evict the least recently used entries under the root, which should be
+/// locked by the caller. The kept entry is never evicted.
+void evictLocked(const std::filesystem::path &Root, uint64_t SizeLimit,
+                 const std::filesystem::path &Kept = {}) {
+  std::error_code ErrCode;
+  std::vector<std::tuple<std::filesystem::file_time_type, uint64_t,
+                         std::filesystem::path>>
+      Entries;
+  uint64_t Total = 0;
+  for (auto Iter = std::filesystem::recursive_directory_iterator(Root, ErrCode);
+       !ErrCode && Iter != std::filesystem::recursive_directory_iterator();
+       Iter.increment(ErrCode)) {
+    const auto &MetaPath = Iter->path();
+    std::error_code SizeErrCode;
+    if (MetaPath.extension().u8string() != kMetaExtension ||
+        !Iter->is_regular_file(SizeErrCode)) {
+      continue;
+    }
+    auto Path = MetaPath;
+    Path.replace_extension();
+    const uint64_t Size = std::filesystem::file_size(Path, SizeErrCode) +
+                          std::filesystem::file_size(MetaPath, SizeErrCode);
+    const auto LastUse =
+        std::filesystem::last_write_time(MetaPath, SizeErrCode);
+    if (SizeErrCode) {
+      continue;
+    }
+    Total += Size;
+    Entries.emplace_back(LastUse, Size, std::move(Path));
+  }
+
+  std::sort(Entries.begin(), Entries.end());
+  for (const auto &[LastUse, Size, Path] : Entries) {
+    if (Total <= SizeLimit) {
+      break;
+    }
+    if (Path == Kept) {
+      continue;
+    }
+    removeEntry(Path);
+    Total -= Size;
+  }
+}
+
 } // namespace
 
 Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
                                              Cache::StorageScope Scope,
                                              std::string_view Key) {
   auto Root = getRoot(Scope);
+  const auto LockRoot = Root;
   if (!Key.empty()) {
     Root /= std::filesystem::u8path(Key);
   }
@@ -48,7 +239,100 @@ Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
   std::string HexStr;
   convertBytesToHexStr(Hash, HexStr);
 
-  return Root / HexStr;
+  auto Path = Root / HexStr;
+  std::error_code ErrCode;
+  bool Hit = false;
+  if (std::filesystem::exists(Path, ErrCode)) {
+    RootLock Lock(LockRoot);
+    if (verify(Path)) {
+      // Record the use for the eviction.
+      std::filesystem::last_write_time(
+          getMetaPath(Path), std::filesystem::file_time_type::clock::now(),
+          ErrCode);
+      Hit = true;
+    } else {
+      spdlog::warn("aot cache entry is invalid, removed:{}", Path.u8string());
+      removeEntry(Path);
+    }
+  }
+  if (Hit) {
+    Metrics::runtime().AOTCacheHits.add();
+  } else {
+    Metrics::runtime().AOTCacheMisses.add();
+  }
+  return Path;
+}
+
+Expect<void> Cache::commit(const std::filesystem::path &Compiled,
+                           const std::filesystem::path &Path,
+                           Cache::StorageScope Scope, uint64_t SizeLimit) {
+  const auto Root = getRoot(Scope);
+  std::error_code EC;
+  const uint64_t Size = std::filesystem::file_size(Compiled, EC);
+  const auto Hash = hashFile(Compiled);
+  // The rename keeps the modification time, which is recorded to skip the
+  // hash of the unmodified entry.
+  const auto ModifiedTime = getModifiedTime(Compiled);
+  if (EC || Hash.empty()) {
+    spdlog::error("read compiled module failed:{}", Compiled.u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  RootLock Lock(Root);
+  const auto MetaPath = getMetaPath(Path);
+  auto TempMetaPath = MetaPath;
+  TempMetaPath += ".tmp"sv;
+  {
+    std::ofstream OS(TempMetaPath, std::ios::trunc);
+    OS << kMetaHeader << '\n';
+    OS << "version " << kBinaryVersion << '\n';
+    OS << "size " << Size << '\n';
+    OS << "mtime " << ModifiedTime << '\n';
+    OS << "hash " << Hash << '\n';
+    OS << "features";
+    for (const auto Feature : CPU::features()) {
+      OS << ' ' << Feature;
+    }
+    OS << '\n';
+    if (!OS.flush()) {
+      spdlog::error("write aot cache metadata failed:{}",
+                    TempMetaPath.u8string());
+      std::filesystem::remove(TempMetaPath, EC);
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+  // The entry is replaced before its metadata, and both under the lock, so
+  // the verification never accepts a mismatched pair.
+  std::filesystem::rename(Compiled, Path, EC);
+  if (!EC) {
+    std::filesystem::rename(TempMetaPath, MetaPath, EC);
+  }
+  if (EC) {
+    spdlog::error("commit aot cache entry failed:{}", EC.message());
+    removeEntry(Path);
+    std::filesystem::remove(TempMetaPath, EC);
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  if (SizeLimit != 0) {
+    evictLocked(Root, SizeLimit, Path);
+  }
+  return {};
+}
+
+void Cache::evict(Cache::StorageScope Scope, uint64_t SizeLimit,
+                  std::string_view Key) {
+  const auto LockRoot = getRoot(Scope);
+  auto Root = LockRoot;
+  if (!Key.empty()) {
+    Root /= std::filesystem::u8path(Key);
+  }
+  std::error_code ErrCode;
+  if (!std::filesystem::exists(Root, ErrCode)) {
+    return;
+  }
+  RootLock Lock(LockRoot);
+  evictLocked(Root, SizeLimit);
 }
 
 void Cache::clear(Cache::StorageScope Scope, std::string_view Key) {
@@ -7,6 +7,7 @@
 #include "common/defines.h"
 #include "common/filesystem.h"
 #include "common/log.h"
+#include "system/cpu.h"
 
 #include <algorithm>
 #include <array>
@@ -15,16 +16,24 @@
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <map>
 #include <lld/Common/Driver.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/MC/SubtargetFeature.h>
+#include <llvm/Object/ELFObjectFile.h>
 #include <llvm/Object/ObjectFile.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/ProfileCommon.h>
+#include <llvm/Support/Endian.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/LEB128.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
@@ -32,9 +41,12 @@
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <tuple>
+#include <unordered_map>
 
 #if WASMEDGE_OS_WINDOWS
 #include <llvm/Object/COFF.h>
@@ -127,6 +139,7 @@ static std::vector<llvm::Value *> unpackStruct(llvm::IRBuilder<> &Builder,
                                                llvm::Value *Struct);
 static llvm::Value *createLikely(llvm::IRBuilder<> &Builder,
                                  llvm::Value *Value);
+static bool isStraightLine(WasmEdge::OpCode Code);
 class FunctionCompiler;
 
 // XXX: Misalignment handler not implemented yet, forcing unalignment
@@ -196,6 +209,17 @@ WasmEdge::Expect<void> WriteU64(llvm::raw_ostream &OS, uint64_t Data) {
   return {};
 };
 
+/// Write the value in 5 bytes, for the sizes patched or computed before the
+/// data is written.
+WasmEdge::Expect<void> WriteU32Fixed(llvm::raw_ostream &OS, uint32_t Data) {
+  for (int I = 0; I < 4; ++I) {
+    WriteByte(OS, static_cast<uint8_t>((Data & UINT32_C(0x7f)) | 0x80));
+    Data >>= 7;
+  }
+  WriteByte(OS, static_cast<uint8_t>(Data & UINT32_C(0x7f)));
+  return {};
+};
+
 WasmEdge::Expect<void> WriteName(llvm::raw_ostream &OS, std::string_view Data) {
   WriteU32(OS, static_cast<uint32_t>(Data.size()));
   for (const auto C : Data) {
@@ -234,6 +258,7 @@ struct WasmEdge::AOT::Compiler::CompileContext {
   llvm::PointerType *Int32PtrTy;
   llvm::PointerType *Int64PtrTy;
   llvm::PointerType *Int128PtrTy;
+  llvm::StructType *HostNativeTy;
   llvm::StructType *ExecCtxTy;
   llvm::PointerType *ExecCtxPtrTy;
   llvm::ArrayType *IntrinsicsTableTy;
@@ -280,6 +305,13 @@ struct WasmEdge::AOT::Compiler::CompileContext {
                          const WasmEdge::AST::CodeSegment *>>
       Functions;
   std::vector<llvm::Type *> Globals;
+  uint32_t MemoryCount = 0;
+  /// Copies of the functions of the linked modules, by the module and the
+  /// function index.
+  std::map<std::pair<const AST::Module *, uint32_t>, llvm::Function *>
+      LinkedFunctions;
+  /// Code hashes of the linked modules with functions copied, by the names.
+  std::map<std::string, uint64_t> LinkedHashes;
   llvm::GlobalVariable *IntrinsicsTable;
   llvm::Function *Trap;
   CompileContext(llvm::Module &M, bool IsGenericBinary)
@@ -303,6 +335,14 @@ struct WasmEdge::AOT::Compiler::CompileContext {
         Int32PtrTy(llvm::Type::getInt32PtrTy(LLContext)),
         Int64PtrTy(Int64Ty->getPointerTo()),
         Int128PtrTy(Int128Ty->getPointerTo()),
+        HostNativeTy(llvm::StructType::create(
+            "HostNative",
+            // Entry
+            Int8PtrTy,
+            // Self
+            Int8PtrTy,
+            // Frame
+            llvm::ArrayType::get(Int8PtrTy, 2))),
         ExecCtxTy(llvm::StructType::create(
             "ExecCtx",
             // Memory
@@ -318,7 +358,11 @@ struct WasmEdge::AOT::Compiler::CompileContext {
             // GasLimit
             Int64Ty,
             // StopToken
-            llvm::Type::getInt32PtrTy(LLContext))),
+            llvm::Type::getInt32PtrTy(LLContext),
+            // OpCodeCounts
+            Int64PtrTy,
+            // HostNatives
+            HostNativeTy->getPointerTo())),
         ExecCtxPtrTy(ExecCtxTy->getPointerTo()),
         IntrinsicsTableTy(llvm::ArrayType::get(
             Int8PtrTy, uint32_t(AST::Module::Intrinsics::kIntrinsicMax))),
@@ -342,28 +386,7 @@ struct WasmEdge::AOT::Compiler::CompileContext {
       llvm::StringMap<bool> FeatureMap;
       llvm::sys::getHostCPUFeatures(FeatureMap);
       for (auto &Feature : FeatureMap) {
-        if (Feature.second) {
-#if defined(__x86_64__)
-          if (!SupportXOP && Feature.first() == "xop") {
-            SupportXOP = true;
-          }
-          if (!SupportSSE4_1 && Feature.first() == "sse4.1") {
-            SupportSSE4_1 = true;
-          }
-          if (!SupportSSSE3 && Feature.first() == "ssse3") {
-            SupportSSSE3 = true;
-          }
-          if (!SupportSSE2 && Feature.first() == "sse2") {
-            SupportSSE2 = true;
-          }
-#elif defined(__aarch64__)
-          if (!SupportNEON && Feature.first() == "neon") {
-            SupportNEON = true;
-          }
-#endif
-        }
-
-        SubtargetFeatures.AddFeature(Feature.first(), Feature.second);
+        addFeature(Feature.first(), Feature.second);
       }
     }
 
@@ -379,6 +402,31 @@ struct WasmEdge::AOT::Compiler::CompileContext {
       Builder.CreateUnreachable();
     }
   }
+  /// Enable or disable a target feature of the generated code.
+  void addFeature(llvm::StringRef Feature, bool Enabled) {
+    if (Enabled) {
+#if defined(__x86_64__)
+      if (!SupportXOP && Feature == "xop") {
+        SupportXOP = true;
+      }
+      if (!SupportSSE4_1 && Feature == "sse4.1") {
+        SupportSSE4_1 = true;
+      }
+      if (!SupportSSSE3 && Feature == "ssse3") {
+        SupportSSSE3 = true;
+      }
+      if (!SupportSSE2 && Feature == "sse2") {
+        SupportSSE2 = true;
+      }
+#elif defined(__aarch64__)
+      if (!SupportNEON && Feature == "neon") {
+        SupportNEON = true;
+      }
+#endif
+    }
+
+    SubtargetFeatures.AddFeature(Feature, Enabled);
+  }
   llvm::Value *getMemory(llvm::IRBuilder<> &Builder, llvm::LoadInst *ExecCtx,
                          uint32_t Index) {
     auto *Array = Builder.CreateExtractValue(ExecCtx, {0});
@@ -416,6 +464,10 @@ struct WasmEdge::AOT::Compiler::CompileContext {
                             llvm::LoadInst *ExecCtx) {
     return Builder.CreateExtractValue(ExecCtx, {6});
   }
+  llvm::Value *getOpCodeCounts(llvm::IRBuilder<> &Builder,
+                               llvm::LoadInst *ExecCtx) {
+    return Builder.CreateExtractValue(ExecCtx, {7});
+  }
   llvm::FunctionCallee getIntrinsic(llvm::IRBuilder<> &Builder,
                                     AST::Module::Intrinsics Index,
                                     llvm::FunctionType *Ty) {
@@ -449,6 +501,16 @@ struct WasmEdge::AOT::Compiler::CompileContext {
   }
 };
 
+struct WasmEdge::AOT::Compiler::TargetObject {
+  /// Target features required by the code, which are detectable by the
+  /// runtime.
+  std::vector<std::string> Features;
+  /// Linked modules with functions copied into the code, by the names and the
+  /// code hashes, checked at the instantiation.
+  std::vector<std::pair<std::string, uint64_t>> LinkedModules;
+  llvm::SmallString<0> Code;
+};
+
 namespace {
 
 using namespace WasmEdge;
@@ -546,12 +608,18 @@ class FunctionCompiler {
 public:
   FunctionCompiler(AOT::Compiler::CompileContext &Context, llvm::Function *F,
                    Span<const ValType> Locals, bool Interruptible,
-                   bool InstructionCounting, bool GasMeasuring, bool OptNone)
+                   bool InstructionCounting, bool GasMeasuring, bool OptNone,
+                   const PGO::FunctionProfile *Profile,
+                   std::optional<uint32_t> InstrumentedIdx)
       : Context(Context), LLContext(Context.LLContext),
-        Interruptible(Interruptible), OptNone(OptNone), F(F),
+        Interruptible(Interruptible), OptNone(OptNone), Profile(Profile),
+        InstrumentedIdx(InstrumentedIdx), F(F),
         Builder(llvm::BasicBlock::Create(LLContext, "entry", F)) {
     if (F) {
       setIsFPConstrained(Builder);
+      if (Profile) {
+        F->setEntryCount(Profile->EntryCount);
+      }
       ExecCtx = Builder.CreateLoad(Context.ExecCtxTy, F->arg_begin());
 
       if (InstructionCounting) {
@@ -564,6 +632,11 @@ public:
         Builder.CreateStore(Builder.getInt64(0), LocalGas);
       }
 
+      if (Context.MemoryCount > 0) {
+        LocalMemBase = Builder.CreateAlloca(Context.Int8PtrTy);
+        reloadMemoryBase();
+      }
+
       for (llvm::Argument *Arg = F->arg_begin() + 1; Arg != F->arg_end();
            ++Arg) {
         llvm::Type *Ty = Arg->getType();
@@ -601,6 +674,9 @@ public:
     auto *RetBB = llvm::BasicBlock::Create(LLContext, "ret", F);
     Type.first.clear();
     enterBlock(RetBB, nullptr, nullptr, {}, std::move(Type));
+    // Safepoints are polled at function entries and loop headers, which
+    // bound the instructions executed between two polls.
+    checkStop();
     compile(Code.getExpr().getInstrs());
     assuming(ControlStack.empty());
     compileReturn();
@@ -641,8 +717,6 @@ public:
         }
         enterBlock(EndBlock, nullptr, nullptr, std::move(Args),
                    std::move(Type));
-        checkStop();
-        updateGas();
         return;
       }
       case OpCode::Loop: {
@@ -687,7 +761,8 @@ public:
         } else {
           Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         }
-        Builder.CreateCondBr(Cond, Then, Else);
+        setBranchWeights(Builder.CreateCondBr(Cond, Then, Else),
+                         Instr.getOffset(), false);
 
         Builder.SetInsertPoint(Then);
         auto Type = Context.resolveBlockType(Instr.getBlockType());
@@ -763,7 +838,8 @@ public:
         auto *Cond = Builder.CreateICmpNE(stackPop(), Builder.getInt32(0));
         setLableJumpPHI(Label);
         auto *Next = llvm::BasicBlock::Create(LLContext, "br_if.end", F);
-        Builder.CreateCondBr(Cond, getLabel(Label), Next);
+        setBranchWeights(Builder.CreateCondBr(Cond, getLabel(Label), Next),
+                         Instr.getOffset(), false);
         Builder.SetInsertPoint(Next);
         break;
       }
@@ -782,6 +858,7 @@ public:
           Switch->addCase(Builder.getInt32(I),
                           getLabel(LabelTable[I].TargetIndex));
         }
+        setBranchWeights(Switch, Instr.getOffset(), true);
         setUnreachable();
         Builder.SetInsertPoint(
             llvm::BasicBlock::Create(LLContext, "br_table.end", F));
@@ -1077,6 +1154,7 @@ public:
                                         {Context.Int32Ty, Context.Int32Ty},
                                         false)),
             {Builder.getInt32(Instr.getTargetIndex()), Diff}));
+        reloadMemoryBase();
         break;
       }
       case OpCode::Memory__init: {
@@ -3056,30 +3134,114 @@ public:
       return;
     };
     for (const auto &Instr : Instrs) {
-      // Update instruction count
-      if (LocalInstrCount) {
-        Builder.CreateStore(
-            Builder.CreateAdd(
-                Builder.CreateLoad(Context.Int64Ty, LocalInstrCount),
-                Builder.getInt64(1)),
-            LocalInstrCount);
-      }
-      if (LocalGas) {
-        auto *NewGas = Builder.CreateAdd(
-            Builder.CreateLoad(Context.Int64Ty, LocalGas),
-            Builder.CreateLoad(
-                Context.Int64Ty,
-                Builder.CreateConstInBoundsGEP2_64(
-                    llvm::ArrayType::get(Context.Int64Ty, UINT16_MAX + 1),
-                    Context.getCostTable(Builder, ExecCtx), 0,
-                    uint16_t(Instr.getOpCode()))));
-        Builder.CreateStore(NewGas, LocalGas);
+      // Update instruction count and gas. The counts of the straight-line
+      // instructions are folded, and added at once before the next
+      // instruction which may branch or trap.
+      countInstr(Instr);
+      if (!isStraightLine(Instr.getOpCode())) {
+        flushCounts();
       }
 
       // Make the instruction node according to Code.
       Dispatch(Instr);
     }
   }
+  void countInstr(const AST::Instruction &Instr) {
+    const OpCode Code = Instr.getOpCode();
+    if (LocalInstrCount) {
+      ++PendingInstrCount;
+    }
+    if (InstrumentedIdx) {
+      if (PendingBlockInstrs++ == 0) {
+        PendingBlockOffset = Instr.getOffset();
+      }
+      const auto Index = static_cast<uint16_t>(Code);
+      auto Iter = std::find_if(
+          PendingOpCodes.begin(), PendingOpCodes.end(),
+          [Index](const auto &Count) { return Count.first == Index; });
+      if (Iter == PendingOpCodes.end()) {
+        PendingOpCodes.emplace_back(Index, 1);
+      } else {
+        ++Iter->second;
+      }
+    }
+    if (LocalGas) {
+      const auto Index = static_cast<uint16_t>(Code);
+      auto Iter = std::find_if(
+          PendingCost.begin(), PendingCost.end(),
+          [Index](const auto &Cost) { return Cost.first == Index; });
+      if (Iter == PendingCost.end()) {
+        PendingCost.emplace_back(Index, 1);
+      } else {
+        ++Iter->second;
+      }
+    }
+  }
+  void flushCounts() {
+    if (PendingInstrCount > 0) {
+      Builder.CreateStore(
+          Builder.CreateAdd(
+              Builder.CreateLoad(Context.Int64Ty, LocalInstrCount),
+              Builder.getInt64(PendingInstrCount)),
+          LocalInstrCount);
+      PendingInstrCount = 0;
+    }
+    if (!PendingCost.empty()) {
+      llvm::Value *NewGas = Builder.CreateLoad(Context.Int64Ty, LocalGas);
+      for (const auto &[Index, Count] : PendingCost) {
+        llvm::Value *Cost = Builder.CreateLoad(
+            Context.Int64Ty,
+            Builder.CreateConstInBoundsGEP2_64(
+                llvm::ArrayType::get(Context.Int64Ty, UINT16_MAX + 1),
+                Context.getCostTable(Builder, ExecCtx), 0, Index));
+        if (Count > 1) {
+          Cost = Builder.CreateMul(Cost, Builder.getInt64(Count));
+        }
+        NewGas = Builder.CreateAdd(NewGas, Cost);
+      }
+      Builder.CreateStore(NewGas, LocalGas);
+      PendingCost.clear();
+    }
+    if (PendingBlockInstrs > 0) {
+      // The dead code following a branch is never executed.
+      if (!isUnreachable()) {
+        profileBlock();
+      }
+      PendingOpCodes.clear();
+      PendingBlockInstrs = 0;
+    }
+  }
+  /// Count the pending instructions as an executed basic block into the
+  /// profiler, if the executor runs with an instrumenting one.
+  void profileBlock() {
+    auto *ProfBB = llvm::BasicBlock::Create(LLContext, "profile", F);
+    auto *EndBB = llvm::BasicBlock::Create(LLContext, "profile.end", F);
+    auto *Counts = Context.getOpCodeCounts(Builder, ExecCtx);
+    Builder.CreateCondBr(Builder.CreateIsNull(Counts), EndBB, ProfBB);
+    Builder.SetInsertPoint(ProfBB);
+    for (const auto &[Index, Count] : PendingOpCodes) {
+      Builder.CreateAtomicRMW(
+          llvm::AtomicRMWInst::BinOp::Add,
+          Builder.CreateConstInBoundsGEP1_64(Context.Int64Ty, Counts, Index),
+          Builder.getInt64(Count),
+#if LLVM_VERSION_MAJOR >= 13
+          llvm::MaybeAlign(8),
+#endif
+          llvm::AtomicOrdering::Monotonic);
+    }
+    Builder.CreateCall(
+        Context.getIntrinsic(Builder, AST::Module::Intrinsics::kProfileBlock,
+                             llvm::FunctionType::get(
+                                 Context.VoidTy,
+                                 {Context.Int32Ty, Context.Int32Ty,
+                                  Context.Int32Ty},
+                                 false)),
+        {Builder.getInt32(*InstrumentedIdx),
+         Builder.getInt32(PendingBlockOffset),
+         Builder.getInt32(PendingBlockInstrs)});
+    Builder.CreateBr(EndBB);
+    Builder.SetInsertPoint(EndBB);
+  }
   void compileSignedTrunc(llvm::IntegerType *IntType) {
     const auto MinInt = llvm::APInt::getSignedMinValue(IntType->getBitWidth());
     const auto MaxInt = llvm::APInt::getSignedMaxValue(IntType->getBitWidth());
@@ -3284,12 +3446,11 @@ public:
 
     auto *Offset = Builder.CreateZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
-      Offset = Builder.CreateAdd(Offset, Builder.getInt64(MemoryOffset));
+      Offset = Builder.CreateNUWAdd(Offset, Builder.getInt64(MemoryOffset));
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
-        Offset);
+        Context.Int8Ty, getMemory(MemoryIndex), Offset);
 
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
     auto *Load = Builder.CreateLoad(TargetType, Ptr, OptNone);
@@ -3315,12 +3476,11 @@ public:
     }
     auto *Offset = Builder.CreateZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
-      Offset = Builder.CreateAdd(Offset, Builder.getInt64(MemoryOffset));
+      Offset = Builder.CreateNUWAdd(Offset, Builder.getInt64(MemoryOffset));
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
-        Offset);
+        Context.Int8Ty, getMemory(MemoryIndex), Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
     auto *Store = Builder.CreateStore(V, Ptr, OptNone);
     Store->setAlignment(Align(UINT64_C(1) << Alignment));
@@ -3335,12 +3495,11 @@ public:
     auto *Value = Builder.CreateSExtOrTrunc(stackPop(), TargetType);
     auto *Offset = Builder.CreateZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
-      Offset = Builder.CreateAdd(Offset, Builder.getInt64(MemoryOffset));
+      Offset = Builder.CreateNUWAdd(Offset, Builder.getInt64(MemoryOffset));
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
-        Offset);
+        Context.Int8Ty, getMemory(MemoryIndex), Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
 
     Stack.back() =
@@ -3366,12 +3525,11 @@ public:
     auto *Expected = Builder.CreateSExtOrTrunc(stackPop(), TargetType);
     auto *Offset = Builder.CreateZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
-      Offset = Builder.CreateAdd(Offset, Builder.getInt64(MemoryOffset));
+      Offset = Builder.CreateNUWAdd(Offset, Builder.getInt64(MemoryOffset));
     }
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
-        Offset);
+        Context.Int8Ty, getMemory(MemoryIndex), Offset);
     auto *Ptr = Builder.CreateBitCast(VPtr, TargetType->getPointerTo());
 
     auto *Ret = Builder.CreateAtomicCmpXchg(
@@ -3495,6 +3653,7 @@ private:
     }
 
     auto *Ret = Builder.CreateCall(Function, Args);
+    reloadMemoryBase();
     auto *Ty = Ret->getType();
     if (Ty->isVoidTy()) {
       // nothing to do
@@ -3627,6 +3786,7 @@ private:
       PHIRet->addIncoming(RetsVec[I], IsNullBB);
       stackPush(PHIRet);
     }
+    reloadMemoryBase();
   }
 
   void compileReturnCallOp(const unsigned int FuncIndex) {
@@ -3757,6 +3917,22 @@ private:
     }
   }
 
+  /// The base of memory 0 is kept in a local, which is reloaded only after the
+  /// calls and `memory.grow`. The stores into the memory may alias the array
+  /// of memory bases, so the base would be loaded again for every access.
+  llvm::Value *getMemory(unsigned MemoryIndex) {
+    if (MemoryIndex == 0 && LocalMemBase) {
+      return Builder.CreateLoad(Context.Int8PtrTy, LocalMemBase);
+    }
+    return Context.getMemory(Builder, ExecCtx, MemoryIndex);
+  }
+  void reloadMemoryBase() {
+    if (LocalMemBase) {
+      Builder.CreateStore(Context.getMemory(Builder, ExecCtx, 0),
+                          LocalMemBase);
+    }
+  }
+
   void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
                      llvm::Type *LoadTy) {
     if constexpr (kForceUnalignment) {
@@ -3764,11 +3940,11 @@ private:
     }
     auto *Off = Builder.CreateZExt(stackPop(), Context.Int64Ty);
     if (Offset != 0) {
-      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
+      Off = Builder.CreateNUWAdd(Off, Builder.getInt64(Offset));
     }
 
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
+        Context.Int8Ty, getMemory(MemoryIndex), Off);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *LoadInst = Builder.CreateLoad(LoadTy, Ptr, OptNone);
     LoadInst->setAlignment(Align(UINT64_C(1) << Alignment));
@@ -3828,7 +4004,7 @@ private:
     auto *V = stackPop();
     auto *Off = Builder.CreateZExt(stackPop(), Context.Int64Ty);
     if (Offset != 0) {
-      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
+      Off = Builder.CreateNUWAdd(Off, Builder.getInt64(Offset));
     }
 
     if (Trunc) {
@@ -3838,7 +4014,7 @@ private:
       V = Builder.CreateBitCast(V, LoadTy);
     }
     auto *VPtr = Builder.CreateInBoundsGEP(
-        Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
+        Context.Int8Ty, getMemory(MemoryIndex), Off);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *StoreInst = Builder.CreateStore(V, Ptr, OptNone);
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
@@ -4518,17 +4694,25 @@ private:
       return;
     }
     auto *NotStopBB = llvm::BasicBlock::Create(LLContext, "NotStop", F);
-    auto *StopToken = Builder.CreateAtomicRMW(
-        llvm::AtomicRMWInst::BinOp::Xchg,
-        Context.getStopToken(Builder, ExecCtx), Builder.getInt32(0),
-#if LLVM_VERSION_MAJOR >= 13
-        llvm::MaybeAlign(4),
-#endif
-        llvm::AtomicOrdering::Monotonic);
+    auto *StopBB = llvm::BasicBlock::Create(LLContext, "Stop", F);
+    // Poll the stop token with a relaxed load, which is a plain load on the
+    // common targets. The token is only consumed when it is set.
+    auto *StopTokenPtr = Context.getStopToken(Builder, ExecCtx);
+    auto *StopToken = Builder.CreateLoad(Context.Int32Ty, StopTokenPtr);
+    StopToken->setAlignment(Align(4));
+    StopToken->setAtomic(llvm::AtomicOrdering::Monotonic);
     auto *NotStop = createLikely(
         Builder, Builder.CreateICmpEQ(StopToken, Builder.getInt32(0)));
-    Builder.CreateCondBr(NotStop, NotStopBB,
-                         getTrapBB(ErrCode::Value::Interrupted));
+    Builder.CreateCondBr(NotStop, NotStopBB, StopBB);
+
+    Builder.SetInsertPoint(StopBB);
+    Builder.CreateAtomicRMW(llvm::AtomicRMWInst::BinOp::Xchg, StopTokenPtr,
+                            Builder.getInt32(0),
+#if LLVM_VERSION_MAJOR >= 13
+                            llvm::MaybeAlign(4),
+#endif
+                            llvm::AtomicOrdering::Monotonic);
+    Builder.CreateBr(getTrapBB(ErrCode::Value::Interrupted));
 
     Builder.SetInsertPoint(NotStopBB);
   }
@@ -4614,16 +4798,58 @@ private:
     return Value;
   }
 
+  /// Attach the branch weights recorded at the instruction at \p Offset. The
+  /// default label of a switch is its first successor, but the last target
+  /// of the profile.
+  void setBranchWeights(llvm::Instruction *Branch, uint32_t Offset,
+                        bool IsSwitch) {
+    if (!Profile) {
+      return;
+    }
+    const auto Iter = Profile->Branches.find(Offset);
+    if (Iter == Profile->Branches.end() ||
+        Iter->second.size() != Branch->getNumSuccessors()) {
+      return;
+    }
+    std::vector<uint64_t> Counts = Iter->second;
+    if (IsSwitch) {
+      std::rotate(Counts.rbegin(), Counts.rbegin() + 1, Counts.rend());
+    }
+    // Scale the counts down to fit the 32-bit weights.
+    const uint64_t Max = *std::max_element(Counts.begin(), Counts.end());
+    uint32_t Shift = 0;
+    while ((Max >> Shift) > std::numeric_limits<uint32_t>::max()) {
+      ++Shift;
+    }
+    std::vector<uint32_t> Weights;
+    Weights.reserve(Counts.size());
+    for (const uint64_t Count : Counts) {
+      Weights.push_back(static_cast<uint32_t>(Count >> Shift));
+    }
+    llvm::MDBuilder MDB(LLContext);
+    Branch->setMetadata(llvm::LLVMContext::MD_prof,
+                        MDB.createBranchWeights(Weights));
+  }
+
   AOT::Compiler::CompileContext &Context;
   llvm::LLVMContext &LLContext;
   std::vector<std::pair<llvm::Type *, llvm::Value *>> Local;
   std::vector<llvm::Value *> Stack;
   llvm::Value *LocalInstrCount = nullptr;
   llvm::Value *LocalGas = nullptr;
+  uint64_t PendingInstrCount = 0;
+  std::vector<std::pair<uint16_t, uint64_t>> PendingCost;
+  uint32_t PendingBlockOffset = 0;
+  uint32_t PendingBlockInstrs = 0;
+  std::vector<std::pair<uint16_t, uint64_t>> PendingOpCodes;
+  llvm::Value *LocalMemBase = nullptr;
   std::unordered_map<ErrCode::Value, llvm::BasicBlock *> TrapBB;
   bool IsUnreachable = false;
   bool Interruptible = false;
   bool OptNone = false;
+  const PGO::FunctionProfile *Profile = nullptr;
+  /// Index of the function to count into the instrumenting profiler.
+  std::optional<uint32_t> InstrumentedIdx;
   struct Control {
     size_t StackSize;
     llvm::BasicBlock *JumpBlock;
@@ -4669,6 +4895,201 @@ static llvm::Value *createLikely(llvm::IRBuilder<> &Builder,
                                        Builder.getTrue());
 }
 
+// Whether the instruction neither branches nor traps in the compiled code.
+// The out of bounds memory accesses are caught by the guard pages instead.
+static bool isStraightLine(OpCode Code) {
+  switch (Code) {
+  case OpCode::I32__div_s:
+  case OpCode::I32__div_u:
+  case OpCode::I32__rem_s:
+  case OpCode::I32__rem_u:
+  case OpCode::I64__div_s:
+  case OpCode::I64__div_u:
+  case OpCode::I64__rem_s:
+  case OpCode::I64__rem_u:
+  case OpCode::I32__trunc_f32_s:
+  case OpCode::I32__trunc_f32_u:
+  case OpCode::I32__trunc_f64_s:
+  case OpCode::I32__trunc_f64_u:
+  case OpCode::I64__trunc_f32_s:
+  case OpCode::I64__trunc_f32_u:
+  case OpCode::I64__trunc_f64_s:
+  case OpCode::I64__trunc_f64_u:
+    return false;
+  default:
+    break;
+  }
+  return Code == OpCode::Nop ||
+         (Code >= OpCode::Drop && Code <= OpCode::Global__set) ||
+         (Code >= OpCode::I32__load && Code <= OpCode::I64__store32) ||
+         (Code >= OpCode::I32__const && Code <= OpCode::I64__extend32_s) ||
+         (Code >= OpCode::I32__trunc_sat_f32_s &&
+          Code <= OpCode::I64__trunc_sat_f64_u) ||
+         (Code >= OpCode::V128__load && Code < OpCode::Memory__atomic__notify);
+}
+
+/// Check if the instruction only works on the values of its function, without
+/// the state of the module instance.
+static bool isInstanceFree(OpCode Code) {
+  switch (Code) {
+  case OpCode::Call_indirect:
+  case OpCode::Return_call_indirect:
+  case OpCode::Ref__func:
+  case OpCode::Global__get:
+  case OpCode::Global__set:
+  case OpCode::Table__get:
+  case OpCode::Table__set:
+  case OpCode::V128__load32_zero:
+  case OpCode::V128__load64_zero:
+    return false;
+  default:
+    break;
+  }
+  return !(Code >= OpCode::I32__load && Code <= OpCode::Memory__grow) &&
+         !(Code >= OpCode::Memory__init && Code <= OpCode::Table__fill) &&
+         !(Code >= OpCode::V128__load && Code <= OpCode::V128__store) &&
+         !(Code >= OpCode::V128__load8_lane &&
+           Code <= OpCode::V128__store64_lane) &&
+         Code < OpCode::Memory__atomic__notify;
+}
+
+/// Copy the exported function \p Name of a linked module into the compiled
+/// module, with the functions it calls. The copies run with the instance of
+/// the importing module, so only the functions which do not touch the state
+/// of their instance can be copied. Return null if the function does not
+/// qualify.
+llvm::Function *linkFunction(AOT::Compiler::CompileContext &Context,
+                             const Configure &Conf, const AST::Module &Linked,
+                             std::string_view Name,
+                             const AST::FunctionType &Type) {
+  const auto &Imports = Linked.getImportSection().getContent();
+  const auto ImportCount = static_cast<uint32_t>(
+      std::count_if(Imports.begin(), Imports.end(), [](const auto &ImpDesc) {
+        return ImpDesc.getExternalType() == ExternalType::Function;
+      }));
+  const auto &Types = Linked.getTypeSection().getContent();
+  const auto &TypeIdxs = Linked.getFunctionSection().getContent();
+  const auto &Codes = Linked.getCodeSection().getContent();
+  const auto DefinedCount =
+      static_cast<uint32_t>(std::min(TypeIdxs.size(), Codes.size()));
+  auto IsDefined = [&](uint32_t Index) {
+    return Index >= ImportCount && Index - ImportCount < DefinedCount;
+  };
+
+  std::optional<uint32_t> Root;
+  for (const auto &ExpDesc : Linked.getExportSection().getContent()) {
+    if (ExpDesc.getExternalType() == ExternalType::Function &&
+        ExpDesc.getExternalName() == Name) {
+      Root = ExpDesc.getExternalIndex();
+      break;
+    }
+  }
+  if (!Root || !IsDefined(*Root) ||
+      !(Types[TypeIdxs[*Root - ImportCount]] == Type)) {
+    return nullptr;
+  }
+
+  // Collect the functions called from the exported one.
+  std::vector<uint32_t> Reachable = {*Root};
+  std::vector<bool> Visited(ImportCount + DefinedCount);
+  Visited[*Root] = true;
+  for (size_t I = 0; I < Reachable.size(); ++I) {
+    const auto &Seg = Codes[Reachable[I] - ImportCount];
+    for (const auto &Instr : Seg.getExpr().getInstrs()) {
+      const auto Code = Instr.getOpCode();
+      if (!isInstanceFree(Code)) {
+        return nullptr;
+      }
+      if (Code == OpCode::Call || Code == OpCode::Return_call) {
+        const uint32_t Callee = Instr.getTargetIndex();
+        if (!IsDefined(Callee)) {
+          return nullptr;
+        }
+        if (!Visited[Callee]) {
+          Visited[Callee] = true;
+          Reachable.push_back(Callee);
+        }
+      }
+    }
+  }
+
+  // The index spaces of the linked module, with the copies.
+  std::vector<const AST::FunctionType *> LinkedTypes;
+  LinkedTypes.reserve(Types.size());
+  for (const auto &FuncType : Types) {
+    LinkedTypes.push_back(&FuncType);
+  }
+  std::vector<std::tuple<uint32_t, llvm::Function *,
+                         const WasmEdge::AST::CodeSegment *>>
+      LinkedFunctions(ImportCount + DefinedCount);
+  std::vector<uint32_t> Pending;
+  for (const uint32_t Index : Reachable) {
+    const uint32_t TypeIdx = TypeIdxs[Index - ImportCount];
+    auto &Copy = Context.LinkedFunctions[{&Linked, Index}];
+    if (Copy == nullptr) {
+      auto *FTy = toLLVMType(Context.ExecCtxPtrTy, Types[TypeIdx]);
+      Copy = llvm::Function::Create(FTy, llvm::Function::PrivateLinkage,
+                                    "l" + std::to_string(Index),
+                                    Context.LLModule);
+      Copy->addFnAttr(llvm::Attribute::StrictFP);
+      Copy->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
+      Copy->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+      Pending.push_back(Index);
+    }
+    LinkedFunctions[Index] = {TypeIdx, Copy, &Codes[Index - ImportCount]};
+  }
+
+  std::swap(Context.FunctionTypes, LinkedTypes);
+  std::swap(Context.Functions, LinkedFunctions);
+  const uint32_t MemoryCount = std::exchange(Context.MemoryCount, 0);
+  for (const uint32_t Index : Pending) {
+    auto [T, F, Code] = Context.Functions[Index];
+    std::vector<ValType> Locals;
+    for (const auto &Local : Code->getLocals()) {
+      for (unsigned I = 0; I < Local.first; ++I) {
+        Locals.push_back(Local.second);
+      }
+    }
+    // The copies have no function instance of their own to be profiled.
+    FunctionCompiler FC(Context, F, Locals,
+                        Conf.getCompilerConfigure().isInterruptible(),
+                        Conf.getStatisticsConfigure().isInstructionCounting(),
+                        Conf.getStatisticsConfigure().isCostMeasuring(),
+                        Conf.getCompilerConfigure().getOptimizationLevel() ==
+                            CompilerConfigure::OptimizationLevel::O0,
+                        nullptr, std::nullopt);
+    FC.compile(*Code, Context.resolveBlockType(T));
+    llvm::EliminateUnreachableBlocks(*F);
+  }
+  std::swap(Context.FunctionTypes, LinkedTypes);
+  std::swap(Context.Functions, LinkedFunctions);
+  Context.MemoryCount = MemoryCount;
+  return Context.LinkedFunctions[{&Linked, *Root}];
+}
+
+/// Set the profile summary of the module from the workload profile, so that
+/// the optimizations tell the hot and the cold functions apart.
+void setProfileSummary(llvm::Module &LLModule,
+                       const PGO::ModuleProfile &Profile) {
+  llvm::InstrProfSummaryBuilder Builder(
+      llvm::ProfileSummaryBuilder::DefaultCutoffs.vec());
+  for (const auto &[Index, Func] : Profile.Functions) {
+    // The first count is taken as the entry count.
+    std::vector<uint64_t> Counts{Func.EntryCount};
+    for (const auto &[Offset, Targets] : Func.Branches) {
+      Counts.insert(Counts.end(), Targets.begin(), Targets.end());
+    }
+    Builder.addRecord(llvm::InstrProfRecord(std::move(Counts)));
+  }
+  auto Summary = Builder.getSummary();
+#if LLVM_VERSION_MAJOR >= 10
+  LLModule.setProfileSummary(Summary->getMD(LLModule.getContext()),
+                             llvm::ProfileSummary::PSK_Instr);
+#else
+  LLModule.setProfileSummary(Summary->getMD(LLModule.getContext()));
+#endif
+}
+
 // Write output object and link
 Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
                                  const llvm::SmallString<0> &OSVec) {
@@ -4796,11 +5217,283 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
   return {};
 }
 
-Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
-                               Span<const Byte> Data,
-                               const llvm::SmallString<0> &OSVec) {
-  using namespace std::literals;
+/// Loadable image of the compiled code, with the addresses of the exported
+/// symbols and the sections. The kinds of the sections are 1 for the text, 2
+/// for the data and 3 for the BSS.
+struct AOTImage {
+  std::vector<std::pair<std::string, uint64_t>> Symbols;
+  std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::string>> Sections;
+};
+
+/// Alignment of the text contents in the universal wasm file, relative to
+/// their addresses, for the loader to map them from the file. It covers the
+/// page sizes of the supported systems.
+static inline constexpr const uint64_t kFileAlignment = UINT64_C(65536);
+
+/// Merge the text sections sharing pages into one, since the loader maps the
+/// text from the file by pages.
+void mergeTextSections(AOTImage &Image) {
+  std::sort(Image.Sections.begin(), Image.Sections.end(),
+            [](const auto &LHS, const auto &RHS) {
+              return std::get<1>(LHS) < std::get<1>(RHS);
+            });
+  std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::string>> Sections;
+  for (auto &Section : Image.Sections) {
+    auto &[Kind, Address, Size, Content] = Section;
+    if (!Sections.empty() && Kind == UINT8_C(1) &&
+        std::get<0>(Sections.back()) == UINT8_C(1)) {
+      auto &[LastKind, LastAddress, LastSize, LastContent] = Sections.back();
+      const uint64_t LastEnd = LastAddress + LastSize;
+      if (llvm::alignTo(LastEnd, kFileAlignment) >
+              llvm::alignDown(Address, kFileAlignment) &&
+          LastEnd <= Address) {
+        LastContent.resize(Address - LastAddress, '\0');
+        LastContent += Content;
+        LastSize = Address + Size - LastAddress;
+        continue;
+      }
+    }
+    Sections.push_back(std::move(Section));
+  }
+  Image.Sections = std::move(Sections);
+}
+
+uint8_t sectionKind(const llvm::object::SectionRef &Section) noexcept {
+  if (Section.isText()) {
+    return UINT8_C(1);
+  } else if (Section.isData()) {
+    return UINT8_C(2);
+  } else if (Section.isBSS()) {
+    return UINT8_C(3);
+  }
+  return UINT8_C(0);
+}
+
+#if WASMEDGE_OS_LINUX && defined(__x86_64__)
+/// Lay out the sections of the relocatable object and apply its relocations
+/// in memory, which gives the same image as linking it into a shared library
+/// without the temporary files and the linker. The exported symbols are
+/// protected, so only the PC-relative relocations are expected. Return
+/// nothing for anything else, to fall back to the linker.
+std::optional<AOTImage> relocateObject(const llvm::SmallString<0> &OSVec) {
+  auto ObjOrErr =
+      llvm::object::ObjectFile::createObjectFile(llvm::MemoryBufferRef(
+          llvm::StringRef(OSVec.data(), OSVec.size()), "wasm"));
+  if (unlikely(!ObjOrErr)) {
+    llvm::consumeError(ObjOrErr.takeError());
+    return std::nullopt;
+  }
+  const auto &Obj = **ObjOrErr;
+  if (!Obj.isELF() || Obj.getArch() != llvm::Triple::x86_64) {
+    return std::nullopt;
+  }
+
+  // The text, the data and the BSS are placed in separated pages, since the
+  // loader changes the protection of the text pages.
+  constexpr uint64_t kPageSize = UINT64_C(65536);
+  AOTImage Image;
+  std::unordered_map<uint64_t, size_t> SectionIndex;
+  uint64_t Address = 0;
+  for (const uint8_t Kind : {UINT8_C(1), UINT8_C(2), UINT8_C(3)}) {
+    Address = llvm::alignTo(Address, kPageSize);
+    for (const auto &Section : Obj.sections()) {
+      if (sectionKind(Section) != Kind) {
+        continue;
+      }
+      const uint64_t Align = Section.getAlignment();
+      Address = llvm::alignTo(Address, std::max(Align, UINT64_C(1)));
+      std::string Content;
+      if (Kind != UINT8_C(3)) {
+        if (auto Res = Section.getContents(); unlikely(!Res)) {
+          llvm::consumeError(Res.takeError());
+          return std::nullopt;
+        } else {
+          Content.assign(Res->begin(), Res->end());
+        }
+      }
+      SectionIndex.emplace(Section.getIndex(), Image.Sections.size());
+      Image.Sections.emplace_back(Kind, Address, Section.getSize(),
+                                  std::move(Content));
+      Address += Section.getSize();
+    }
+  }
+
+  auto SymbolAddress =
+      [&](const llvm::object::SymbolRef &Symbol) -> std::optional<uint64_t> {
+    auto Section = Symbol.getSection();
+    if (unlikely(!Section)) {
+      llvm::consumeError(Section.takeError());
+      return std::nullopt;
+    }
+    if (*Section == Obj.section_end()) {
+      return std::nullopt;
+    }
+    const auto Iter = SectionIndex.find((*Section)->getIndex());
+    if (Iter == SectionIndex.end()) {
+      return std::nullopt;
+    }
+    auto Value = Symbol.getAddress();
+    if (unlikely(!Value)) {
+      llvm::consumeError(Value.takeError());
+      return std::nullopt;
+    }
+    return std::get<1>(Image.Sections[Iter->second]) + *Value;
+  };
+
+  for (const auto &RelocSection : Obj.sections()) {
+#if LLVM_VERSION_MAJOR >= 12
+    auto TargetOrErr = RelocSection.getRelocatedSection();
+    if (unlikely(!TargetOrErr)) {
+      llvm::consumeError(TargetOrErr.takeError());
+      return std::nullopt;
+    }
+    const auto Target = *TargetOrErr;
+#else
+    const auto Target = RelocSection.getRelocatedSection();
+#endif
+    if (Target == Obj.section_end()) {
+      continue;
+    }
+    // The relocations of the sections not loaded, such as the debug info.
+    const auto Iter = SectionIndex.find(Target->getIndex());
+    if (Iter == SectionIndex.end()) {
+      continue;
+    }
+    const uint64_t Base = std::get<1>(Image.Sections[Iter->second]);
+    auto &Content = std::get<3>(Image.Sections[Iter->second]);
+    for (const auto &Reloc : RelocSection.relocations()) {
+      const uint64_t Type = Reloc.getType();
+      if (Type == llvm::ELF::R_X86_64_NONE) {
+        continue;
+      }
+      const auto Symbol = Reloc.getSymbol();
+      if (Symbol == Obj.symbol_end()) {
+        return std::nullopt;
+      }
+      const auto S = SymbolAddress(*Symbol);
+      if (!S) {
+        return std::nullopt;
+      }
+      auto Addend = llvm::object::ELFRelocationRef(Reloc).getAddend();
+      if (unlikely(!Addend)) {
+        llvm::consumeError(Addend.takeError());
+        return std::nullopt;
+      }
+      const uint64_t Offset = Reloc.getOffset();
+      const uint64_t Value =
+          *S + static_cast<uint64_t>(*Addend) - (Base + Offset);
+      switch (Type) {
+      case llvm::ELF::R_X86_64_PC32:
+      case llvm::ELF::R_X86_64_PLT32: {
+        const auto Delta = static_cast<int64_t>(Value);
+        if (Delta < std::numeric_limits<int32_t>::min() ||
+            Delta > std::numeric_limits<int32_t>::max() ||
+            Offset + 4 > Content.size()) {
+          return std::nullopt;
+        }
+        llvm::support::endian::write32le(Content.data() + Offset,
+                                         static_cast<uint32_t>(Delta));
+        break;
+      }
+      case llvm::ELF::R_X86_64_PC64:
+        if (Offset + 8 > Content.size()) {
+          return std::nullopt;
+        }
+        llvm::support::endian::write64le(Content.data() + Offset, Value);
+        break;
+      default:
+        return std::nullopt;
+      }
+    }
+  }
+
+  for (const auto &Symbol : Obj.symbols()) {
+#if LLVM_VERSION_MAJOR >= 11
+    auto Flags = Symbol.getFlags();
+    if (unlikely(!Flags)) {
+      llvm::consumeError(Flags.takeError());
+      continue;
+    }
+    const bool IsGlobal = *Flags & llvm::object::SymbolRef::SF_Global;
+#else
+    const bool IsGlobal =
+        Symbol.getFlags() & llvm::object::SymbolRef::SF_Global;
+#endif
+    if (!IsGlobal) {
+      continue;
+    }
+    auto Name = Symbol.getName();
+    if (unlikely(!Name)) {
+      llvm::consumeError(Name.takeError());
+      continue;
+    }
+    if (Name->empty()) {
+      continue;
+    }
+    if (const auto Address = SymbolAddress(Symbol)) {
+      Image.Symbols.emplace_back(Name->str(), *Address);
+    }
+  }
+  return Image;
+}
+#endif
 
+/// Read the image from the shared library linked by outputNativeLibrary.
+AOTImage readLinkedImage(const llvm::object::ObjectFile &ObjFile) {
+  AOTImage Image;
+#if !WASMEDGE_OS_WINDOWS
+  for (auto &Symbol : ObjFile.symbols()) {
+    std::string Name;
+    if (auto Res = Symbol.getName(); unlikely(!Res)) {
+      continue;
+    } else if (Res->empty()) {
+      continue;
+    } else {
+      Name = std::move(*Res);
+    }
+    uint64_t Address = 0;
+    if (auto Res = Symbol.getAddress(); unlikely(!Res)) {
+      continue;
+    } else {
+      Address = *Res;
+    }
+    Image.Symbols.emplace_back(std::move(Name), std::move(Address));
+  }
+#else
+  for (auto &Symbol : llvm::cast<llvm::object::COFFObjectFile>(&ObjFile)
+                          ->export_directories()) {
+    llvm::StringRef Name;
+    if (auto Error = Symbol.getSymbolName(Name); unlikely(!!Error)) {
+      continue;
+    } else if (Name.empty()) {
+      continue;
+    }
+    uint32_t Offset = 0;
+    if (auto Error = Symbol.getExportRVA(Offset); unlikely(!!Error)) {
+      continue;
+    }
+    Image.Symbols.emplace_back(Name.str(), Offset);
+  }
+#endif
+
+  for (auto &Section : ObjFile.sections()) {
+    std::string Content;
+    if (auto Res = Section.getContents(); unlikely(!Res)) {
+      continue;
+    } else {
+      Content.assign(Res->begin(), Res->end());
+    }
+    if (const uint8_t Kind = sectionKind(Section); Kind != UINT8_C(0)) {
+      Image.Sections.emplace_back(Kind, Section.getAddress(),
+                                  Section.getSize(), std::move(Content));
+    }
+  }
+  return Image;
+}
+
+/// Link the object into a temporary shared library and read its image.
+Expect<AOTImage> linkImage(const std::filesystem::path &OutputPath,
+                           const llvm::SmallString<0> &OSVec) {
   std::string SharedObjectName;
   {
     // tempfile
@@ -4848,9 +5541,43 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
     ObjFile = std::move(*Res);
   }
 
-  llvm::SmallString<0> OSCustomSecVec;
-  {
-    llvm::raw_svector_ostream OS(OSCustomSecVec);
+  AOTImage Image = readLinkedImage(*ObjFile);
+  ObjFile.reset();
+  SOFile.reset();
+  llvm::sys::fs::remove(SharedObjectName);
+  return Image;
+}
+
+Expect<void>
+outputWasmLibrary(const std::filesystem::path &OutputPath,
+                  Span<const Byte> Data,
+                  Span<const WasmEdge::AOT::Compiler::TargetObject> Targets) {
+  using namespace std::literals;
+
+  // One AOT section for each target, for the loader to select. Each custom
+  // section is written with a section id and a 5-byte size, so the file
+  // offsets of the contents are known here.
+  std::vector<llvm::SmallString<0>> OSCustomSecVecs;
+  uint64_t FileOffset = Data.size();
+  for (const auto &Target : Targets) {
+    AOTImage Image;
+#if WASMEDGE_OS_LINUX && defined(__x86_64__)
+    if (auto Res = relocateObject(Target.Code)) {
+      Image = std::move(*Res);
+    } else
+#endif
+    {
+      if (auto Res = linkImage(OutputPath, Target.Code); unlikely(!Res)) {
+        return Unexpect(Res);
+      } else {
+        Image = std::move(*Res);
+      }
+    }
+
+    mergeTextSections(Image);
+
+    llvm::raw_svector_ostream OS(OSCustomSecVecs.emplace_back());
+    FileOffset += 6;
 
     WriteName(OS, "wasmedge"sv);
     WriteU32(OS, WasmEdge::AOT::kBinaryVersion);
@@ -4873,46 +5600,22 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
 #error Unsupported hardware architecture!
 #endif
 
-    std::vector<std::pair<std::string, uint64_t>> SymbolTable;
-#if !WASMEDGE_OS_WINDOWS
-    for (auto &Symbol : ObjFile->symbols()) {
-      std::string Name;
-      if (auto Res = Symbol.getName(); unlikely(!Res)) {
-        continue;
-      } else if (Res->empty()) {
-        continue;
-      } else {
-        Name = std::move(*Res);
-      }
-      uint64_t Address = 0;
-      if (auto Res = Symbol.getAddress(); unlikely(!Res)) {
-        continue;
-      } else {
-        Address = *Res;
-      }
-      SymbolTable.emplace_back(std::move(Name), std::move(Address));
+    WriteU32(OS, static_cast<uint32_t>(Target.Features.size()));
+    for (const auto &Feature : Target.Features) {
+      WriteName(OS, Feature);
     }
-#else
-    for (auto &Symbol : llvm::cast<llvm::object::COFFObjectFile>(ObjFile.get())
-                            ->export_directories()) {
-      llvm::StringRef Name;
-      if (auto Error = Symbol.getSymbolName(Name); unlikely(!!Error)) {
-        continue;
-      } else if (Name.empty()) {
-        continue;
-      }
-      uint32_t Offset = 0;
-      if (auto Error = Symbol.getExportRVA(Offset); unlikely(!!Error)) {
-        continue;
-      }
-      SymbolTable.emplace_back(Name.str(), Offset);
+
+    WriteU32(OS, static_cast<uint32_t>(Target.LinkedModules.size()));
+    for (const auto &[Name, Hash] : Target.LinkedModules) {
+      WriteName(OS, Name);
+      WriteU64(OS, Hash);
     }
-#endif
+
     uint64_t VersionAddress = 0, IntrinsicsAddress = 0;
     std::vector<uint64_t> Types;
     std::vector<uint64_t> Codes;
     uint64_t CodesMin = std::numeric_limits<uint64_t>::max();
-    for (const auto &[Name, Address] : SymbolTable) {
+    for (const auto &[Name, Address] : Image.Symbols) {
       if (Name == SYMBOL("version"sv)) {
         VersionAddress = Address;
       } else if (Name == SYMBOL("intrinsics"sv)) {
@@ -4951,56 +5654,61 @@ Expect<void> outputWasmLibrary(const std::filesystem::path &OutputPath,
       WriteU64(OS, CodeAddress);
     }
 
-    uint32_t SectionCount = 0;
-    for (auto &Section : ObjFile->sections()) {
-      if (auto Res = Section.getContents(); unlikely(!Res)) {
-        continue;
-      }
-      if (!Section.isText() && !Section.isData() && !Section.isBSS()) {
-        continue;
-      }
-      ++SectionCount;
-    }
-    WriteU32(OS, SectionCount);
-
-    for (auto &Section : ObjFile->sections()) {
-      const uint64_t Address = Section.getAddress();
-      const uint64_t Size = Section.getSize();
-      std::vector<char> Content;
-      if (auto Res = Section.getContents(); unlikely(!Res)) {
-        continue;
-      } else {
-        Content.assign(Res->begin(), Res->end());
-      }
-      if (Section.isText()) {
-        WriteByte(OS, UINT8_C(1));
-      } else if (Section.isData()) {
-        WriteByte(OS, UINT8_C(2));
-      } else if (Section.isBSS()) {
-        WriteByte(OS, UINT8_C(3));
-      } else {
-        continue;
-      }
+    WriteU32(OS, static_cast<uint32_t>(Image.Sections.size()));
+    for (const auto &[Kind, Address, Size, Content] : Image.Sections) {
+      WriteByte(OS, Kind);
       WriteU64(OS, Address);
       WriteU64(OS, Size);
-      WriteName(OS, std::string_view(Content.data(), Content.size()));
+      // Pad the text content to the same offset in a page as its address.
+      uint64_t Padding = 0;
+      if (Kind == UINT8_C(1)) {
+        const uint64_t ContentOffset = FileOffset + OS.tell() + 5 +
+                                       llvm::getULEB128Size(Content.size());
+        Padding = (Address - ContentOffset) & (kFileAlignment - 1);
+      }
+      WriteU32Fixed(OS, static_cast<uint32_t>(Padding));
+      OS.write_zeros(static_cast<unsigned>(Padding));
+      WriteName(OS, Content);
     }
+    FileOffset += OSCustomSecVecs.back().size();
   }
 
   spdlog::info("output start");
 
-  std::error_code EC;
-  llvm::raw_fd_ostream OS(OutputPath.u8string(), EC);
-  if (EC) {
-    spdlog::error("output failed:{}", EC.message());
+  // The loader maps the text sections from the output file, so it is written
+  // aside and renamed over the target, instead of truncating a file which may
+  // still be mapped by a running instance. The mode is given explicitly, as
+  // the kept file is readable by others like a file written in place.
+  auto Output = llvm::sys::fs::TempFile::create(
+      OutputPath.u8string() + ".%%%%%%%%%%",
+      llvm::sys::fs::all_read | llvm::sys::fs::owner_write);
+  if (!Output) {
+    spdlog::error("output failed:{}", llvm::toString(Output.takeError()));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  {
+    llvm::raw_fd_ostream OS(Output->FD, false);
+    OS.write(reinterpret_cast<const char *>(Data.data()), Data.size());
+    for (const auto &OSCustomSecVec : OSCustomSecVecs) {
+      // Custom section id
+      WriteByte(OS, UINT8_C(0x00));
+      WriteU32Fixed(OS, static_cast<uint32_t>(OSCustomSecVec.size()));
+      OS.write(OSCustomSecVec.data(), OSCustomSecVec.size());
+    }
+    OS.flush();
+    if (OS.has_error()) {
+      spdlog::error("output failed:{}", OS.error().message());
+      OS.clear_error();
+      llvm::consumeError(Output->discard());
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+  if (auto Err = Output->keep(OutputPath.u8string())) {
+    spdlog::error("output failed:{}", llvm::toString(std::move(Err)));
+    llvm::consumeError(Output->discard());
     return Unexpect(ErrCode::Value::IllegalPath);
   }
-  OS.write(reinterpret_cast<const char *>(Data.data()), Data.size());
-  // Custom section id
-  WriteByte(OS, UINT8_C(0x00));
-  WriteName(OS, std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
 
-  llvm::sys::fs::remove(SharedObjectName);
   return {};
 }
 
@@ -5017,9 +5725,88 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
     return Unexpect(ErrCode::Value::NotValidated);
   }
 
+  std::unique_lock Lock(Mutex);
+  std::vector<std::string> CPUs = TargetCPUs;
+  if (CPUs.empty()) {
+    // Empty for the host CPU or the generic one.
+    CPUs.emplace_back();
+  }
+  if (CPUs.size() > 1 && Conf.getCompilerConfigure().getOutputFormat() ==
+                             CompilerConfigure::OutputFormat::Native) {
+    spdlog::error("multiple target cpus need the universal wasm format");
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  std::vector<TargetObject> Targets(CPUs.size());
+  for (size_t I = 0; I < CPUs.size(); ++I) {
+    if (auto Res = compile(Data, Module, OutputPath, CPUs[I], Targets[I]);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+  }
+
+  switch (Conf.getCompilerConfigure().getOutputFormat()) {
+  case CompilerConfigure::OutputFormat::Native:
+    // The native library has no section to record the linked modules in, for
+    // checking them at the instantiation.
+    if (unlikely(!Targets.front().LinkedModules.empty())) {
+      spdlog::error("linked modules need the universal wasm format");
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+    if (auto Res = outputNativeLibrary(OutputPath, Targets.front().Code);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  case CompilerConfigure::OutputFormat::Wasm:
+    if (auto Res = outputWasmLibrary(OutputPath, Data, Targets);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+    break;
+  }
+
+  return {};
+}
+
+Expect<std::filesystem::path>
+Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                  Cache::StorageScope Scope, std::string_view Key) {
+  auto Path = Cache::getPath(Data, Scope, Key);
+  if (unlikely(!Path)) {
+    return Unexpect(Path);
+  }
+  std::error_code EC;
+  if (std::filesystem::exists(*Path, EC)) {
+    return Path;
+  }
+  std::filesystem::create_directories(Path->parent_path(), EC);
+
+  // Compile aside in the same directory, so the entry is replaced atomically
+  // by the commit.
+  llvm::SmallString<128> Compiled;
+  llvm::sys::fs::createUniquePath(Path->u8string() + ".%%%%%%%%%%.tmp",
+                                  Compiled, false);
+  const auto CompiledPath = std::filesystem::u8path(Compiled.str().str());
+  if (auto Res = compile(Data, Module, CompiledPath); unlikely(!Res)) {
+    std::filesystem::remove(CompiledPath, EC);
+    return Unexpect(Res);
+  }
+  if (auto Res = Cache::commit(CompiledPath, *Path, Scope,
+                               Conf.getCompilerConfigure().getCacheSizeLimit());
+      unlikely(!Res)) {
+    std::filesystem::remove(CompiledPath, EC);
+    return Unexpect(Res);
+  }
+  return Path;
+}
+
+Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                               const std::filesystem::path &OutputPath,
+                               const std::string &TargetCPU,
+                               TargetObject &Target) {
   using namespace std::literals;
 
-  std::unique_lock Lock(Mutex);
   spdlog::info("compile start");
   std::filesystem::path LLPath(OutputPath);
   LLPath.replace_extension("ll"sv);
@@ -5036,7 +5823,31 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   LLModule.setPICLevel(llvm::PICLevel::Level::SmallPIC);
 #endif
   CompileContext NewContext(LLModule,
-                            Conf.getCompilerConfigure().isGenericBinary());
+                            Conf.getCompilerConfigure().isGenericBinary() ||
+                                !TargetCPU.empty());
+  if (!TargetCPU.empty()) {
+    // The code is generated for the baseline CPU with the features of the
+    // named CPU, instead of the host ones.
+    std::string Error;
+    const llvm::Target *TheTarget =
+        llvm::TargetRegistry::lookupTarget(LLModule.getTargetTriple(), Error);
+    std::unique_ptr<llvm::MCSubtargetInfo> STI;
+    if (TheTarget) {
+      STI.reset(TheTarget->createMCSubtargetInfo(LLModule.getTargetTriple(),
+                                                 TargetCPU, ""));
+    }
+    if (!STI || !STI->isCPUStringValid(TargetCPU)) {
+      spdlog::error("unknown target cpu:{}", TargetCPU);
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+    // Only the features known by the runtime detection are enabled, since the
+    // loader can not select the code requiring the others.
+    for (const auto Feature : CPU::knownFeatures()) {
+      if (STI->checkFeatures("+"s + std::string(Feature))) {
+        NewContext.addFeature({Feature.data(), Feature.size()}, true);
+      }
+    }
+  }
   struct RAIICleanup {
     RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
         : Context(Context) {
@@ -5062,6 +5873,9 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   // Compile ExportSection
   compile(Module.getExportSection());
   // StartSection is not required to compile
+  if (Profile) {
+    setProfileSummary(LLModule, *Profile);
+  }
 
   if (Conf.getCompilerConfigure().getOutputFormat() ==
       CompilerConfigure::OutputFormat::Native) {
@@ -5099,8 +5913,6 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   llvm::verifyModule(LLModule, &llvm::errs());
   spdlog::info("optimize start");
 
-  llvm::SmallString<0> OSVec;
-
   // optimize + codegen
   llvm::Triple Triple(LLModule.getTargetTriple());
   {
@@ -5115,8 +5927,17 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
 
     llvm::TargetOptions Options;
     llvm::Reloc::Model RM = llvm::Reloc::PIC_;
+    // A named target CPU is only used for tuning. Its features are in the
+    // feature string, and enabling the others by the CPU name would make the
+    // code require what the loader can not check.
     llvm::StringRef CPUName("generic");
-    if (!Conf.getCompilerConfigure().isGenericBinary()) {
+    if (!TargetCPU.empty()) {
+      for (auto &F : LLModule) {
+        if (!F.isDeclaration()) {
+          F.addFnAttr("tune-cpu", TargetCPU);
+        }
+      }
+    } else if (!Conf.getCompilerConfigure().isGenericBinary()) {
       CPUName = llvm::sys::getHostCPUName();
     }
     std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
@@ -5170,12 +5991,21 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
       MPM.run(LLModule, MAM);
     }
 
-    // Set initializer for constant value
-    if (auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics")) {
-      IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
-          llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
-      IntrinsicsTable->setConstant(false);
+    // Set initializer for constant value. The optimizations drop the table if
+    // no code calls an intrinsic, such as with only the linked copies of pure
+    // functions, but the loader always fills it in.
+    auto *IntrinsicsTable = LLModule.getNamedGlobal("intrinsics");
+    if (!IntrinsicsTable) {
+      IntrinsicsTable = new llvm::GlobalVariable(
+          LLModule, Context->IntrinsicsTablePtrTy->getPointerTo(), false,
+          llvm::GlobalVariable::ExternalLinkage, nullptr, "intrinsics");
+      IntrinsicsTable->setVisibility(llvm::GlobalValue::ProtectedVisibility);
+      IntrinsicsTable->setDLLStorageClass(
+          llvm::GlobalValue::DLLExportStorageClass);
     }
+    IntrinsicsTable->setInitializer(llvm::ConstantPointerNull::get(
+        llvm::cast<llvm::PointerType>(IntrinsicsTable->getValueType())));
+    IntrinsicsTable->setConstant(false);
 
     llvm::legacy::PassManager CodeGenPasses;
     CodeGenPasses.add(
@@ -5184,7 +6014,7 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
     // Add LibraryInfo.
     CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
 
-    llvm::raw_svector_ostream OS(OSVec);
+    llvm::raw_svector_ostream OS(Target.Code);
 #if LLVM_VERSION_MAJOR >= 10
     using llvm::CGFT_ObjectFile;
 #else
@@ -5207,19 +6037,16 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
     CodeGenPasses.run(LLModule);
   }
 
-  switch (Conf.getCompilerConfigure().getOutputFormat()) {
-  case CompilerConfigure::OutputFormat::Native:
-    if (auto Res = outputNativeLibrary(OutputPath, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
-    }
-    break;
-  case CompilerConfigure::OutputFormat::Wasm:
-    if (auto Res = outputWasmLibrary(OutputPath, Data, OSVec); unlikely(!Res)) {
-      return Unexpect(Res);
+  // Only record the features the loader can check on the running CPU. For a
+  // named target CPU, these are all the features of the feature string.
+  for (const auto &Feature : Context->SubtargetFeatures.getFeatures()) {
+    if (Feature.size() > 1 && Feature[0] == '+' &&
+        CPU::isKnownFeature(std::string_view(Feature).substr(1))) {
+      Target.Features.push_back(Feature.substr(1));
     }
-    break;
   }
-
+  Target.LinkedModules.assign(Context->LinkedHashes.begin(),
+                              Context->LinkedHashes.end());
   return {};
 }
 
@@ -5342,6 +6169,24 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       assuming(TypeIdx < Context->FunctionTypes.size());
       const auto &FuncType = *Context->FunctionTypes[TypeIdx];
 
+      // The functions of the linked modules are called directly, if they can
+      // be copied into this module.
+      llvm::Function *Copy = nullptr;
+      for (const auto &[Name, Linked] : LinkedModules) {
+        if (Name == ImpDesc.getModuleName()) {
+          Copy = linkFunction(*Context, Conf, *Linked,
+                              ImpDesc.getExternalName(), FuncType);
+          if (Copy != nullptr) {
+            Context->LinkedHashes.emplace(Name, Linked->getCodeHash());
+          }
+          break;
+        }
+      }
+      if (Copy != nullptr) {
+        Context->Functions.emplace_back(TypeIdx, Copy, nullptr);
+        break;
+      }
+
       auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
       auto *RTy = FTy->getReturnType();
       auto *F = llvm::Function::Create(FTy, llvm::Function::PrivateLinkage,
@@ -5379,6 +6224,70 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
         Rets = Alloca;
       }
 
+      // Host functions with a native entry are called directly, if the
+      // arguments and the result are all numbers. The entry is resolved at the
+      // instantiation, and the execution context has no entries while the
+      // host calls are timed.
+      const bool IsNumber = [&FuncType]() {
+        auto Check = [](const ValType &Type) {
+          return Type == ValType::I32 || Type == ValType::I64 ||
+                 Type == ValType::F32 || Type == ValType::F64;
+        };
+        const auto &Params = FuncType.getParamTypes();
+        const auto &Returns = FuncType.getReturnTypes();
+        return Returns.size() <= 1 &&
+               std::all_of(Params.begin(), Params.end(), Check) &&
+               std::all_of(Returns.begin(), Returns.end(), Check);
+      }();
+      if (IsNumber) {
+        auto *HostNativeTy = Context->HostNativeTy;
+        auto *Slots = Builder.CreateLoad(
+            HostNativeTy->getPointerTo(),
+            Builder.CreateStructGEP(Context->ExecCtxTy, F->arg_begin(), 8));
+        auto *SlotBB = llvm::BasicBlock::Create(Context->LLContext, "slot", F);
+        auto *NativeBB =
+            llvm::BasicBlock::Create(Context->LLContext, "native", F);
+        auto *ProxyBB =
+            llvm::BasicBlock::Create(Context->LLContext, "proxy", F);
+        Builder.CreateCondBr(
+            createLikely(Builder, Builder.CreateIsNotNull(Slots)), SlotBB,
+            ProxyBB);
+
+        Builder.SetInsertPoint(SlotBB);
+        auto *Slot = Builder.CreateConstInBoundsGEP1_64(HostNativeTy, Slots,
+                                                        FuncID);
+        auto *Native = Builder.CreateLoad(
+            Context->Int8PtrTy, Builder.CreateStructGEP(HostNativeTy, Slot, 0));
+        Builder.CreateCondBr(
+            createLikely(Builder, Builder.CreateIsNotNull(Native)), NativeBB,
+            ProxyBB);
+
+        Builder.SetInsertPoint(NativeBB);
+        auto *Self = Builder.CreateLoad(
+            Context->Int8PtrTy, Builder.CreateStructGEP(HostNativeTy, Slot, 1));
+        auto *FramePtr = Builder.CreateBitCast(
+            Builder.CreateStructGEP(HostNativeTy, Slot, 2), Context->Int8PtrTy);
+        std::vector<llvm::Type *> NativeParamTys = {Context->Int8PtrTy,
+                                                    Context->Int8PtrTy};
+        std::vector<llvm::Value *> NativeArgs = {Self, FramePtr};
+        for (unsigned I = 0; I < ArgSize; ++I) {
+          llvm::Argument *Arg = F->arg_begin() + 1 + I;
+          NativeParamTys.push_back(Arg->getType());
+          NativeArgs.push_back(Arg);
+        }
+        auto *NativeTy = llvm::FunctionType::get(RTy, NativeParamTys, false);
+        auto *Ret = Builder.CreateCall(
+            NativeTy, Builder.CreateBitCast(Native, NativeTy->getPointerTo()),
+            NativeArgs);
+        if (RetSize == 0) {
+          Builder.CreateRetVoid();
+        } else {
+          Builder.CreateRet(Ret);
+        }
+
+        Builder.SetInsertPoint(ProxyBB);
+      }
+
       for (unsigned I = 0; I < ArgSize; ++I) {
         llvm::Argument *Arg = F->arg_begin() + 1 + I;
         llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
@@ -5427,7 +6336,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
     }
     case ExternalType::Memory: // Memory type
     {
-      // Nothing to do.
+      ++Context->MemoryCount;
       break;
     }
     case ExternalType::Global: // Global type
@@ -5455,7 +6364,10 @@ void Compiler::compile(const AST::GlobalSection &GlobalSec) {
   }
 }
 
-void Compiler::compile(const AST::MemorySection &, const AST::DataSection &) {}
+void Compiler::compile(const AST::MemorySection &MemorySec,
+                       const AST::DataSection &) {
+  Context->MemoryCount += static_cast<uint32_t>(MemorySec.getContent().size());
+}
 
 void Compiler::compile(const AST::TableSection &, const AST::ElementSection &) {
 }
@@ -5485,10 +6397,23 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
     Context->Functions.emplace_back(TypeIdx, F, &Code);
   }
 
-  for (auto [T, F, Code] : Context->Functions) {
+  // The functions not in the profile were never executed.
+  const PGO::FunctionProfile Unexecuted{};
+  for (size_t I = 0; I < Context->Functions.size(); ++I) {
+    auto [T, F, Code] = Context->Functions[I];
     if (!Code) {
       continue;
     }
+    const PGO::FunctionProfile *FuncProfile = nullptr;
+    if (Profile) {
+      const auto Iter = Profile->Functions.find(static_cast<uint32_t>(I));
+      FuncProfile =
+          Iter != Profile->Functions.end() ? &Iter->second : &Unexecuted;
+    }
+    std::optional<uint32_t> InstrumentedIdx;
+    if (Conf.getCompilerConfigure().isInstrumentation()) {
+      InstrumentedIdx = static_cast<uint32_t>(I);
+    }
 
     std::vector<ValType> Locals;
     for (const auto &Local : Code->getLocals()) {
@@ -5501,7 +6426,8 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
                         Conf.getStatisticsConfigure().isInstructionCounting(),
                         Conf.getStatisticsConfigure().isCostMeasuring(),
                         Conf.getCompilerConfigure().getOptimizationLevel() ==
-                            CompilerConfigure::OptimizationLevel::O0);
+                            CompilerConfigure::OptimizationLevel::O0,
+                        FuncProfile, InstrumentedIdx);
     auto Type = Context->resolveBlockType(T);
     FC.compile(*Code, std::move(Type));
     llvm::EliminateUnreachableBlocks(*F);
@@ -4,6 +4,7 @@
 #include "wasmedge/wasmedge.h"
 
 #include "aot/compiler.h"
+#include "common/metrics.h"
 #include "driver/compiler.h"
 #include "driver/tool.h"
 #include "host/wasi/wasimodule.h"
@@ -11,6 +12,7 @@
 #include "vm/vm.h"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -18,6 +20,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -31,6 +34,11 @@ struct WasmEdge_ConfigureContext {
 // WasmEdge_StatisticsContext implementation.
 struct WasmEdge_StatisticsContext {};
 
+// WasmEdge_MetricsSnapshotContext implementation.
+struct WasmEdge_MetricsSnapshotContext {
+  std::vector<WasmEdge::Metrics::Sample> Samples;
+};
+
 // WasmEdge_ASTModuleContext implementation.
 struct WasmEdge_ASTModuleContext {};
 
@@ -103,6 +111,21 @@ struct WasmEdge_Async {
       Async;
 };
 
+// WasmEdge_FunctionHandleContext implementation.
+struct WasmEdge_FunctionHandleContext {
+  WasmEdge_FunctionHandleContext(
+      WasmEdge::Executor::Executor &E,
+      const WasmEdge::Runtime::Instance::FunctionInstance &F) noexcept
+      : Exec(E), Func(F),
+        ParamsN(static_cast<uint32_t>(F.getFuncType().getParamTypes().size())),
+        ReturnsN(
+            static_cast<uint32_t>(F.getFuncType().getReturnTypes().size())) {}
+  WasmEdge::Executor::Executor &Exec;
+  const WasmEdge::Runtime::Instance::FunctionInstance &Func;
+  const uint32_t ParamsN;
+  const uint32_t ReturnsN;
+};
+
 // WasmEdge_VMContext implementation.
 struct WasmEdge_VMContext {
   template <typename... Args>
@@ -266,8 +289,8 @@ inline WasmEdge_Result wrap(T &&Proc, U &&Then, CxtT *...Cxts) noexcept {
 }
 
 // Helper function of retrieving exported maps.
-template <typename T>
-inline uint32_t fillMap(const std::map<std::string, T *, std::less<>> &Map,
+template <typename K, typename T>
+inline uint32_t fillMap(const std::map<K, T *, std::less<>> &Map,
                         WasmEdge_String *Names, const uint32_t Len) noexcept {
   uint32_t I = 0;
   for (auto &&Pair : Map) {
@@ -373,26 +396,37 @@ public:
   Expect<void> run(const Runtime::CallingFrame &CallFrame,
                    Span<const ValVariant> Args,
                    Span<ValVariant> Rets) override {
-    std::vector<WasmEdge_Value> Params(FuncType.getParamTypes().size()),
-        Returns(FuncType.getReturnTypes().size());
-    for (uint32_t I = 0; I < Args.size(); I++) {
-      Params[I].Value = to_uint128_t(Args[I].get<WasmEdge::uint128_t>());
-      Params[I].Type =
-          static_cast<WasmEdge_ValType>(FuncType.getParamTypes()[I]);
+    // Pass the values on the stack unless there are too many of them.
+    const uint32_t ParamsN = static_cast<uint32_t>(Args.size());
+    const uint32_t ReturnsN = static_cast<uint32_t>(Rets.size());
+    std::array<WasmEdge_Value, kInlineValues> InlineValues;
+    std::vector<WasmEdge_Value> HeapValues;
+    WasmEdge_Value *Values = InlineValues.data();
+    if (unlikely(ParamsN + ReturnsN > kInlineValues)) {
+      HeapValues.resize(ParamsN + ReturnsN);
+      Values = HeapValues.data();
     }
-    WasmEdge_Value *PPtr = Params.size() ? (&Params[0]) : nullptr;
-    WasmEdge_Value *RPtr = Returns.size() ? (&Returns[0]) : nullptr;
+    const auto &ParamTypes = FuncType.getParamTypes();
+    const auto &ReturnTypes = FuncType.getReturnTypes();
+    for (uint32_t I = 0; I < ParamsN; I++) {
+      Values[I].Value = to_uint128_t(Args[I].get<WasmEdge::uint128_t>());
+      Values[I].Type = static_cast<WasmEdge_ValType>(ParamTypes[I]);
+    }
+    for (uint32_t I = 0; I < ReturnsN; I++) {
+      Values[ParamsN + I].Value = to_uint128_t(WasmEdge::uint128_t(0));
+      Values[ParamsN + I].Type = static_cast<WasmEdge_ValType>(ReturnTypes[I]);
+    }
+    WasmEdge_Value *PPtr = ParamsN ? Values : nullptr;
+    WasmEdge_Value *RPtr = ReturnsN ? Values + ParamsN : nullptr;
     auto *CallFrameCxt = toCallFrameCxt(&CallFrame);
     WasmEdge_Result Stat;
     if (Func) {
       Stat = Func(Data, CallFrameCxt, PPtr, RPtr);
     } else {
-      Stat = Wrap(Binding, Data, CallFrameCxt, PPtr,
-                  static_cast<uint32_t>(Params.size()), RPtr,
-                  static_cast<uint32_t>(Returns.size()));
+      Stat = Wrap(Binding, Data, CallFrameCxt, PPtr, ParamsN, RPtr, ReturnsN);
     }
-    for (uint32_t I = 0; I < Rets.size(); I++) {
-      Rets[I] = to_WasmEdge_128_t<WasmEdge::uint128_t>(Returns[I].Value);
+    for (uint32_t I = 0; I < ReturnsN; I++) {
+      Rets[I] = to_WasmEdge_128_t<WasmEdge::uint128_t>(RPtr[I].Value);
     }
     if (WasmEdge_ResultOK(Stat)) {
       if (WasmEdge_ResultGetCode(Stat) == 0x01U) {
@@ -407,6 +441,9 @@ public:
   }
 
 private:
+  /// Count of the parameters and returns passed without heap allocation.
+  static inline constexpr const uint32_t kInlineValues = 16;
+
   WasmEdge_HostFunc_t Func;
   WasmEdge_WrapFunc_t Wrap;
   void *Binding;
@@ -725,6 +762,70 @@ WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt) {
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetAsyncThreadPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                         const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setAsyncThreadPoolSize(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureGetAsyncThreadPoolSize(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getAsyncThreadPoolSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetAsyncQueueLimit(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Limit) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setAsyncQueueLimit(Limit);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetAsyncQueueLimit(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getAsyncQueueLimit();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetAsyncThreadAffinity(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsPinned) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setAsyncThreadAffinity(IsPinned);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsAsyncThreadAffinity(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isAsyncThreadAffinity();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetPerfMap(WasmEdge_ConfigureContext *Cxt,
+                             const bool IsPerfMap) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setPerfMap(IsPerfMap);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsPerfMap(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isPerfMap();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureCompilerSetOptimizationLevel(
     WasmEdge_ConfigureContext *Cxt,
     const enum WasmEdge_CompilerOptimizationLevel Level) {
@@ -811,6 +912,22 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsInterruptible(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetCacheSizeLimit(WasmEdge_ConfigureContext *Cxt,
+                                            const uint64_t Limit) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setCacheSizeLimit(Limit);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ConfigureCompilerGetCacheSizeLimit(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getCacheSizeLimit();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetInstructionCounting(
     WasmEdge_ConfigureContext *Cxt, const bool IsCount) {
   if (Cxt) {
@@ -926,6 +1043,79 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt) {
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge metrics functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_MetricsSetEnabled(const bool IsEnable) {
+  WasmEdge::Metrics::setEnabled(IsEnable);
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_MetricsIsEnabled(void) {
+  return WasmEdge::Metrics::isEnabled();
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_MetricsSnapshotContext *
+WasmEdge_MetricsSnapshotCreate(void) {
+  return new WasmEdge_MetricsSnapshotContext{
+      WasmEdge::Metrics::Registry::global().snapshot()};
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_MetricsSnapshotGetLength(const WasmEdge_MetricsSnapshotContext *Cxt) {
+  if (Cxt) {
+    return static_cast<uint32_t>(Cxt->Samples.size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_String
+WasmEdge_MetricsSnapshotGetName(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                const uint32_t Index) {
+  if (Cxt && Index < Cxt->Samples.size()) {
+    const auto &Name = Cxt->Samples[Index].Name;
+    return WasmEdge_String{.Length = static_cast<uint32_t>(Name.length()),
+                           .Buf = Name.data()};
+  }
+  return WasmEdge_String{.Length = 0, .Buf = nullptr};
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_String
+WasmEdge_MetricsSnapshotGetLabels(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                  const uint32_t Index) {
+  if (Cxt && Index < Cxt->Samples.size()) {
+    const auto &Labels = Cxt->Samples[Index].Labels;
+    return WasmEdge_String{.Length = static_cast<uint32_t>(Labels.length()),
+                           .Buf = Labels.data()};
+  }
+  return WasmEdge_String{.Length = 0, .Buf = nullptr};
+}
+
+WASMEDGE_CAPI_EXPORT double
+WasmEdge_MetricsSnapshotGetValue(const WasmEdge_MetricsSnapshotContext *Cxt,
+                                 const uint32_t Index) {
+  if (Cxt && Index < Cxt->Samples.size()) {
+    return Cxt->Samples[Index].Value;
+  }
+  return 0.0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_MetricsSnapshotDelete(WasmEdge_MetricsSnapshotContext *Cxt) {
+  delete Cxt;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_MetricsDumpPrometheus(char *Buf, const uint32_t Len) {
+  std::ostringstream OS;
+  WasmEdge::Metrics::Registry::global().dumpPrometheus(OS);
+  const auto Text = OS.str();
+  if (Buf) {
+    std::copy_n(Text.data(), std::min<size_t>(Len, Text.size()), Buf);
+  }
+  return static_cast<uint32_t>(Text.size());
+}
+
+// <<<<<<<< WasmEdge metrics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge AST module functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT uint32_t
@@ -2361,6 +2551,102 @@ WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncDelete(WasmEdge_Async *Cxt) {
 
 // <<<<<<<< WasmEdge Async functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge function handle functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT WasmEdge_FunctionHandleContext *
+WasmEdge_FunctionHandleCreate(WasmEdge_ExecutorContext *ExecCxt,
+                              const WasmEdge_FunctionInstanceContext *FuncCxt) {
+  if (ExecCxt && FuncCxt) {
+    return new WasmEdge_FunctionHandleContext(*fromExecutorCxt(ExecCxt),
+                                              *fromFuncCxt(FuncCxt));
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT const WasmEdge_FunctionTypeContext *
+WasmEdge_FunctionHandleGetFunctionType(
+    const WasmEdge_FunctionHandleContext *Cxt) {
+  if (Cxt) {
+    return toFuncTypeCxt(&Cxt->Func.getFuncType());
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_FunctionHandleGetParametersLength(
+    const WasmEdge_FunctionHandleContext *Cxt) {
+  if (Cxt) {
+    return Cxt->ParamsN;
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_FunctionHandleGetReturnsLength(
+    const WasmEdge_FunctionHandleContext *Cxt) {
+  if (Cxt) {
+    return Cxt->ReturnsN;
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_FunctionHandleInvoke(
+    const WasmEdge_FunctionHandleContext *Cxt, const ::uint128_t *Params,
+    const uint32_t ParamLen, ::uint128_t *Returns, const uint32_t ReturnLen) {
+  // The slots are in the representation of the values on the stack.
+  static_assert(sizeof(::uint128_t) == sizeof(ValVariant));
+  if (unlikely(!Cxt || (ParamLen > 0 && !Params) ||
+               (Cxt->ReturnsN > 0 && !Returns))) {
+    return genWasmEdge_Result(ErrCode::Value::WrongVMWorkflow);
+  }
+  if (unlikely(ParamLen != Cxt->ParamsN || ReturnLen < Cxt->ReturnsN)) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    return genWasmEdge_Result(ErrCode::Value::FuncSigMismatch);
+  }
+  if (auto Res = Cxt->Exec.invokeUnchecked(
+          Cxt->Func,
+          Span<const ValVariant>(reinterpret_cast<const ValVariant *>(Params),
+                                 ParamLen),
+          Span<ValVariant>(reinterpret_cast<ValVariant *>(Returns),
+                           Cxt->ReturnsN));
+      unlikely(!Res)) {
+    return genWasmEdge_Result(Res.error());
+  }
+  return genWasmEdge_Result(ErrCode::Value::Success);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_FunctionHandleInvokeBatch(
+    const WasmEdge_FunctionHandleContext *Cxt, const ::uint128_t *Params,
+    ::uint128_t *Returns, const uint32_t Count, WasmEdge_Result *Results) {
+  if (unlikely(!Cxt || (Cxt->ParamsN > 0 && Count > 0 && !Params) ||
+               (Cxt->ReturnsN > 0 && Count > 0 && !Returns))) {
+    return genWasmEdge_Result(ErrCode::Value::WrongVMWorkflow);
+  }
+  const size_t ParamsLen = static_cast<size_t>(Count) * Cxt->ParamsN;
+  const size_t ReturnsLen = static_cast<size_t>(Count) * Cxt->ReturnsN;
+  std::vector<ErrCode> Errors(Results ? Count : 0);
+  auto Res = Cxt->Exec.invokeBatch(
+      Cxt->Func, Count,
+      Span<const ValVariant>(reinterpret_cast<const ValVariant *>(Params),
+                             ParamsLen),
+      Span<ValVariant>(reinterpret_cast<ValVariant *>(Returns), ReturnsLen),
+      Errors);
+  if (Results) {
+    for (uint32_t I = 0; I < Count; ++I) {
+      Results[I] = genWasmEdge_Result(Errors[I]);
+    }
+  }
+  if (unlikely(!Res)) {
+    return genWasmEdge_Result(Res.error());
+  }
+  return genWasmEdge_Result(ErrCode::Value::Success);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_FunctionHandleDelete(WasmEdge_FunctionHandleContext *Cxt) {
+  delete Cxt;
+}
+
+// <<<<<<<< WasmEdge function handle functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge VM functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT WasmEdge_VMContext *
@@ -2561,6 +2847,38 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMExecuteRegistered(
       Cxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_FunctionHandleContext *
+WasmEdge_VMGetFunctionHandle(WasmEdge_VMContext *Cxt,
+                             const WasmEdge_String FuncName) {
+  if (Cxt) {
+    if (const auto *ModInst = Cxt->VM.getActiveModule()) {
+      if (const auto *FuncInst =
+              ModInst->findFuncExports(genStrView(FuncName))) {
+        return new WasmEdge_FunctionHandleContext(Cxt->VM.getExecutor(),
+                                                  *FuncInst);
+      }
+    }
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_FunctionHandleContext *
+WasmEdge_VMGetFunctionHandleRegistered(WasmEdge_VMContext *Cxt,
+                                       const WasmEdge_String ModuleName,
+                                       const WasmEdge_String FuncName) {
+  if (Cxt) {
+    if (const auto *ModInst =
+            Cxt->VM.getStoreManager().findModule(genStrView(ModuleName))) {
+      if (const auto *FuncInst =
+              ModInst->findFuncExports(genStrView(FuncName))) {
+        return new WasmEdge_FunctionHandleContext(Cxt->VM.getExecutor(),
+                                                  *FuncInst);
+      }
+    }
+  }
+  return nullptr;
+}
+
 WASMEDGE_CAPI_EXPORT WasmEdge_Async *
 WasmEdge_VMAsyncExecute(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
                         const WasmEdge_Value *Params, const uint32_t ParamLen) {
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace WasmEdge {
+namespace Epoch {
+
+namespace {
+
+/// Per-thread record of the epoch observed when entering the outermost
+/// critical section, or 0 when not in any. The records are reused by the
+/// later threads and never freed.
+struct alignas(64) Record {
+  std::atomic<uint64_t> Epoch = 0;
+  std::atomic_bool InUse = true;
+  Record *Next = nullptr;
+};
+
+std::atomic<uint64_t> GlobalEpoch = 1;
+std::atomic<Record *> Records = nullptr;
+
+Record *acquireRecord() {
+  for (auto *Rec = Records.load(std::memory_order_acquire); Rec != nullptr;
+       Rec = Rec->Next) {
+    bool Expected = false;
+    if (!Rec->InUse.load(std::memory_order_relaxed) &&
+        Rec->InUse.compare_exchange_strong(Expected, true,
+                                           std::memory_order_acquire)) {
+      return Rec;
+    }
+  }
+  auto *Rec = new Record();
+  Rec->Next = Records.load(std::memory_order_relaxed);
+  while (!Records.compare_exchange_weak(Rec->Next, Rec,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+  return Rec;
+}
+
+struct ThreadState {
+  ~ThreadState() noexcept {
+    if (Rec != nullptr) {
+      Rec->Epoch.store(0, std::memory_order_release);
+      Rec->InUse.store(false, std::memory_order_release);
+      Rec = nullptr;
+    }
+  }
+  Record *Rec = nullptr;
+  uint32_t Depth = 0;
+};
+
+thread_local ThreadState Thread;
+
+struct Retired {
+  uint64_t Epoch;
+  void *Ptr;
+  void (*Deleter)(void *);
+};
+
+struct RetiredList {
+  std::mutex Mutex;
+  std::vector<Retired> List;
+};
+
+RetiredList &retiredList() noexcept {
+  // Never destroyed, for the objects retired at the exit.
+  static RetiredList *List = new RetiredList();
+  return *List;
+}
+
+} // namespace
+
+[[gnu::visibility("default")]] void enter() noexcept {
+  auto &State = Thread;
+  if (State.Depth++ == 0) {
+    if (State.Rec == nullptr) {
+      State.Rec = acquireRecord();
+    }
+    State.Rec->Epoch.store(GlobalEpoch.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    // Order the record before the loads of the shared pointers, against the
+    // unlinking and the scanning of the writers.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+[[gnu::visibility("default")]] void leave() noexcept {
+  auto &State = Thread;
+  if (--State.Depth == 0) {
+    State.Rec->Epoch.store(0, std::memory_order_release);
+  }
+}
+
+[[gnu::visibility("default")]] void retire(void *Ptr,
+                                           void (*Deleter)(void *)) {
+  // The readers entered after this increment can not reach the object.
+  const uint64_t Retiring = GlobalEpoch.fetch_add(1);
+  {
+    auto &Pending = retiredList();
+    std::unique_lock Lock(Pending.Mutex);
+    Pending.List.push_back({Retiring, Ptr, Deleter});
+  }
+  reclaim();
+}
+
+[[gnu::visibility("default")]] void reclaim() {
+  // The objects retired after loading the bound are left for the next time,
+  // even if no reader is found below.
+  uint64_t Safe = GlobalEpoch.load();
+  for (auto *Rec = Records.load(std::memory_order_acquire); Rec != nullptr;
+       Rec = Rec->Next) {
+    if (const uint64_t E = Rec->Epoch.load(); E != 0) {
+      Safe = std::min(Safe, E);
+    }
+  }
+
+  std::vector<Retired> Ready;
+  {
+    auto &Pending = retiredList();
+    std::unique_lock Lock(Pending.Mutex);
+    auto Iter =
+        std::partition(Pending.List.begin(), Pending.List.end(),
+                       [Safe](const Retired &R) { return R.Epoch >= Safe; });
+    Ready.assign(Iter, Pending.List.end());
+    Pending.List.erase(Iter, Pending.List.end());
+  }
+  for (const auto &R : Ready) {
+    R.Deleter(R.Ptr);
+  }
+}
+
+} // namespace Epoch
+} // namespace WasmEdge
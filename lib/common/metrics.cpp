@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/metrics.h"
+
+#include "common/errcode.h"
+
+#include <chrono>
+
+namespace WasmEdge {
+namespace Metrics {
+
+namespace {
+
+using namespace std::literals;
+
+/// The `le` labels of the histogram buckets, in seconds.
+constexpr std::array<std::string_view, Histogram::kBounds.size() + 1>
+    BucketLabels = {"1e-06"sv, "1e-05"sv, "0.0001"sv, "0.001"sv, "0.01"sv,
+                    "0.1"sv,   "1"sv,     "10"sv,     "+Inf"sv};
+
+std::atomic_bool Enabled = false;
+
+std::string joinLabels(std::string_view Labels, std::string_view Extra) {
+  std::string Joined(Labels);
+  if (!Joined.empty() && !Extra.empty()) {
+    Joined += ',';
+  }
+  Joined += Extra;
+  return Joined;
+}
+
+double toSeconds(std::chrono::nanoseconds Duration) noexcept {
+  return std::chrono::duration<double>(Duration).count();
+}
+
+/// Write integral values in full, instead of in the exponent notation.
+void writeValue(std::ostream &OS, double Value) {
+  if (const auto Integral = static_cast<int64_t>(Value);
+      static_cast<double>(Integral) == Value) {
+    OS << Integral;
+  } else {
+    const auto Precision = OS.precision(17);
+    OS << Value;
+    OS.precision(Precision);
+  }
+}
+
+/// Call \p Emit for every sample of a metric.
+template <typename FuncT>
+void forEachSample(std::string_view Name, std::string_view Labels,
+                   const std::variant<Counter, Gauge, Histogram> &M,
+                   FuncT &&Emit) {
+  if (const auto *C = std::get_if<Counter>(&M)) {
+    Emit(std::string(Name), std::string(Labels), static_cast<double>(C->get()));
+  } else if (const auto *G = std::get_if<Gauge>(&M)) {
+    Emit(std::string(Name), std::string(Labels), static_cast<double>(G->get()));
+  } else if (const auto *H = std::get_if<Histogram>(&M)) {
+    const std::string Bucket = std::string(Name) + "_bucket"s;
+    uint64_t Cumulative = 0;
+    for (uint32_t I = 0; I < BucketLabels.size(); ++I) {
+      Cumulative += H->getBucket(I);
+      Emit(Bucket, joinLabels(Labels, label("le"sv, BucketLabels[I])),
+           static_cast<double>(Cumulative));
+    }
+    Emit(std::string(Name) + "_sum"s, std::string(Labels),
+         toSeconds(H->getSum()));
+    Emit(std::string(Name) + "_count"s, std::string(Labels),
+         static_cast<double>(Cumulative));
+  }
+}
+
+} // namespace
+
+Registry &Registry::global() noexcept {
+  // Never destroyed, for the instances destroyed at the exit.
+  static Registry *Global = new Registry();
+  return *Global;
+}
+
+template <typename T>
+T &Registry::get(std::string_view Name, std::string_view Help,
+                 std::string_view Labels) {
+  std::unique_lock Lock(Mutex);
+  auto FamIter = Families.find(Name);
+  if (FamIter == Families.end()) {
+    FamIter = Families.emplace(std::string(Name), Family{}).first;
+    FamIter->second.Help = std::string(Help);
+  }
+  auto &Series = FamIter->second.Series;
+  auto Iter = Series.find(Labels);
+  if (Iter == Series.end()) {
+    Iter = Series
+               .emplace(std::string(Labels),
+                        std::make_unique<Metric>(std::in_place_type<T>))
+               .first;
+  }
+  // A name is always used with the same kind of metric.
+  assuming(std::holds_alternative<T>(*Iter->second));
+  return std::get<T>(*Iter->second);
+}
+
+Counter &Registry::counter(std::string_view Name, std::string_view Help,
+                           std::string_view Labels) {
+  return get<Counter>(Name, Help, Labels);
+}
+
+Gauge &Registry::gauge(std::string_view Name, std::string_view Help,
+                       std::string_view Labels) {
+  return get<Gauge>(Name, Help, Labels);
+}
+
+Histogram &Registry::histogram(std::string_view Name, std::string_view Help,
+                               std::string_view Labels) {
+  return get<Histogram>(Name, Help, Labels);
+}
+
+std::vector<Sample> Registry::snapshot() const {
+  std::unique_lock Lock(Mutex);
+  std::vector<Sample> Samples;
+  for (const auto &[Name, Fam] : Families) {
+    for (const auto &[Labels, M] : Fam.Series) {
+      forEachSample(Name, Labels, *M,
+                    [&Samples](std::string SampleName, std::string SampleLabels,
+                               double Value) {
+                      Samples.push_back(Sample{std::move(SampleName),
+                                               std::move(SampleLabels),
+                                               Value});
+                    });
+    }
+  }
+  return Samples;
+}
+
+void Registry::dumpPrometheus(std::ostream &OS) const {
+  std::unique_lock Lock(Mutex);
+  for (const auto &[Name, Fam] : Families) {
+    if (Fam.Series.empty()) {
+      continue;
+    }
+    std::string_view Type;
+    switch (Fam.Series.begin()->second->index()) {
+    case 0:
+      Type = "counter"sv;
+      break;
+    case 1:
+      Type = "gauge"sv;
+      break;
+    default:
+      Type = "histogram"sv;
+      break;
+    }
+    OS << "# HELP " << Name << ' ' << Fam.Help << '\n';
+    OS << "# TYPE " << Name << ' ' << Type << '\n';
+    for (const auto &[Labels, M] : Fam.Series) {
+      forEachSample(
+          Name, Labels, *M,
+          [&OS](const std::string &SampleName, const std::string &SampleLabels,
+                double Value) {
+            OS << SampleName;
+            if (!SampleLabels.empty()) {
+              OS << '{' << SampleLabels << '}';
+            }
+            OS << ' ';
+            writeValue(OS, Value);
+            OS << '\n';
+          });
+    }
+  }
+}
+
+std::string label(std::string_view Key, std::string_view Value) {
+  std::string Label(Key);
+  Label += "=\""sv;
+  for (const char C : Value) {
+    switch (C) {
+    case '\\':
+      Label += "\\\\"sv;
+      break;
+    case '"':
+      Label += "\\\""sv;
+      break;
+    case '\n':
+      Label += "\\n"sv;
+      break;
+    default:
+      Label += C;
+      break;
+    }
+  }
+  Label += '"';
+  return Label;
+}
+
+void setEnabled(bool Enable) noexcept {
+  Enabled.store(Enable, std::memory_order_relaxed);
+}
+
+bool isEnabled() noexcept { return Enabled.load(std::memory_order_relaxed); }
+
+[[gnu::visibility("default")]] const RuntimeMetrics &runtime() noexcept {
+  static const RuntimeMetrics Runtime = []() {
+    auto &Reg = Registry::global();
+    return RuntimeMetrics{
+        Reg.counter("wasmedge_instances_created_total"sv,
+                    "Module instances created."sv),
+        Reg.counter("wasmedge_instances_destroyed_total"sv,
+                    "Module instances destroyed."sv),
+        Reg.histogram("wasmedge_instantiation_duration_seconds"sv,
+                      "Latency of module instantiations."sv),
+        Reg.gauge("wasmedge_memory_pages"sv,
+                  "Committed pages of the memory instances."sv),
+        Reg.counter("wasmedge_gas_consumed_total"sv,
+                    "Gas consumed by the executions."sv),
+        Reg.counter("wasmedge_aot_cache_hits_total"sv,
+                    "Lookups of compiled modules found in the AOT cache."sv),
+        Reg.counter("wasmedge_aot_cache_misses_total"sv,
+                    "Lookups of compiled modules missed in the AOT cache."sv),
+    };
+  }();
+  return Runtime;
+}
+
+[[gnu::visibility("default")]] const HostCallMetrics &
+hostCall(std::string_view ModName, std::string_view FuncName) {
+  static std::mutex Mutex;
+  static auto &Calls = *new std::map<std::string,
+                                     std::unique_ptr<HostCallMetrics>,
+                                     std::less<>>();
+  std::string Name(ModName);
+  Name += '.';
+  Name += FuncName;
+
+  std::unique_lock Lock(Mutex);
+  auto Iter = Calls.find(Name);
+  if (Iter == Calls.end()) {
+    auto &Reg = Registry::global();
+    const auto Labels = label("function"sv, Name);
+    auto Entry = std::make_unique<HostCallMetrics>(HostCallMetrics{
+        Reg.counter("wasmedge_host_calls_total"sv,
+                    "Calls to the host functions."sv, Labels),
+        Reg.histogram("wasmedge_host_call_duration_seconds"sv,
+                      "Latency of calls to the host functions."sv, Labels)});
+    Iter = Calls.emplace(std::move(Name), std::move(Entry)).first;
+  }
+  return *Iter->second;
+}
+
+void addTrap(std::string_view Code) {
+  Registry::global()
+      .counter("wasmedge_traps_total"sv,
+               "Executions failed, by the error code."sv,
+               label("code"sv, Code))
+      .add();
+}
+
+} // namespace Metrics
+} // namespace WasmEdge
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/pgo.h"
+
+#include <sstream>
+#include <string_view>
+
+namespace WasmEdge {
+namespace PGO {
+
+namespace {
+
+using namespace std::literals;
+
+constexpr std::string_view kHeader = "wasmedge-profile 1"sv;
+
+} // namespace
+
+void Profile::write(std::ostream &OS) const {
+  OS << kHeader << '\n';
+  for (const auto &[Name, Mod] : Modules) {
+    OS << "module " << Name << '\n';
+    for (const auto &[Index, Func] : Mod.Functions) {
+      OS << "function " << Index << ' ' << Func.EntryCount << '\n';
+      for (const auto &[Offset, Counts] : Func.Branches) {
+        OS << "branch " << Index << ' ' << Offset;
+        for (const uint64_t Count : Counts) {
+          OS << ' ' << Count;
+        }
+        OS << '\n';
+      }
+    }
+  }
+}
+
+bool Profile::read(std::istream &IS) {
+  std::string Line;
+  if (!std::getline(IS, Line) || Line != kHeader) {
+    return false;
+  }
+  ModuleProfile *Mod = nullptr;
+  while (std::getline(IS, Line)) {
+    if (Line.empty()) {
+      continue;
+    }
+    // The module name is the rest of the line, which may contain spaces.
+    if (Line.rfind("module "sv, 0) == 0) {
+      Mod = &Modules[Line.substr("module "sv.size())];
+      continue;
+    }
+    if (Mod == nullptr) {
+      return false;
+    }
+    std::istringstream LS(Line);
+    std::string Kind;
+    uint32_t Index;
+    if (!(LS >> Kind >> Index)) {
+      return false;
+    }
+    auto &Func = Mod->Functions[Index];
+    if (Kind == "function"sv) {
+      if (!(LS >> Func.EntryCount)) {
+        return false;
+      }
+    } else if (Kind == "branch"sv) {
+      uint32_t Offset;
+      if (!(LS >> Offset)) {
+        return false;
+      }
+      auto &Counts = Func.Branches[Offset];
+      Counts.clear();
+      for (uint64_t Count; LS >> Count;) {
+        Counts.push_back(Count);
+      }
+      if (Counts.empty()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    if (!(LS >> std::ws).eof()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace PGO
+} // namespace WasmEdge
@@ -12,6 +12,7 @@
 #include "validator/validator.h"
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -38,12 +39,30 @@ int Compiler([[maybe_unused]] int Argc,
   PO::Option<PO::Toggle> ConfGenericBinary(
       PO::Description("Generate a generic binary"sv));
 
+  PO::List<std::string> TargetCPUs(
+      PO::Description(
+          "Target CPUs, named as in LLVM such as `skylake-avx512`. The module is compiled for each of them into the universal wasm output, and the best match for the running CPU is loaded. Include `generic` for the CPUs matching none of them."sv),
+      PO::MetaVar("CPUS"sv));
+
+  PO::List<std::string> Links(
+      PO::Description(
+          "Modules linked by the name, as registered at runtime. Each module can be specified as --link `NAME=PATH`. The imported functions of the linked modules which only compute on their arguments are compiled into the output and called directly."sv),
+      PO::MetaVar("LINKS"sv));
+
+  PO::Option<std::string> ProfileUse(
+      PO::Description(
+          "Optimize with the workload profile written by `wasmedge --profile-generate`."sv),
+      PO::MetaVar("PROFILE_PATH"sv), PO::DefaultValue<std::string>(""));
+
   PO::Option<PO::Toggle> ConfDumpIR(
       PO::Description("Dump LLVM IR to `wasm.ll` and `wasm-opt.ll`."sv));
 
   PO::Option<PO::Toggle> ConfInterruptible(
       PO::Description("Generate a interruptible binary"sv));
 
+  PO::Option<PO::Toggle> ConfEnableInstrumentation(PO::Description(
+      "Enable generating code for counting the executed opcodes and basic blocks for `wasmedge --profile-instructions`."sv));
+
   PO::Option<PO::Toggle> ConfEnableInstructionCounting(PO::Description(
       "Enable generating code for counting Wasm instructions executed."sv));
   PO::Option<PO::Toggle> ConfEnableGasMeasuring(PO::Description(
@@ -82,12 +101,16 @@ int Compiler([[maybe_unused]] int Argc,
            .add_option(SoName)
            .add_option("dump"sv, ConfDumpIR)
            .add_option("interruptible"sv, ConfInterruptible)
+           .add_option("enable-instrumentation"sv, ConfEnableInstrumentation)
            .add_option("enable-instruction-count"sv,
                        ConfEnableInstructionCounting)
            .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
            .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
            .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
            .add_option("generic-binary"sv, ConfGenericBinary)
+           .add_option("target-cpu"sv, TargetCPUs)
+           .add_option("profile-use"sv, ProfileUse)
+           .add_option("link"sv, Links)
            .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
            .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
            .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -180,6 +203,35 @@ int Compiler([[maybe_unused]] int Argc,
     }
   }
 
+  std::vector<std::pair<std::string, std::unique_ptr<AST::Module>>>
+      LinkedModules;
+  for (const auto &Link : Links.value()) {
+    const auto Pos = Link.find('=');
+    if (Pos == std::string::npos) {
+      spdlog::error("Invalid linked module {}, expected NAME=PATH", Link);
+      return EXIT_FAILURE;
+    }
+    const auto LinkPath = std::filesystem::absolute(
+        std::filesystem::u8path(Link.substr(Pos + 1)));
+    std::unique_ptr<AST::Module> Linked;
+    if (auto Res = Loader.parseModule(LinkPath)) {
+      Linked = std::move(*Res);
+    } else {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Parse linked module {} failed. Error code: {}",
+                    LinkPath.u8string(), Err);
+      return EXIT_FAILURE;
+    }
+    Validator::Validator ValidatorEngine(Conf);
+    if (auto Res = ValidatorEngine.validate(*Linked); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Validate linked module {} failed. Error code: {}",
+                    LinkPath.u8string(), Err);
+      return EXIT_FAILURE;
+    }
+    LinkedModules.emplace_back(Link.substr(0, Pos), std::move(Linked));
+  }
+
   {
     if (ConfDumpIR.value()) {
       Conf.getCompilerConfigure().setDumpIR(true);
@@ -187,6 +239,9 @@ int Compiler([[maybe_unused]] int Argc,
     if (ConfInterruptible.value()) {
       Conf.getCompilerConfigure().setInterruptible(true);
     }
+    if (ConfEnableInstrumentation.value()) {
+      Conf.getCompilerConfigure().setInstrumentation(true);
+    }
     if (ConfEnableAllStatistics.value()) {
       Conf.getStatisticsConfigure().setInstructionCounting(true);
       Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -210,6 +265,27 @@ int Compiler([[maybe_unused]] int Argc,
           CompilerConfigure::OutputFormat::Native);
     }
     AOT::Compiler Compiler(Conf);
+    for (const auto &CPU : TargetCPUs.value()) {
+      Compiler.addTargetCPU(CPU);
+    }
+    for (const auto &[Name, Linked] : LinkedModules) {
+      Compiler.addLinkedModule(Name, *Linked);
+    }
+    if (const auto &Path = ProfileUse.value(); !Path.empty()) {
+      PGO::Profile Profile;
+      if (std::ifstream IS(Path); !IS || !Profile.read(IS)) {
+        spdlog::error("Failed to read profile {}", Path);
+        return EXIT_FAILURE;
+      }
+      // Use the profile of the module run by the runtime tool, or the only
+      // module in the profile.
+      if (auto Iter = Profile.Modules.find(""sv);
+          Iter != Profile.Modules.end()) {
+        Compiler.setProfile(std::move(Iter->second));
+      } else if (Profile.Modules.size() == 1) {
+        Compiler.setProfile(std::move(Profile.Modules.begin()->second));
+      }
+    }
     if (auto Res = Compiler.compile(Data, *Module, OutputPath); !Res) {
       const auto Err = static_cast<uint32_t>(Res.error());
       spdlog::error("Compilation failed. Error code: {}", Err);
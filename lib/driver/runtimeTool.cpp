@@ -1,29 +1,85 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
+#include "aot/compiler.h"
 #include "common/configure.h"
 #include "common/filesystem.h"
 #include "common/log.h"
+#include "common/metrics.h"
 #include "common/types.h"
 #include "common/version.h"
 #include "driver/tool.h"
+#include "executor/profiler.h"
 #include "host/wasi/wasimodule.h"
+#include "loader/loader.h"
 #include "plugin/plugin.h"
 #include "po/argument_parser.h"
+#include "validator/validator.h"
 #include "vm/vm.h"
 
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <experimental/scope.hpp>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
 namespace Driver {
 
+namespace {
+
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+/// Compile the wasm file into the AOT cache of the user, unless cached, and
+/// return the path of the entry. The entries are keyed by the statistics
+/// generated in the code.
+Expect<std::filesystem::path> compileCached(const Configure &Conf,
+                                            const std::filesystem::path &Path) {
+  Loader::Loader Loader(Conf);
+  std::vector<Byte> Data;
+  if (auto Res = Loader.loadFile(Path)) {
+    Data = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  std::unique_ptr<AST::Module> Module;
+  if (auto Res = Loader.parseModule(Data)) {
+    Module = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  Validator::Validator ValidatorEngine(Conf);
+  if (auto Res = ValidatorEngine.validate(*Module); !Res) {
+    return Unexpect(Res);
+  }
+
+  std::string Key = "runtime";
+  const auto &StatConf = Conf.getStatisticsConfigure();
+  if (StatConf.isInstructionCounting()) {
+    Key += "-count";
+  }
+  if (StatConf.isCostMeasuring()) {
+    Key += "-gas";
+  }
+  if (StatConf.isTimeMeasuring()) {
+    Key += "-time";
+  }
+  if (Conf.getCompilerConfigure().isInstrumentation()) {
+    Key += "-instr";
+  }
+  AOT::Compiler Compiler(Conf);
+  return Compiler.compile(Data, *Module, AOT::Cache::StorageScope::Local, Key);
+}
+#endif
+
+} // namespace
+
 int Tool(int Argc, const char *Argv[]) noexcept {
   using namespace std::literals;
 
@@ -105,6 +161,31 @@ int Tool(int Argc, const char *Argv[]) noexcept {
   PO::List<std::string> ForbiddenPlugins(
       PO::Description("List of plugins to ignore."sv), PO::MetaVar("NAMES"sv));
 
+  PO::Option<std::string> Profile(
+      PO::Description(
+          "Sample the wasm call stacks during execution and write them in the folded stack format of flamegraph.pl to `PROFILE_PATH`."sv),
+      PO::MetaVar("PROFILE_PATH"sv), PO::DefaultValue<std::string>(""));
+  PO::Option<PO::Toggle> PerfMap(PO::Description(
+      "Write the symbols of the AOT compiled functions to `/tmp/perf-<pid>.map` for the Linux perf tool."sv));
+  PO::Option<std::string> ProfileInstructions(
+      PO::Description(
+          "Count the executed opcodes, function instructions and basic blocks in the interpreter, or in the AOT code compiled with `wasmedgec --enable-instrumentation`, and write them to `PROFILE_PATH`. The output is CSV if the path ends with `.csv`, or JSON otherwise."sv),
+      PO::MetaVar("PROFILE_PATH"sv), PO::DefaultValue<std::string>(""));
+  PO::Option<std::string> ProfileGenerate(
+      PO::Description(
+          "Count the function calls and the branch targets in the interpreter and write them to `PROFILE_PATH` for `wasmedgec --profile-use`."sv),
+      PO::MetaVar("PROFILE_PATH"sv), PO::DefaultValue<std::string>(""));
+  PO::Option<PO::Toggle> AOTCache(PO::Description(
+      "Compile the wasm file into the AOT cache of the user, unless cached, and run the compiled entry."sv));
+  PO::Option<uint64_t> AOTCacheSizeLimit(
+      PO::Description(
+          "Size limit in bytes of the AOT cache filled by --aot-cache. The least recently used entries are evicted to keep the cache under the limit. Default value is 0 for no limitations."sv),
+      PO::MetaVar("BYTES"sv), PO::DefaultValue<uint64_t>(0));
+  PO::Option<std::string> MetricsPath(
+      PO::Description(
+          "Record the runtime metrics, including the host function calls, and write them in the Prometheus text format to `METRICS_PATH` at exit."sv),
+      PO::MetaVar("METRICS_PATH"sv), PO::DefaultValue<std::string>(""));
+
   auto Parser = PO::ArgumentParser();
   Parser.add_option(SoName)
       .add_option(Args)
@@ -130,7 +211,14 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       .add_option("time-limit"sv, TimeLim)
       .add_option("gas-limit"sv, GasLim)
       .add_option("memory-page-limit"sv, MemLim)
-      .add_option("forbidden-plugin"sv, ForbiddenPlugins);
+      .add_option("forbidden-plugin"sv, ForbiddenPlugins)
+      .add_option("profile"sv, Profile)
+      .add_option("profile-instructions"sv, ProfileInstructions)
+      .add_option("profile-generate"sv, ProfileGenerate)
+      .add_option("perf-map"sv, PerfMap)
+      .add_option("aot-cache"sv, AOTCache)
+      .add_option("aot-cache-size-limit"sv, AOTCacheSizeLimit)
+      .add_option("metrics"sv, MetricsPath);
 
   Plugin::Plugin::addPluginOptions(Parser);
 
@@ -197,6 +285,9 @@ int Tool(int Argc, const char *Argv[]) noexcept {
     Conf.getRuntimeConfigure().setMaxMemoryPage(
         static_cast<uint32_t>(MemLim.value().back()));
   }
+  if (PerfMap.value()) {
+    Conf.getRuntimeConfigure().setPerfMap(true);
+  }
   if (ConfEnableAllStatistics.value()) {
     Conf.getStatisticsConfigure().setInstructionCounting(true);
     Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -226,8 +317,83 @@ int Tool(int Argc, const char *Argv[]) noexcept {
   Conf.addHostRegistration(HostRegistration::WasiCrypto_Signatures);
   Conf.addHostRegistration(HostRegistration::WasiCrypto_Symmetric);
   const auto InputPath = std::filesystem::absolute(SoName.value());
+  auto RunPath = InputPath;
+  if (AOTCache.value()) {
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+    Conf.getCompilerConfigure().setCacheSizeLimit(AOTCacheSizeLimit.value());
+    Conf.getCompilerConfigure().setInstrumentation(
+        !ProfileInstructions.value().empty());
+    if (auto Res = compileCached(Conf, InputPath)) {
+      RunPath = std::move(*Res);
+    } else {
+      spdlog::error("Compilation to the AOT cache failed. Error code: {}",
+                    static_cast<uint32_t>(Res.error()));
+      return EXIT_FAILURE;
+    }
+#else
+    spdlog::error("Compilation is not supported!");
+    return EXIT_FAILURE;
+#endif
+  }
+
+  if (!MetricsPath.value().empty()) {
+    Metrics::setEnabled(true);
+  }
+  // Dump the metrics after the VM is destroyed.
+  auto DumpMetrics = cxx20::scope_exit([&]() noexcept {
+    if (const auto &Path = MetricsPath.value(); !Path.empty()) {
+      if (std::ofstream OS(Path); OS) {
+        Metrics::Registry::global().dumpPrometheus(OS);
+      } else {
+        spdlog::error("Failed to open metrics output {}", Path);
+      }
+    }
+  });
   VM::VM VM(Conf);
 
+  std::optional<Executor::Profiler> Prof;
+  if (!Profile.value().empty() || !ProfileInstructions.value().empty() ||
+      !ProfileGenerate.value().empty()) {
+    Prof.emplace();
+    VM.getExecutor().setProfiler(&*Prof);
+    Prof->setInstrumentation(!ProfileInstructions.value().empty() ||
+                             !ProfileGenerate.value().empty());
+    if (!Profile.value().empty()) {
+      Prof->start();
+    }
+  }
+  // Dump the profile before the VM destroys the profiled functions.
+  auto DumpProfile = cxx20::scope_exit([&]() noexcept {
+    if (!Prof) {
+      return;
+    }
+    Prof->stop();
+    if (const auto &Path = Profile.value(); !Path.empty()) {
+      if (std::ofstream OS(Path); OS) {
+        Prof->dumpFolded(OS);
+      } else {
+        spdlog::error("Failed to open profile output {}", Path);
+      }
+    }
+    if (const auto &Path = ProfileInstructions.value(); !Path.empty()) {
+      if (std::ofstream OS(Path); !OS) {
+        spdlog::error("Failed to open profile output {}", Path);
+      } else if (std::filesystem::u8path(Path).extension().u8string() ==
+                 ".csv"sv) {
+        Prof->dumpInstrCSV(OS);
+      } else {
+        Prof->dumpInstrJSON(OS);
+      }
+    }
+    if (const auto &Path = ProfileGenerate.value(); !Path.empty()) {
+      if (std::ofstream OS(Path); OS) {
+        Prof->getPGOProfile().write(OS);
+      } else {
+        spdlog::error("Failed to open profile output {}", Path);
+      }
+    }
+  });
+
   Host::WasiModule *WasiMod = dynamic_cast<Host::WasiModule *>(
       VM.getImportModule(HostRegistration::Wasi));
 
@@ -240,7 +406,7 @@ int Tool(int Argc, const char *Argv[]) noexcept {
 
   if (!Reactor.value()) {
     // command mode
-    auto AsyncResult = VM.asyncRunWasmFile(InputPath.u8string(), "_start");
+    auto AsyncResult = VM.asyncRunWasmFile(RunPath.u8string(), "_start");
     if (Timeout.has_value()) {
       if (!AsyncResult.waitUntil(*Timeout)) {
         AsyncResult.cancel();
@@ -260,7 +426,7 @@ int Tool(int Argc, const char *Argv[]) noexcept {
       return EXIT_FAILURE;
     }
     const auto &FuncName = Args.value().front();
-    if (auto Result = VM.loadWasm(InputPath.u8string()); !Result) {
+    if (auto Result = VM.loadWasm(RunPath.u8string()); !Result) {
       return EXIT_FAILURE;
     }
     if (auto Result = VM.validate(); !Result) {
@@ -3,6 +3,11 @@
 
 #include "executor/executor.h"
 
+#include "common/metrics.h"
+
+#include <experimental/scope.hpp>
+
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
@@ -10,6 +15,18 @@
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Count a failed execution in the metrics, labeled by the error code.
+void addTrap(const ErrCode &Code) {
+  using namespace std::literals;
+  if (Code.getCategory() == ErrCategory::WASM) {
+    Metrics::addTrap(ErrCodeStr[Code.getEnum()]);
+  } else {
+    Metrics::addTrap("user"sv);
+  }
+}
+} // namespace
+
 Expect<void> Executor::runExpression(Runtime::StackManager &StackMgr,
                                      AST::InstrView Instrs) {
   return execute(StackMgr, Instrs.begin(), Instrs.end());
@@ -23,41 +40,19 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
   if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
     Stat->startRecordWasm();
   }
+  const uint64_t StartCost = Stat ? Stat->getTotalCost() : 0;
 
-  // Reset and push a dummy frame into stack.
-  StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
-
-  // Push arguments.
-  for (auto &Val : Params) {
-    StackMgr.push(Val);
+  // Let the profiler sample this stack while running.
+  if (Prof) {
+    Prof->attach(StackMgr);
   }
-
-  // Enter and execute function.
-  AST::InstrView::iterator StartIt;
-  Expect<void> Res = {};
-  if (auto GetIt = enterFunction(StackMgr, Func, Func.getInstrs().end())) {
-    StartIt = *GetIt;
-  } else {
-    if (GetIt.error() == ErrCode::Value::Terminated) {
-      // Handle the terminated case in entering AOT or host functions.
-      // For the terminated case, not return now to print the statistics.
-      Res = Unexpect(GetIt.error());
-    } else {
-      return Unexpect(GetIt);
+  auto DetachProfiler = cxx20::scope_exit([this, &StackMgr]() noexcept {
+    if (Prof) {
+      Prof->detach(StackMgr);
     }
-  }
-  if (Res) {
-    // If not terminated, execute the instructions in interpreter mode.
-    // For the entering AOT or host functions, the `StartIt` is equal to the end
-    // of instruction list, therefore the execution will return immediately.
-    Res = execute(StackMgr, StartIt, Func.getInstrs().end());
-  }
+  });
 
-  if (Res) {
-    spdlog::debug(" Execution succeeded.");
-  } else if (Res.error() == ErrCode::Value::Terminated) {
-    spdlog::debug(" Terminated.");
-  }
+  Expect<void> Res = enterAndExecute(StackMgr, Func, Params);
 
   if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
     Stat->stopRecordWasm();
@@ -65,6 +60,9 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
 
   // If Statistics is enabled, then dump it here.
   if (Stat) {
+    if (const uint64_t Cost = Stat->getTotalCost(); Cost > StartCost) {
+      Metrics::runtime().GasConsumed.add(Cost - StartCost);
+    }
     Stat->dumpToLog(Conf);
   }
 
@@ -73,10 +71,110 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
   }
   if (Res.error() == ErrCode::Value::Terminated) {
     StackMgr.reset();
+  } else {
+    addTrap(Res.error());
   }
   return Unexpect(Res);
 }
 
+Expect<void>
+Executor::runFunctionBatch(Runtime::StackManager &StackMgr,
+                           const Runtime::Instance::FunctionInstance &Func,
+                           uint32_t Count, Span<const ValVariant> Params,
+                           Span<ValVariant> Returns, Span<ErrCode> Errors) {
+  const auto &FuncType = Func.getFuncType();
+  const uint32_t ArgsN = static_cast<uint32_t>(FuncType.getParamTypes().size());
+  const uint32_t RetsN =
+      static_cast<uint32_t>(FuncType.getReturnTypes().size());
+
+  // The statistics and the profiler are set up once for the whole batch.
+  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
+    Stat->startRecordWasm();
+  }
+  const uint64_t StartCost = Stat ? Stat->getTotalCost() : 0;
+  if (Prof) {
+    Prof->attach(StackMgr);
+  }
+  auto DetachProfiler = cxx20::scope_exit([this, &StackMgr]() noexcept {
+    if (Prof) {
+      Prof->detach(StackMgr);
+    }
+  });
+
+  Expect<void> Res = {};
+  for (uint32_t I = 0; I < Count; ++I) {
+    auto CallRes = enterAndExecute(
+        StackMgr, Func, Params.subspan(static_cast<size_t>(I) * ArgsN, ArgsN));
+    if (CallRes) {
+      const auto Rets = StackMgr.getTopSpan(RetsN);
+      std::copy(Rets.begin(), Rets.end(),
+                Returns.begin() + static_cast<size_t>(I) * RetsN);
+    } else if (CallRes.error() != ErrCode::Value::Terminated) {
+      addTrap(CallRes.error());
+    }
+    StackMgr.reset();
+    if (!Errors.empty()) {
+      Errors[I] = CallRes ? ErrCode() : CallRes.error();
+    }
+    // Stop at the first failure without the error list. The termination and
+    // the interruption always stop the batch.
+    if (!CallRes && (Errors.empty() ||
+                     CallRes.error() == ErrCode::Value::Terminated ||
+                     CallRes.error() == ErrCode::Value::Interrupted)) {
+      if (!Errors.empty()) {
+        std::fill(Errors.begin() + I + 1, Errors.begin() + Count,
+                  CallRes.error());
+      }
+      Res = Unexpect(CallRes);
+      break;
+    }
+  }
+
+  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
+    Stat->stopRecordWasm();
+  }
+  if (Stat) {
+    if (const uint64_t Cost = Stat->getTotalCost(); Cost > StartCost) {
+      Metrics::runtime().GasConsumed.add(Cost - StartCost);
+    }
+    Stat->dumpToLog(Conf);
+  }
+  return Res;
+}
+
+Expect<void>
+Executor::enterAndExecute(Runtime::StackManager &StackMgr,
+                          const Runtime::Instance::FunctionInstance &Func,
+                          Span<const ValVariant> Params) {
+  // Reset and push a dummy frame into stack.
+  StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
+
+  // Push arguments.
+  for (auto &Val : Params) {
+    StackMgr.push(Val);
+  }
+
+  // Enter and execute function.
+  // For the entering AOT or host functions, the returned iterator is equal to
+  // the end of instruction list, therefore the execution will return
+  // immediately.
+  auto StartIt = enterFunction(StackMgr, Func, Func.getInstrs().end());
+  if (!StartIt) {
+    if (StartIt.error() == ErrCode::Value::Terminated) {
+      // Handle the terminated case in entering AOT or host functions.
+      spdlog::debug(" Terminated.");
+    }
+    return Unexpect(StartIt);
+  }
+  auto Res = execute(StackMgr, *StartIt, Func.getInstrs().end());
+  if (Res) {
+    spdlog::debug(" Execution succeeded.");
+  } else if (Res.error() == ErrCode::Value::Terminated) {
+    spdlog::debug(" Terminated.");
+  }
+  return Res;
+}
+
 Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
                                const AST::InstrView::iterator Start,
                                const AST::InstrView::iterator End) {
@@ -818,6 +916,12 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::I8x16__shuffle: {
       ValVariant Val2 = StackMgr.pop();
       ValVariant &Val1 = StackMgr.getTop();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+      if (detail::vectorShuffle(Val1.get<uint8x16_t>(), Val2.get<uint8x16_t>(),
+                                Instr.getNum().get<uint8x16_t>())) {
+        return {};
+      }
+#endif
       std::array<uint8_t, 32> Data;
       std::array<uint8_t, 16> Result;
       std::memcpy(&Data[0], &Val1, 16);
@@ -891,6 +995,11 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       ValVariant &Val1 = StackMgr.getTop();
       const uint8x16_t &Index = Val2.get<uint8x16_t>();
       uint8x16_t &Vector = Val1.get<uint8x16_t>();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+      if (detail::vectorSwizzle(Vector, Index)) {
+        return {};
+      }
+#endif
       const uint8x16_t Limit = uint8x16_t{} + 16;
       const uint8x16_t Zero = uint8x16_t{};
       const uint8x16_t Exceed = (Index >= Limit);
@@ -1571,17 +1680,21 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       return runVectorPromoteOp(StackMgr.getTop());
 
     case OpCode::I32x4__dot_i16x8_s: {
-      using int32x8_t [[gnu::vector_size(32)]] = int32_t;
       const ValVariant Val2 = StackMgr.pop();
       ValVariant &Val1 = StackMgr.getTop();
 
       auto &V2 = Val2.get<int16x8_t>();
       auto &V1 = Val1.get<int16x8_t>();
+#if defined(WASMEDGE_VECTOR_INTRINSICS)
+      Val1.emplace<int32x4_t>(detail::vectorDot(V1, V2));
+#else
+      using int32x8_t [[gnu::vector_size(32)]] = int32_t;
       const auto M = __builtin_convertvector(V1, int32x8_t) *
                      __builtin_convertvector(V2, int32x8_t);
       const int32x4_t L = {M[0], M[2], M[4], M[6]};
       const int32x4_t R = {M[1], M[3], M[5], M[7]};
       Val1.emplace<int32x4_t>(L + R);
+#endif
 
       return {};
     }
@@ -1811,7 +1924,50 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     }
   };
 
+  // Basic block tracing of the instrumentation. A block ends at every
+  // instruction which does not continue to the next one.
+  const bool Instrumenting = Prof && Prof->isInstrumenting();
+  AST::InstrView::iterator BlockStart = PC;
+  const Runtime::Instance::FunctionInstance *BlockFunc = nullptr;
+  uint32_t BlockInstrs = 0;
+  auto EndBlock = [&]() {
+    if (BlockInstrs > 0 && BlockFunc) {
+      Prof->addBlock(*BlockFunc, BlockStart->getOffset(), BlockInstrs);
+    }
+    BlockStart = PC;
+    BlockFunc = StackMgr.getFunction();
+    BlockInstrs = 0;
+  };
+  if (unlikely(Instrumenting)) {
+    BlockFunc = StackMgr.getFunction();
+  }
+
   while (PC != PCEnd) {
+    if (unlikely(Instrumenting)) {
+      Prof->addOpCode(PC->getOpCode());
+      ++BlockInstrs;
+      // Count the branch targets from the operand on the stack top.
+      if (const auto *Func = StackMgr.getFunction(); Func != nullptr) {
+        switch (PC->getOpCode()) {
+        case OpCode::If:
+        case OpCode::Br_if:
+          Prof->addBranch(*Func, PC->getOffset(),
+                          StackMgr.getTop().get<uint32_t>() != 0 ? 0 : 1, 2);
+          break;
+        case OpCode::Br_table: {
+          const auto Targets =
+              static_cast<uint32_t>(PC->getLabelList().size());
+          Prof->addBranch(
+              *Func, PC->getOffset(),
+              std::min(StackMgr.getTop().get<uint32_t>(), Targets - 1),
+              Targets);
+          break;
+        }
+        default:
+          break;
+        }
+      }
+    }
     if (Stat) {
       OpCode Code = PC->getOpCode();
       if (Conf.getStatisticsConfigure().isInstructionCounting()) {
@@ -1827,10 +1983,20 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
         }
       }
     }
+    const auto Next = PC + 1;
     if (auto Res = Dispatch(); !Res) {
+      if (unlikely(Instrumenting)) {
+        EndBlock();
+      }
       return Unexpect(Res);
     }
     PC++;
+    if (unlikely(Instrumenting) && PC != Next) {
+      EndBlock();
+    }
+  }
+  if (unlikely(Instrumenting)) {
+    EndBlock();
   }
   return {};
 }
@@ -68,6 +68,7 @@ const AST::Module::IntrinsicsTable Executor::Intrinsics = {
     ENTRY(kPtrFunc, ptrFunc),
     ENTRY(kMemoryAtomicNotify, memoryAtomicNotify),
     ENTRY(kMemoryAtomicWait, memoryAtomicWait),
+    ENTRY(kProfileBlock, profileBlock),
 #undef ENTRY
 };
 
@@ -113,6 +114,20 @@ Expect<void> Executor::call(Runtime::StackManager &StackMgr,
   return {};
 }
 
+Expect<void> Executor::profileBlock(Runtime::StackManager &StackMgr,
+                                    const uint32_t FuncIdx,
+                                    const uint32_t Offset,
+                                    const uint32_t Instrs) noexcept {
+  // The instrumented code only calls in with the opcode counters set, which
+  // come from the instrumenting profiler.
+  assuming(Prof);
+  const auto *ModInst = StackMgr.getModule();
+  assuming(ModInst);
+  const auto *FuncInst = *ModInst->getFunc(FuncIdx);
+  Prof->addBlock(*FuncInst, Offset, Instrs);
+  return {};
+}
+
 Expect<void *> Executor::ptrFunc(Runtime::StackManager &StackMgr,
                                  const uint32_t TableIdx,
                                  const uint32_t FuncTypeIdx,
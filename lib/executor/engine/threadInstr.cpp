@@ -3,6 +3,12 @@
 
 #include "executor/executor.h"
 
+#if WASMEDGE_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace WasmEdge {
 namespace Executor {
 
@@ -10,8 +16,8 @@ Expect<void>
 Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
                             Runtime::Instance::MemoryInstance &MemInst,
                             const AST::Instruction &Instr) {
-  ValVariant RawAddress = StackMgr.pop();
-  ValVariant &RawCount = StackMgr.getTop();
+  ValVariant RawCount = StackMgr.pop();
+  ValVariant &RawAddress = StackMgr.getTop();
 
   uint32_t Address = RawAddress.get<uint32_t>();
 
@@ -34,7 +40,7 @@ Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(Res);
   } else {
-    RawCount.emplace<uint32_t>(*Res);
+    RawAddress.emplace<uint32_t>(*Res);
   }
   return {};
 }
@@ -51,25 +57,119 @@ Executor::atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
     return UINT32_C(0);
   }
 
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
+  WaiterBucket &Bucket = getWaiterBucket(&MemInst, Address);
+  std::unique_lock<decltype(Bucket.Mutex)> Locker(Bucket.Mutex);
   uint32_t Total = 0;
-  auto Range = WaiterMap.equal_range(Address);
-  for (auto Iterator = Range.first; Total < Count && Iterator != Range.second;
-       ++Iterator) {
-    if (likely(&MemInst == Iterator->second.MemInst)) {
-      Iterator->second.Cond.notify_all();
+  for (Waiter *W = Bucket.Head; Total < Count && W != nullptr;) {
+    Waiter *Next = W->Next;
+    if (W->MemInst == &MemInst && W->Address == Address) {
+      Bucket.erase(*W);
+      unparkWaiter(*W);
       ++Total;
     }
+    W = Next;
   }
   return Total;
 }
 
 void Executor::atomicNotifyAll() noexcept {
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-  for (auto Iterator = WaiterMap.begin(); Iterator != WaiterMap.end();
-       ++Iterator) {
-    Iterator->second.Cond.notify_all();
+  for (auto &Bucket : WaiterBuckets) {
+    std::unique_lock<decltype(Bucket.Mutex)> Locker(Bucket.Mutex);
+    while (Bucket.Head != nullptr) {
+      Waiter &W = *Bucket.Head;
+      Bucket.erase(W);
+      unparkWaiter(W);
+    }
+  }
+}
+
+Executor::WaiterBucket &
+Executor::getWaiterBucket(const Runtime::Instance::MemoryInstance *MemInst,
+                          uint32_t Address) noexcept {
+  // Fibonacci hashing of the (memory, address) pair.
+  const uint64_t Key =
+      static_cast<uint64_t>(reinterpret_cast<uintptr_t>(MemInst)) ^
+      (static_cast<uint64_t>(Address) << 2);
+  const uint64_t Hash = Key * UINT64_C(0x9E3779B97F4A7C15);
+  return WaiterBuckets[static_cast<size_t>(Hash >> 56) % WaiterBucketCount];
+}
+
+#if WASMEDGE_OS_LINUX
+void Executor::parkWaiter(Waiter &W,
+                          const std::optional<WaitTimePoint> &Until) noexcept {
+  // steady_clock is CLOCK_MONOTONIC, which is also the default clock of an
+  // absolute FUTEX_WAIT_BITSET timeout.
+  struct timespec Deadline;
+  struct timespec *DeadlinePtr = nullptr;
+  if (Until) {
+    const auto Nano = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          Until->time_since_epoch())
+                          .count();
+    Deadline.tv_sec = static_cast<time_t>(Nano / 1000000000);
+    Deadline.tv_nsec = static_cast<long>(Nano % 1000000000);
+    DeadlinePtr = &Deadline;
+  }
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&W.Notified),
+          FUTEX_WAIT_BITSET_PRIVATE, UINT32_C(0), DeadlinePtr, nullptr,
+          FUTEX_BITSET_MATCH_ANY);
+}
+
+void Executor::unparkWaiter(Waiter &W) noexcept {
+  W.Notified.store(1, std::memory_order_release);
+  // The waiter may observe the flag and leave before this wake happens, which
+  // at worst produces a spurious wakeup on a reused address. Every futex user,
+  // including parkWaiter, tolerates that.
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&W.Notified),
+          FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#else
+void Executor::parkWaiter(Waiter &W,
+                          const std::optional<WaitTimePoint> &Until) noexcept {
+  std::unique_lock<decltype(W.Mutex)> Locker(W.Mutex);
+  if (W.Notified.load(std::memory_order_acquire) != 0) {
+    return;
+  }
+  if (Until) {
+    W.Cond.wait_until(Locker, *Until);
+  } else {
+    W.Cond.wait(Locker);
+  }
+}
+
+void Executor::unparkWaiter(Waiter &W) noexcept {
+  // Notify under the waiter's lock, so that the waiter can not destroy the
+  // condition variable before this notification completes.
+  std::unique_lock<decltype(W.Mutex)> Locker(W.Mutex);
+  W.Notified.store(1, std::memory_order_release);
+  W.Cond.notify_one();
+}
+#endif
+
+Expect<uint32_t>
+Executor::waitNotified(WaiterBucket &Bucket, Waiter &W,
+                       const std::optional<WaitTimePoint> &Until) noexcept {
+  while (W.Notified.load(std::memory_order_acquire) == 0) {
+    if (Until && std::chrono::steady_clock::now() >= *Until) {
+      std::unique_lock<decltype(Bucket.Mutex)> Locker(Bucket.Mutex);
+      // A notifier may have dequeued this waiter in the meantime, in which
+      // case it has already been counted and must report as woken.
+      if (W.Notified.load(std::memory_order_acquire) == 0) {
+        Bucket.erase(W);
+        return UINT32_C(2); // Timed-out
+      }
+      break;
+    }
+    parkWaiter(W, Until);
+  }
+#if !WASMEDGE_OS_LINUX
+  // Wait for unparkWaiter to release the lock before the waiter is destroyed.
+  { std::unique_lock<decltype(W.Mutex)> Locker(W.Mutex); }
+#endif
+  if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
+    spdlog::error(ErrCode::Value::Interrupted);
+    return Unexpect(ErrCode::Value::Interrupted);
   }
+  return UINT32_C(0); // ok
 }
 
 } // namespace Executor
@@ -6,9 +6,46 @@
 #include "common/errinfo.h"
 #include "common/log.h"
 
+#include <algorithm>
+#include <optional>
+
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+
+/// Stack manager of an invocation. The stack manager of this thread is reused
+/// if it is not in use by an outer invocation, which avoids the allocation and
+/// page faults of a new stack for every call on long-lived threads.
+class InvocationStack {
+public:
+  InvocationStack() noexcept {
+    if (unlikely(ThreadStackMgrInUse)) {
+      StackMgr = &LocalStackMgr.emplace();
+    } else {
+      ThreadStackMgrInUse = true;
+    }
+  }
+  ~InvocationStack() noexcept {
+    if (StackMgr == &ThreadStackMgr) {
+      ThreadStackMgr.reset();
+      ThreadStackMgrInUse = false;
+    }
+  }
+  InvocationStack(const InvocationStack &) = delete;
+  InvocationStack &operator=(const InvocationStack &) = delete;
+
+  Runtime::StackManager &get() noexcept { return *StackMgr; }
+
+private:
+  static inline thread_local Runtime::StackManager ThreadStackMgr;
+  static inline thread_local bool ThreadStackMgrInUse = false;
+  std::optional<Runtime::StackManager> LocalStackMgr;
+  Runtime::StackManager *StackMgr = &ThreadStackMgr;
+};
+
+} // namespace
+
 /// Instantiate a WASM Module. See "include/executor/executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
@@ -72,7 +109,8 @@ Executor::invoke(const Runtime::Instance::FunctionInstance &FuncInst,
     return Unexpect(ErrCode::Value::FuncSigMismatch);
   }
 
-  Runtime::StackManager StackMgr;
+  InvocationStack Stack;
+  Runtime::StackManager &StackMgr = Stack.get();
 
   // Call runFunction.
   if (auto Res = runFunction(StackMgr, FuncInst, Params); !Res) {
@@ -91,5 +129,49 @@ Executor::invoke(const Runtime::Instance::FunctionInstance &FuncInst,
   return Returns;
 }
 
+// Invoke function for a batch. See "include/executor/executor.h".
+Expect<void>
+Executor::invokeBatch(const Runtime::Instance::FunctionInstance &FuncInst,
+                      uint32_t Count, Span<const ValVariant> Params,
+                      Span<ValVariant> Returns, Span<ErrCode> Errors) {
+  const auto &FuncType = FuncInst.getFuncType();
+  const uint64_t ArgsN = FuncType.getParamTypes().size();
+  const uint64_t RetsN = FuncType.getReturnTypes().size();
+  if (unlikely(Params.size() != Count * ArgsN ||
+               Returns.size() < Count * RetsN ||
+               (!Errors.empty() && Errors.size() < Count))) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
+
+  InvocationStack Stack;
+  return runFunctionBatch(Stack.get(), FuncInst, Count, Params, Returns,
+                          Errors);
+}
+
+// Invoke function in place. See "include/executor/executor.h".
+Expect<void>
+Executor::invokeUnchecked(const Runtime::Instance::FunctionInstance &FuncInst,
+                          Span<const ValVariant> Params,
+                          Span<ValVariant> Returns) {
+  const uint32_t RetsN =
+      static_cast<uint32_t>(FuncInst.getFuncType().getReturnTypes().size());
+  assuming(Returns.size() >= RetsN);
+
+  InvocationStack Stack;
+  Runtime::StackManager &StackMgr = Stack.get();
+
+  // Call runFunction.
+  if (auto Res = runFunction(StackMgr, FuncInst, Params); !Res) {
+    return Unexpect(Res);
+  }
+
+  // Copy the return values out. The stack is cleared when released.
+  assuming(StackMgr.size() == RetsN);
+  const auto Rets = StackMgr.getTopSpan(RetsN);
+  std::copy(Rets.begin(), Rets.end(), Returns.begin());
+  return {};
+}
+
 } // namespace Executor
 } // namespace WasmEdge
@@ -4,8 +4,11 @@
 #include "executor/executor.h"
 
 #include "common/log.h"
+#include "common/metrics.h"
 #include "system/fault.h"
+#include "system/fiber.h"
 
+#include <chrono>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -13,6 +16,39 @@
 namespace WasmEdge {
 namespace Executor {
 
+Expect<void> Executor::suspendHostFunction() noexcept {
+  if (unlikely(Fiber::current() == nullptr)) {
+    // Not running on a fiber, nothing can resume this execution.
+    spdlog::error(ErrCode::Value::HostFuncPending);
+    return Unexpect(ErrCode::Value::HostFuncPending);
+  }
+  // Other fibers may run other executors on this thread in the meantime.
+  Executor *SavedThis = This;
+  Runtime::StackManager *SavedStack = CurrentStack;
+  ExecutionContextStruct SavedContext = ExecutionContext;
+  Fiber::yield();
+  This = SavedThis;
+  CurrentStack = SavedStack;
+  ExecutionContext = SavedContext;
+
+  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+    spdlog::error(ErrCode::Value::Interrupted);
+    return Unexpect(ErrCode::Value::Interrupted);
+  }
+  return {};
+}
+
+const Runtime::Instance::ModuleInstance::HostNative *Executor::getHostNatives(
+    const Runtime::Instance::ModuleInstance &ModInst) const noexcept {
+  // The metrics and the statistics switch their timers around the host
+  // functions on the full path.
+  if (Metrics::isEnabled() ||
+      (Stat && Conf.getStatisticsConfigure().isTimeMeasuring())) {
+    return nullptr;
+  }
+  return ModInst.HostNatives.data();
+}
+
 Expect<AST::InstrView::iterator>
 Executor::enterFunction(Runtime::StackManager &StackMgr,
                         const Runtime::Instance::FunctionInstance &Func,
@@ -49,7 +85,8 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        RetIt,            // Return PC
                        ArgsN,            // Only args, no locals in stack
                        RetsN,            // Returns num
-                       IsTailCall        // For tail-call
+                       IsTailCall,       // For tail-call
+                       &Func             // Function instance
     );
 
     // Do the statistics if the statistics turned on.
@@ -64,10 +101,33 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       Stat->startRecordHost();
     }
 
-    // Run host function.
-    Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
-    std::vector<ValVariant> Rets(RetsN);
-    auto Ret = HostFunc.run(CallFrame, std::move(Args), Rets);
+    // Time the host function call if the metrics turned on.
+    const auto *CallMetrics =
+        Metrics::isEnabled() ? HostFunc.getMetrics() : nullptr;
+    std::chrono::steady_clock::time_point CallStart;
+    if (CallMetrics) {
+      CallStart = std::chrono::steady_clock::now();
+    }
+
+    // Run host function. The returns are written in place into the slots
+    // above the arguments, which are left as the results when the frame is
+    // popped.
+    Span<ValVariant> Rets = StackMgr.pushSpan(RetsN);
+    Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN + RetsN).first(ArgsN);
+    auto Ret = HostFunc.run(CallFrame, Args, Rets);
+    while (unlikely(!Ret && Ret.error() == ErrCode::Value::HostFuncPending)) {
+      // The host function would block. Suspend and retry it when ready.
+      if (auto Res = suspendHostFunction(); !Res) {
+        Ret = Unexpect(Res);
+        break;
+      }
+      Ret = HostFunc.run(CallFrame, Args, Rets);
+    }
+    if (CallMetrics) {
+      CallMetrics->Calls.add();
+      CallMetrics->Latency.observe(std::chrono::steady_clock::now() -
+                                   CallStart);
+    }
 
     // Do the statistics if the statistics turned on.
     if (Stat) {
@@ -85,11 +145,6 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       return Unexpect(Ret);
     }
 
-    // Push returns back to stack.
-    for (auto &R : Rets) {
-      StackMgr.push(std::move(R));
-    }
-
     // For host function case, the continuation will be the continuation from
     // the popped frame.
     return StackMgr.popFrame();
@@ -102,7 +157,8 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        RetIt,            // Return PC
                        ArgsN,            // Only args, no locals in stack
                        RetsN,            // Returns num
-                       IsTailCall        // For tail-call
+                       IsTailCall,       // For tail-call
+                       &Func             // Function instance
     );
 
     // Prepare arguments.
@@ -125,6 +181,9 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       }
       ExecutionContext.Memories = ModInst->MemoryPtrs.data();
       ExecutionContext.Globals = ModInst->GlobalPtrs.data();
+      ExecutionContext.OpCodeCounts =
+          Prof ? Prof->getOpCodeCounters() : nullptr;
+      ExecutionContext.HostNatives = getHostNatives(*ModInst);
     }
 
     {
@@ -153,6 +212,9 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
     return StackMgr.popFrame();
   } else {
     // Native function case: Jump to the start of the function body.
+    if (unlikely(Prof && Prof->isInstrumenting())) {
+      Prof->addCall(Func);
+    }
 
     // Push local variables into the stack.
     for (auto &Def : Func.getLocals()) {
@@ -168,7 +230,8 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        RetIt - 1,                  // Return PC
                        ArgsN + Func.getLocalNum(), // Arguments num + local num
                        RetsN,                      // Returns num
-                       IsTailCall                  // For tail-call
+                       IsTailCall,                 // For tail-call
+                       &Func                       // Function instance
     );
 
     // For native function case, the continuation will be the start of the
@@ -17,21 +17,22 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
     // Get data from the export description.
     const auto ExtType = ExpDesc.getExternalType();
     std::string_view ExtName = ExpDesc.getExternalName();
+    const uint64_t ExtHash = ExpDesc.getExternalNameHash();
     const uint32_t ExtIdx = ExpDesc.getExternalIndex();
 
     // Export the instance with the name.
     switch (ExtType) {
     case ExternalType::Function:
-      ModInst.exportFunction(ExtName, ExtIdx);
+      ModInst.exportFunction(ExtName, ExtHash, ExtIdx);
       break;
     case ExternalType::Global:
-      ModInst.exportGlobal(ExtName, ExtIdx);
+      ModInst.exportGlobal(ExtName, ExtHash, ExtIdx);
       break;
     case ExternalType::Memory:
-      ModInst.exportMemory(ExtName, ExtIdx);
+      ModInst.exportMemory(ExtName, ExtHash, ExtIdx);
       break;
     case ExternalType::Table:
-      ModInst.exportTable(ExtName, ExtIdx);
+      ModInst.exportTable(ExtName, ExtHash, ExtIdx);
       break;
     default:
       break;
@@ -5,8 +5,10 @@
 
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "runtime/callingframe.h"
 
 #include <cstdint>
+#include <new>
 #include <string_view>
 #include <utility>
 
@@ -47,26 +49,30 @@ bool isLimitMatched(const AST::Limit &Lim1, const AST::Limit &Lim2) {
 
 Expect<void>
 checkImportMatched(std::string_view ModName, std::string_view ExtName,
-                   const ExternalType ExtType,
+                   const uint64_t ExtHash, const ExternalType ExtType,
                    const Runtime::Instance::ModuleInstance &ModInst) {
   switch (ExtType) {
   case ExternalType::Function:
-    if (auto Res = ModInst.findFuncExports(ExtName); likely(Res != nullptr)) {
+    if (auto Res = ModInst.findFuncExports(ExtName, ExtHash);
+        likely(Res != nullptr)) {
       return {};
     }
     break;
   case ExternalType::Table:
-    if (auto Res = ModInst.findTableExports(ExtName); likely(Res != nullptr)) {
+    if (auto Res = ModInst.findTableExports(ExtName, ExtHash);
+        likely(Res != nullptr)) {
       return {};
     }
     break;
   case ExternalType::Memory:
-    if (auto Res = ModInst.findMemoryExports(ExtName); likely(Res != nullptr)) {
+    if (auto Res = ModInst.findMemoryExports(ExtName, ExtHash);
+        likely(Res != nullptr)) {
       return {};
     }
     break;
   case ExternalType::Global:
-    if (auto Res = ModInst.findGlobalExports(ExtName); likely(Res != nullptr)) {
+    if (auto Res = ModInst.findGlobalExports(ExtName, ExtHash);
+        likely(Res != nullptr)) {
       return {};
     }
     break;
@@ -75,19 +81,19 @@ checkImportMatched(std::string_view ModName, std::string_view ExtName,
   }
 
   // Check is error external type or unknown imports.
-  if (ModInst.findFuncExports(ExtName)) {
+  if (ModInst.findFuncExports(ExtName, ExtHash)) {
     return logMatchError(ModName, ExtName, ExtType, ExtType,
                          ExternalType::Function);
   }
-  if (ModInst.findTableExports(ExtName)) {
+  if (ModInst.findTableExports(ExtName, ExtHash)) {
     return logMatchError(ModName, ExtName, ExtType, ExtType,
                          ExternalType::Table);
   }
-  if (ModInst.findMemoryExports(ExtName)) {
+  if (ModInst.findMemoryExports(ExtName, ExtHash)) {
     return logMatchError(ModName, ExtName, ExtType, ExtType,
                          ExternalType::Memory);
   }
-  if (ModInst.findGlobalExports(ExtName)) {
+  if (ModInst.findGlobalExports(ExtName, ExtHash)) {
     return logMatchError(ModName, ExtName, ExtType, ExtType,
                          ExternalType::Global);
   }
@@ -106,12 +112,14 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
     auto ExtType = ImpDesc.getExternalType();
     auto ModName = ImpDesc.getModuleName();
     auto ExtName = ImpDesc.getExternalName();
-    const auto *TargetModInst = StoreMgr.findModule(ModName);
+    auto ExtHash = ImpDesc.getExternalNameHash();
+    const auto *TargetModInst =
+        StoreMgr.findModule(ModName, ImpDesc.getModuleNameHash());
     if (unlikely(TargetModInst == nullptr)) {
       return logUnknownError(ModName, ExtName, ExtType);
     }
-    if (auto Res =
-            checkImportMatched(ModName, ExtName, ExtType, *TargetModInst);
+    if (auto Res = checkImportMatched(ModName, ExtName, ExtHash, ExtType,
+                                      *TargetModInst);
         unlikely(!Res)) {
       return Unexpect(Res);
     }
@@ -122,7 +130,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       // Get function type index. External type checked in validation.
       uint32_t TypeIdx = ImpDesc.getExternalFuncTypeIdx();
       // Import matching.
-      auto *TargetInst = TargetModInst->findFuncExports(ExtName);
+      auto *TargetInst = TargetModInst->findFuncExports(ExtName, ExtHash);
       const auto &TargetType = TargetInst->getFuncType();
       const auto *FuncType = *ModInst.getFuncType(TypeIdx);
       if (TargetType != *FuncType) {
@@ -140,7 +148,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       const auto &TabType = ImpDesc.getExternalTableType();
       const auto &TabLim = TabType.getLimit();
       // Import matching.
-      auto *TargetInst = TargetModInst->findTableExports(ExtName);
+      auto *TargetInst = TargetModInst->findTableExports(ExtName, ExtHash);
       const auto &TargetType = TargetInst->getTableType();
       const auto &TargetLim = TargetType.getLimit();
       if (TargetType.getRefType() != TabType.getRefType() ||
@@ -159,7 +167,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       const auto &MemType = ImpDesc.getExternalMemoryType();
       const auto &MemLim = MemType.getLimit();
       // Import matching.
-      auto *TargetInst = TargetModInst->findMemoryExports(ExtName);
+      auto *TargetInst = TargetModInst->findMemoryExports(ExtName, ExtHash);
       const auto &TargetLim = TargetInst->getMemoryType().getLimit();
       if (!isLimitMatched(TargetLim, MemLim)) {
         return logMatchError(ModName, ExtName, ExtType, MemLim.hasMax(),
@@ -175,7 +183,7 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       // Get global type. External type checked in validation.
       const auto &GlobType = ImpDesc.getExternalGlobalType();
       // Import matching.
-      auto *TargetInst = TargetModInst->findGlobalExports(ExtName);
+      auto *TargetInst = TargetModInst->findGlobalExports(ExtName, ExtHash);
       const auto &TargetType = TargetInst->getGlobalType();
       if (TargetType != GlobType) {
         return logMatchError(ModName, ExtName, ExtType, GlobType.getValType(),
@@ -190,6 +198,27 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       break;
     }
   }
+
+  // Resolve the native entries of the imported host functions once for the
+  // import trampolines of the compiled code. The charged calls are left to
+  // the full path.
+  ModInst.HostNatives.resize(ModInst.getFuncNum());
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    const auto *FuncInst = *ModInst.getFunc(I);
+    if (!FuncInst->isHostFunction()) {
+      continue;
+    }
+    auto &HostFunc = FuncInst->getHostFunc();
+    auto &Slot = ModInst.HostNatives[I];
+    if (HostFunc.getNativeEntry() == nullptr ||
+        (Stat && HostFunc.getCost() != 0)) {
+      continue;
+    }
+    Slot.Entry = HostFunc.getNativeEntry();
+    Slot.Self = &HostFunc;
+    static_assert(sizeof(Runtime::CallingFrame) == sizeof(Slot.Frame));
+    new (Slot.Frame) Runtime::CallingFrame(this, &ModInst);
+  }
   return {};
 }
 
@@ -5,7 +5,11 @@
 
 #include "common/errinfo.h"
 #include "common/log.h"
+#include "common/metrics.h"
 
+#include <experimental/scope.hpp>
+
+#include <chrono>
 #include <cstdint>
 #include <string_view>
 
@@ -16,6 +20,13 @@ namespace Executor {
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
                       std::optional<std::string_view> Name) {
+  // Record the instantiation latency.
+  const auto Start = std::chrono::steady_clock::now();
+  auto RecordLatency = cxx20::scope_exit([Start]() noexcept {
+    Metrics::runtime().InstantiationLatency.observe(
+        std::chrono::steady_clock::now() - Start);
+  });
+
   // Check the module is validated.
   if (unlikely(!Mod.getIsValidated())) {
     spdlog::error(ErrCode::Value::NotValidated);
@@ -36,6 +47,23 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
     }
   }
 
+  // The AOT code may have the functions of the linked modules compiled in,
+  // which is only valid if the same modules are registered.
+  if (Mod.getSymbol()) {
+    for (const auto &[LinkName, Hash] :
+         Mod.getAOTSection().getLinkedModules()) {
+      const auto *LinkInst = StoreMgr.findModule(LinkName);
+      if (LinkInst == nullptr || LinkInst->getCodeHash() != Hash) {
+        spdlog::error(ErrCode::Value::IncompatibleImportType);
+        spdlog::error("    Linked module {} is not registered as compiled, "
+                      "compile the module again.",
+                      LinkName);
+        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+        return Unexpect(ErrCode::Value::IncompatibleImportType);
+      }
+    }
+  }
+
   // Insert the module instance to store manager and retrieve instance.
   std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst;
   if (Name.has_value()) {
@@ -43,6 +71,7 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   } else {
     ModInst = std::make_unique<Runtime::Instance::ModuleInstance>("");
   }
+  ModInst->setCodeHash(Mod.getCodeHash());
 
   // Instantiate Function Types in Module Instance. (TypeSec)
   for (auto &FuncType : Mod.getTypeSection().getContent()) {
@@ -105,6 +134,11 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   // This function will always success.
   instantiate(*ModInst, ExportSec);
 
+  // Register the function names to the profiler before running any function.
+  if (Prof) {
+    Prof->addNameSection(*ModInst, Mod);
+  }
+
   // Push a new frame {ModInst, locals:none}
   StackMgr.pushFrame(ModInst.get(), AST::InstrView::iterator(), 0, 0);
 
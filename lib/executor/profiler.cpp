@@ -0,0 +1,400 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/profiler.h"
+
+#include <algorithm>
+#include <shared_mutex>
+#include <utility>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+
+using namespace std::literals;
+
+void writeJSONString(std::ostream &OS, std::string_view Str) {
+  static constexpr char Hex[] = "0123456789abcdef";
+  OS << '"';
+  for (const char C : Str) {
+    if (C == '"' || C == '\\') {
+      OS << '\\' << C;
+    } else if (const auto U = static_cast<unsigned char>(C); U < 0x20U) {
+      OS << "\\u00" << Hex[U >> 4] << Hex[U & 0x0FU];
+    } else {
+      OS << C;
+    }
+  }
+  OS << '"';
+}
+
+void writeCSVField(std::ostream &OS, std::string_view Str) {
+  if (Str.find_first_of(",\"\r\n"sv) == std::string_view::npos) {
+    OS << Str;
+    return;
+  }
+  OS << '"';
+  for (const char C : Str) {
+    if (C == '"') {
+      OS << '"';
+    }
+    OS << C;
+  }
+  OS << '"';
+}
+
+template <typename T> void sortByInstrs(std::vector<T> &Counts) {
+  std::stable_sort(Counts.begin(), Counts.end(),
+                   [](const T &LHS, const T &RHS) {
+                     return LHS.second.Instrs > RHS.second.Instrs;
+                   });
+}
+
+} // namespace
+
+void Profiler::start() {
+  std::unique_lock Lock(Mutex);
+  if (Sampler.joinable()) {
+    return;
+  }
+  Stopping = false;
+  Sampler = std::thread([this]() noexcept { run(); });
+}
+
+void Profiler::stop() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopping = true;
+  }
+  StopCond.notify_all();
+  if (Sampler.joinable()) {
+    Sampler.join();
+  }
+}
+
+void Profiler::attach(const Runtime::StackManager &StackMgr) {
+  std::unique_lock Lock(Mutex);
+  Stacks.push_back(&StackMgr);
+}
+
+void Profiler::detach(const Runtime::StackManager &StackMgr) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto Iter = std::find(Stacks.begin(), Stacks.end(), &StackMgr);
+      Iter != Stacks.end()) {
+    Stacks.erase(Iter);
+  }
+}
+
+void Profiler::addNameSection(const Runtime::Instance::ModuleInstance &ModInst,
+                              const AST::Module &Mod) {
+  std::unique_lock Lock(Mutex);
+  // Drop the names of a destroyed module at the same address.
+  Names.erase(&ModInst);
+  if (!Mod.getFunctionNames().empty()) {
+    Names.emplace(&ModInst, Mod.getFunctionNames());
+  }
+}
+
+uint64_t Profiler::getSampleCount() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return SampleCount;
+}
+
+std::map<Profiler::FuncStack, uint64_t> Profiler::getSamples() const {
+  std::unique_lock Lock(Mutex);
+  return Samples;
+}
+
+void Profiler::dumpFolded(std::ostream &OS) const {
+  for (const auto &[Stack, Count] : getSamples()) {
+    bool First = true;
+    for (const auto *Func : Stack) {
+      if (!First) {
+        OS << ';';
+      }
+      First = false;
+      OS << symbolize(*Func);
+    }
+    OS << ' ' << Count << '\n';
+  }
+}
+
+std::string
+Profiler::symbolize(const Runtime::Instance::FunctionInstance &Func) const {
+  const auto *ModInst = Func.getModule();
+  if (ModInst == nullptr) {
+    return "<unknown>"s;
+  }
+  std::string Symbol(ModInst->getModuleName());
+  if (!Symbol.empty()) {
+    Symbol += "::"sv;
+  }
+
+  std::shared_lock ModLock(ModInst->Mutex);
+  // The index in the function index space of the defining module.
+  const auto &FuncInsts = ModInst->FuncInsts;
+  const auto Iter = std::find(FuncInsts.begin(), FuncInsts.end(), &Func);
+  const auto Index = static_cast<uint32_t>(Iter - FuncInsts.begin());
+  {
+    std::unique_lock Lock(Mutex);
+    if (auto ModIter = Names.find(ModInst); ModIter != Names.end()) {
+      if (auto NameIter = ModIter->second.find(Index);
+          NameIter != ModIter->second.end()) {
+        return Symbol + NameIter->second;
+      }
+    }
+  }
+  for (const auto &[Name, Exported] : ModInst->ExpFuncs) {
+    if (Exported == &Func) {
+      return Symbol + Name;
+    }
+  }
+  return Symbol + "func["s + std::to_string(Index) + ']';
+}
+
+void Profiler::setInstrumentation(bool Enable) {
+  if (Enable && !OpCodeCounts) {
+    OpCodeCounts = std::make_unique<
+        std::array<std::atomic_uint64_t, UINT16_MAX + 1>>();
+  }
+  Instrumenting = Enable;
+}
+
+uint64_t Profiler::newId() noexcept {
+  static std::atomic_uint64_t NextId = 1;
+  return NextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+Profiler::Shard &Profiler::getShard() {
+  // Only the first event of a thread on a profiler takes the profiler lock.
+  thread_local uint64_t CachedId = 0;
+  thread_local Shard *Cached = nullptr;
+  if (CachedId != Id) {
+    std::unique_lock Lock(Mutex);
+    auto &Owned = Shards[std::this_thread::get_id()];
+    if (!Owned) {
+      Owned = std::make_unique<Shard>();
+    }
+    Cached = Owned.get();
+    CachedId = Id;
+  }
+  return *Cached;
+}
+
+template <typename FuncT> void Profiler::forEachShard(FuncT &&Func) const {
+  std::unique_lock Lock(Mutex);
+  for (const auto &[ThreadId, Owned] : Shards) {
+    std::unique_lock ShardLock(Owned->Mutex);
+    Func(std::as_const(*Owned));
+  }
+}
+
+void Profiler::addBlock(const Runtime::Instance::FunctionInstance &Func,
+                        uint32_t Offset, uint32_t Instrs) {
+  auto &Local = getShard();
+  std::unique_lock Lock(Local.Mutex);
+  auto &Block = Local.Blocks[BlockKey(&Func, Offset)];
+  ++Block.Count;
+  Block.Instrs += Instrs;
+}
+
+void Profiler::addCall(const Runtime::Instance::FunctionInstance &Func) {
+  auto &Local = getShard();
+  std::unique_lock Lock(Local.Mutex);
+  ++Local.Calls[&Func];
+}
+
+void Profiler::addBranch(const Runtime::Instance::FunctionInstance &Func,
+                         uint32_t Offset, uint32_t Target, uint32_t Targets) {
+  auto &Local = getShard();
+  std::unique_lock Lock(Local.Mutex);
+  auto &Counts = Local.Branches[BlockKey(&Func, Offset)];
+  if (Counts.size() < Targets) {
+    Counts.resize(Targets);
+  }
+  ++Counts[Target];
+}
+
+uint64_t Profiler::getOpCodeCount(OpCode Code) const noexcept {
+  if (!OpCodeCounts) {
+    return 0;
+  }
+  return (*OpCodeCounts)[static_cast<uint16_t>(Code)].load(
+      std::memory_order_relaxed);
+}
+
+std::map<Profiler::BlockKey, Profiler::BlockCount>
+Profiler::getBlocks() const {
+  std::map<BlockKey, BlockCount> AllBlocks;
+  forEachShard([&AllBlocks](const Shard &Local) {
+    for (const auto &[Key, Block] : Local.Blocks) {
+      auto &Sum = AllBlocks[Key];
+      Sum.Count += Block.Count;
+      Sum.Instrs += Block.Instrs;
+    }
+  });
+  return AllBlocks;
+}
+
+std::vector<
+    std::pair<const Runtime::Instance::FunctionInstance *, Profiler::BlockCount>>
+Profiler::getFunctionCounts(
+    const std::map<BlockKey, BlockCount> &AllBlocks) const {
+  std::vector<std::pair<const Runtime::Instance::FunctionInstance *,
+                        BlockCount>>
+      Counts;
+  // The blocks of a function are adjacent in the map.
+  for (const auto &[Key, Block] : AllBlocks) {
+    if (Counts.empty() || Counts.back().first != Key.first) {
+      Counts.emplace_back(Key.first, BlockCount{});
+    }
+    Counts.back().second.Count += Block.Count;
+    Counts.back().second.Instrs += Block.Instrs;
+  }
+  sortByInstrs(Counts);
+  return Counts;
+}
+
+std::vector<std::pair<OpCode, uint64_t>> Profiler::getOpCodeCounts() const {
+  std::vector<std::pair<OpCode, uint64_t>> OpCodes;
+  for (uint32_t I = 0; OpCodeCounts && I <= UINT16_MAX; ++I) {
+    if (const auto Count = (*OpCodeCounts)[I].load(std::memory_order_relaxed)) {
+      OpCodes.emplace_back(static_cast<OpCode>(I), Count);
+    }
+  }
+  std::stable_sort(OpCodes.begin(), OpCodes.end(),
+                   [](const auto &LHS, const auto &RHS) {
+                     return LHS.second > RHS.second;
+                   });
+  return OpCodes;
+}
+
+std::vector<std::pair<Profiler::BlockKey, Profiler::BlockCount>>
+Profiler::getSortedBlocks(const std::map<BlockKey, BlockCount> &AllBlocks) {
+  std::vector<std::pair<BlockKey, BlockCount>> SortedBlocks(AllBlocks.begin(),
+                                                            AllBlocks.end());
+  sortByInstrs(SortedBlocks);
+  return SortedBlocks;
+}
+
+void Profiler::dumpInstrJSON(std::ostream &OS) const {
+  const auto AllBlocks = getBlocks();
+  const char *Sep = "";
+
+  OS << "{\n  \"opcodes\": [";
+  for (const auto &[Code, Count] : getOpCodeCounts()) {
+    OS << Sep << "\n    {\"name\": ";
+    writeJSONString(OS, OpCodeStr[Code]);
+    OS << ", \"count\": " << Count << '}';
+    Sep = ",";
+  }
+
+  OS << "\n  ],\n  \"functions\": [";
+  Sep = "";
+  for (const auto &[Func, Count] : getFunctionCounts(AllBlocks)) {
+    OS << Sep << "\n    {\"name\": ";
+    writeJSONString(OS, symbolize(*Func));
+    OS << ", \"instructions\": " << Count.Instrs << '}';
+    Sep = ",";
+  }
+
+  OS << "\n  ],\n  \"blocks\": [";
+  Sep = "";
+  for (const auto &[Key, Count] : getSortedBlocks(AllBlocks)) {
+    OS << Sep << "\n    {\"function\": ";
+    writeJSONString(OS, symbolize(*Key.first));
+    OS << ", \"offset\": " << Key.second << ", \"count\": " << Count.Count
+       << ", \"instructions\": " << Count.Instrs << '}';
+    Sep = ",";
+  }
+  OS << "\n  ]\n}\n";
+}
+
+void Profiler::dumpInstrCSV(std::ostream &OS) const {
+  const auto AllBlocks = getBlocks();
+  OS << "kind,name,offset,count,instructions\n";
+  for (const auto &[Code, Count] : getOpCodeCounts()) {
+    OS << "opcode,";
+    writeCSVField(OS, OpCodeStr[Code]);
+    OS << ",," << Count << ',' << Count << '\n';
+  }
+  for (const auto &[Func, Count] : getFunctionCounts(AllBlocks)) {
+    OS << "function,";
+    writeCSVField(OS, symbolize(*Func));
+    OS << ",," << Count.Count << ',' << Count.Instrs << '\n';
+  }
+  for (const auto &[Key, Count] : getSortedBlocks(AllBlocks)) {
+    OS << "block,";
+    writeCSVField(OS, symbolize(*Key.first));
+    OS << ',' << Key.second << ',' << Count.Count << ',' << Count.Instrs
+       << '\n';
+  }
+}
+
+PGO::Profile Profiler::getPGOProfile() const {
+  std::map<const Runtime::Instance::FunctionInstance *, uint64_t> AllCalls;
+  std::map<BlockKey, std::vector<uint64_t>> AllBranches;
+  forEachShard([&AllCalls, &AllBranches](const Shard &Local) {
+    for (const auto &[Func, Count] : Local.Calls) {
+      AllCalls[Func] += Count;
+    }
+    for (const auto &[Key, Counts] : Local.Branches) {
+      auto &Sum = AllBranches[Key];
+      if (Sum.size() < Counts.size()) {
+        Sum.resize(Counts.size());
+      }
+      for (size_t I = 0; I < Counts.size(); ++I) {
+        Sum[I] += Counts[I];
+      }
+    }
+  });
+
+  PGO::Profile Profile;
+  // The functions are keyed by the index in the function index space of the
+  // defining module, as the compiler sees them.
+  auto Locate = [&Profile](const Runtime::Instance::FunctionInstance &Func)
+      -> PGO::FunctionProfile * {
+    const auto *ModInst = Func.getModule();
+    if (ModInst == nullptr) {
+      return nullptr;
+    }
+    std::shared_lock ModLock(ModInst->Mutex);
+    const auto &FuncInsts = ModInst->FuncInsts;
+    const auto Iter = std::find(FuncInsts.begin(), FuncInsts.end(), &Func);
+    if (Iter == FuncInsts.end()) {
+      return nullptr;
+    }
+    const auto Index = static_cast<uint32_t>(Iter - FuncInsts.begin());
+    auto &Mod = Profile.Modules[std::string(ModInst->getModuleName())];
+    return &Mod.Functions[Index];
+  };
+  for (const auto &[Func, Count] : AllCalls) {
+    if (auto *FuncProf = Locate(*Func)) {
+      FuncProf->EntryCount = Count;
+    }
+  }
+  for (const auto &[Key, Counts] : AllBranches) {
+    if (auto *FuncProf = Locate(*Key.first)) {
+      FuncProf->Branches[Key.second] = Counts;
+    }
+  }
+  return Profile;
+}
+
+void Profiler::run() noexcept {
+  std::unique_lock Lock(Mutex);
+  FuncStack Stack;
+  while (!StopCond.wait_for(Lock, Interval, [this]() { return Stopping; })) {
+    for (const auto *StackMgr : Stacks) {
+      StackMgr->getShadowStack(Stack);
+      if (!Stack.empty()) {
+        ++Samples[Stack];
+        ++SampleCount;
+      }
+    }
+  }
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -11,8 +11,10 @@
 #include "host/wasi/inode.h"
 #include "host/wasi/vfs.h"
 #include "linux.h"
+#include "system/fiber.h"
 #include <algorithm>
 #include <new>
+#include <poll.h>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -1054,6 +1056,28 @@ WasiExpect<void> INode::sockRecvFrom(Span<Span<uint8_t>> RiData,
   return {};
 }
 
+WasiExpect<void> INode::sockSuspendIfBusy(bool Write) const noexcept {
+  if (Fiber::current() == nullptr) {
+    return {};
+  }
+  // Guests which made the socket non-blocking handle EAGAIN by themselves.
+  if (const int Flags = ::fcntl(Fd, F_GETFL);
+      Flags < 0 || (Flags & O_NONBLOCK)) {
+    return {};
+  }
+  struct pollfd SysPollFd = {Fd, static_cast<short>(Write ? POLLOUT : POLLIN),
+                             0};
+  if (::poll(&SysPollFd, 1, 0) != 0) {
+    // Ready, or the operation itself reports the error.
+    return {};
+  }
+  Fiber::WaitCondition Cond;
+  Cond.Fd = Fd;
+  Cond.Write = Write;
+  Fiber::setWaitCondition(Cond);
+  return WasiUnexpect(__WASI_ERRNO_AGAIN);
+}
+
 WasiExpect<void> INode::sockSend(Span<Span<const uint8_t>> SiData,
                                  __wasi_siflags_t SiFlags,
                                  __wasi_size_t &NWritten) const noexcept {
@@ -943,6 +943,11 @@ WasiExpect<void> INode::sockRecvFrom(Span<Span<uint8_t>> RiData,
   return {};
 }
 
+WasiExpect<void> INode::sockSuspendIfBusy(bool) const noexcept {
+  // Fibers can not suspend on this platform.
+  return {};
+}
+
 WasiExpect<void> INode::sockSend(Span<Span<const uint8_t>> SiData,
                                  __wasi_siflags_t SiFlags,
                                  __wasi_size_t &NWritten) const noexcept {
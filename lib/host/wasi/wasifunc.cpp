@@ -6,6 +6,7 @@
 #include "common/log.h"
 #include "host/wasi/environ.h"
 #include "runtime/instance/memory.h"
+#include "system/fiber.h"
 
 #include <algorithm>
 #include <array>
@@ -40,6 +41,20 @@ template <> struct WasiRawType<uint64_t> { using Type = uint64_t; };
 
 template <typename T> using WasiRawTypeT = typename WasiRawType<T>::Type;
 
+/// Suspend the running fiber instead of blocking the thread on a socket which
+/// is not ready. The executor retries the host function after resuming.
+Expect<void> suspendIfBusy(const WASI::Environ &Env, __wasi_fd_t Fd,
+                           bool Write) noexcept {
+  if (likely(Fiber::current() == nullptr)) {
+    return {};
+  }
+  if (auto Res = Env.sockSuspendIfBusy(Fd, Write);
+      unlikely(!Res) && Res.error() == __WASI_ERRNO_AGAIN) {
+    return Unexpect(ErrCode::Value::HostFuncPending);
+  }
+  return {};
+}
+
 template <typename T> WASI::WasiExpect<T> cast(uint64_t) noexcept;
 
 template <>
@@ -1712,6 +1727,10 @@ Expect<uint32_t> WasiSockAccept::body(const Runtime::CallingFrame &Frame,
   }
   const __wasi_fd_t WasiFd = Fd;
 
+  if (auto Res = suspendIfBusy(Env, WasiFd, false); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   if (auto Res = Env.sockAccept(WasiFd); unlikely(!Res)) {
     return Res.error();
   } else {
@@ -1819,6 +1838,10 @@ Expect<uint32_t> WasiSockRecv::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  if (auto Res = suspendIfBusy(Env, WasiFd, false); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   if (auto Res = Env.sockRecv(WasiFd, {WasiRiData.data(), WasiRiDataLen},
                               WasiRiFlags, *RoDataLen, *RoFlags);
       unlikely(!Res)) {
@@ -1908,6 +1931,10 @@ Expect<uint32_t> WasiSockRecvFrom::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  if (auto Res = suspendIfBusy(Env, WasiFd, false); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   if (auto Res = Env.sockRecvFrom(
           WasiFd, {WasiRiData.data(), WasiRiDataLen}, WasiRiFlags, AddressBuf,
           static_cast<uint8_t>(InnerAddress->buf_len), *RoDataLen, *RoFlags);
@@ -1976,6 +2003,10 @@ Expect<uint32_t> WasiSockSend::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  if (auto Res = suspendIfBusy(Env, WasiFd, true); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   if (auto Res = Env.sockSend(WasiFd, {WasiSiData.data(), WasiSiDataLen},
                               WasiSiFlags, *SoDataLen);
       unlikely(!Res)) {
@@ -2059,6 +2090,10 @@ Expect<uint32_t> WasiSockSendTo::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  if (auto Res = suspendIfBusy(Env, WasiFd, true); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   if (auto Res = Env.sockSendTo(
           WasiFd, {WasiSiData.data(), WasiSiDataLen}, WasiSiFlags, AddressBuf,
           static_cast<uint8_t>(InnerAddress->buf_len), Port, *SoDataLen);
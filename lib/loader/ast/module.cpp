@@ -2,18 +2,102 @@
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
 #include "loader/loader.h"
+#include "system/cpu.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace WasmEdge {
 namespace Loader {
 
+namespace {
+
+/// Load the function names subsection of a name section. The malformed name
+/// section is ignored from the malformed part on.
+void loadFunctionNames(const AST::CustomSection &Sec,
+                       std::unordered_map<uint32_t, std::string> &Names) {
+  FileMgr NameMgr;
+  if (!NameMgr.setCode(Sec.getContent())) {
+    return;
+  }
+  while (auto Id = NameMgr.readByte()) {
+    auto Size = NameMgr.readU32();
+    if (!Size) {
+      break;
+    }
+    const uint64_t End = NameMgr.getOffset() + *Size;
+    if (*Id == 0x01U) {
+      auto Count = NameMgr.readU32();
+      for (uint32_t I = 0; Count && I < *Count; ++I) {
+        auto Index = NameMgr.readU32();
+        if (!Index) {
+          break;
+        }
+        auto Name = NameMgr.readName();
+        if (!Name) {
+          break;
+        }
+        Names.insert_or_assign(*Index, std::move(*Name));
+      }
+    }
+    NameMgr.seek(End);
+  }
+}
+
+/// Get the perf map symbols of the defined functions. A symbol is
+/// `wasm-function[INDEX]`, followed by `:NAME` if the name section names it.
+std::vector<std::string> getPerfMapSymbols(const AST::Module &Mod) {
+  const auto &Names = Mod.getFunctionNames();
+
+  // The defined functions follow the imported ones in the index space.
+  uint32_t Index = 0;
+  for (const auto &Desc : Mod.getImportSection().getContent()) {
+    if (Desc.getExternalType() == ExternalType::Function) {
+      ++Index;
+    }
+  }
+  std::vector<std::string> Symbols;
+  Symbols.reserve(Mod.getCodeSection().getContent().size());
+  for (size_t I = 0; I < Mod.getCodeSection().getContent().size();
+       ++I, ++Index) {
+    auto &Symbol = Symbols.emplace_back("wasm-function[");
+    Symbol += std::to_string(Index);
+    Symbol += ']';
+    if (auto Iter = Names.find(Index); Iter != Names.end()) {
+      Symbol += ':';
+      Symbol += Iter->second;
+    }
+  }
+  return Symbols;
+}
+
+/// Hash the bytes into the 64-bit hash, by the words in FNV-1a. It is only
+/// for telling the modules apart, not against collisions on purpose.
+uint64_t hashBytes(uint64_t Hash, Span<const Byte> Bytes) noexcept {
+  constexpr uint64_t kPrime = UINT64_C(0x100000001b3);
+  size_t I = 0;
+  for (; I + sizeof(uint64_t) <= Bytes.size(); I += sizeof(uint64_t)) {
+    uint64_t Word;
+    std::memcpy(&Word, Bytes.data() + I, sizeof(Word));
+    Hash = (Hash ^ Word) * kPrime;
+    Hash ^= Hash >> 32;
+  }
+  for (; I < Bytes.size(); ++I) {
+    Hash = (Hash ^ Bytes[I]) * kPrime;
+  }
+  return Hash;
+}
+
+} // namespace
+
 // Load binary to construct Module node. See "include/loader/loader.h".
 Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   auto Mod = std::make_unique<AST::Module>();
@@ -79,6 +163,7 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
       if (Name == "wasmedge") {
         // Found the AOT section in universal WASM. Load the AOT code.
         // Read the content.
+        const auto ContentOffset = FMgr.getOffset();
         std::vector<uint8_t> Content;
         if (auto Res = FMgr.readBytes(ContentSize - ReadSize)) {
           Content = std::move(*Res);
@@ -91,10 +176,28 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
         AST::AOTSection NewAOTSection;
         VecMgr.setCode(Content);
         if (auto Res = loadSection(VecMgr, NewAOTSection)) {
-          // Also handle the duplicated AOT sections case.
-          // If the new AOT section discovered, use the new one.
-          IsUniversalWASM = true;
-          Mod->getAOTSection() = std::move(NewAOTSection);
+          // Record where the contents are in the file, for mapping them.
+          if (FMgr.getFileDescriptor() >= 0) {
+            for (auto &Offset : NewAOTSection.getContentOffsets()) {
+              Offset += ContentOffset;
+            }
+          }
+          // Also handle the duplicated AOT sections case. The sections are
+          // compiled for different target CPUs, so use the one requiring the
+          // most features supported by the running CPU. If the new AOT
+          // section requires no less features, use the new one.
+          const auto &Features = NewAOTSection.getFeatures();
+          if (!std::all_of(Features.begin(), Features.end(),
+                           [](const std::string &Feature) {
+                             return CPU::hasFeature(Feature);
+                           })) {
+            spdlog::debug("    AOT section for unsupported CPU skipped.");
+          } else if (!IsUniversalWASM ||
+                     Features.size() >=
+                         Mod->getAOTSection().getFeatures().size()) {
+            IsUniversalWASM = true;
+            Mod->getAOTSection() = std::move(NewAOTSection);
+          }
         } else {
           // If the new AOT section load failed, use the old one or the
           // interpreter mode.
@@ -124,6 +227,8 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   // Variables to record the loaded section types.
   HasDataSection = false;
   std::bitset<0x0DU> Secs;
+  // The code hash starts from the offset basis of FNV-1a.
+  uint64_t CodeHash = UINT64_C(0xcbf29ce484222325);
 
   // Read Section index and create Section nodes.
   while (true) {
@@ -147,6 +252,7 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
                           ASTNodeAttr::Module);
     }
 
+    const uint64_t StartOffset = FMgr.getLastOffset();
     switch (NewSectionId) {
     case 0x00:
       Mod->getCustomSections().emplace_back();
@@ -154,6 +260,11 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
         return Unexpect(Res);
       }
+      // Parse the function names once for the users of the names.
+      if (Mod->getCustomSections().back().getName() == "name") {
+        loadFunctionNames(Mod->getCustomSections().back(),
+                          Mod->getFunctionNames());
+      }
       break;
     case 0x01:
       if (auto Res = loadSection(Mod->getTypeSection()); !Res) {
@@ -251,7 +362,16 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
       return logLoadError(ErrCode::Value::MalformedSection,
                           FMgr.getLastOffset(), ASTNodeAttr::Module);
     }
+
+    // Hash the sections defining the functions and their exports, with the
+    // section ids and sizes.
+    if (NewSectionId == 0x01U || NewSectionId == 0x02U ||
+        NewSectionId == 0x03U || NewSectionId == 0x07U ||
+        NewSectionId == 0x0AU) {
+      CodeHash = hashBytes(CodeHash, FMgr.getReadBytes(StartOffset));
+    }
   }
+  Mod->setCodeHash(CodeHash);
 
   // Verify the function section and code section are matched.
   if (Mod->getFunctionSection().getContent().size() !=
@@ -274,7 +394,11 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
   // Load library from AOT Section for the universal WASM case.
   if (IsUniversalWASM) {
     auto Library = std::make_shared<SharedLibrary>();
-    if (auto Res = Library->load(Mod->getAOTSection()); unlikely(!Res)) {
+    // Map the codes from the parsed file itself, not from its path, which may
+    // refer to another file by now.
+    if (auto Res = Library->load(Mod->getAOTSection(),
+                                 FMgr.getFileDescriptor());
+        unlikely(!Res)) {
       spdlog::error("    AOT section -- library load failed:{} , use "
                     "interpreter mode instead.",
                     Res.error());
@@ -316,6 +440,14 @@ Expect<std::unique_ptr<AST::Module>> Loader::loadModule() {
         CodeSegs[I].setSymbol(std::move(CodeSymbols[I]));
       }
       Mod->setSymbol(std::move(IntrinsicsSymbol));
+      if (Conf.getRuntimeConfigure().isPerfMap()) {
+        Library->writePerfMap(getPerfMapSymbols(*Mod));
+      }
+      // The contents are copied or mapped by the library, so do not keep
+      // another copy of the code with the module.
+      for (auto &Section : Mod->getAOTSection().getSections()) {
+        std::vector<Byte>().swap(std::get<3>(Section));
+      }
     } else {
       // Fallback to the interpreter mode case: Re-read the code section.
       FMgr.seek(Mod->getCodeSection().getStartOffset());
@@ -247,6 +247,47 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     return Unexpect(ErrCode::Value::MalformedSection);
   }
 
+  if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("    AOT feature count read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.getFeatures().resize(*Res);
+  }
+  for (auto &Feature : Sec.getFeatures()) {
+    if (auto Res = VecMgr.readName(); unlikely(!Res)) {
+      spdlog::error(Res.error());
+      spdlog::error("    AOT feature read error:{}", Res.error());
+      return Unexpect(Res);
+    } else {
+      Feature = std::move(*Res);
+    }
+  }
+
+  if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
+    spdlog::error(Res.error());
+    spdlog::error("    AOT linked module count read error:{}", Res.error());
+    return Unexpect(Res);
+  } else {
+    Sec.getLinkedModules().resize(*Res);
+  }
+  for (auto &[Name, Hash] : Sec.getLinkedModules()) {
+    if (auto Res = VecMgr.readName(); unlikely(!Res)) {
+      spdlog::error(Res.error());
+      spdlog::error("    AOT linked module name read error:{}", Res.error());
+      return Unexpect(Res);
+    } else {
+      Name = std::move(*Res);
+    }
+    if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
+      spdlog::error(Res.error());
+      spdlog::error("    AOT linked module hash read error:{}", Res.error());
+      return Unexpect(Res);
+    } else {
+      Hash = *Res;
+    }
+  }
+
   if (auto Res = VecMgr.readU64(); unlikely(!Res)) {
     spdlog::error(Res.error());
     spdlog::error("    AOT version address read error:{}", Res.error());
@@ -302,6 +343,7 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     Sec.getSections().resize(*Res);
   }
 
+  Sec.getContentOffsets().clear();
   for (auto &Section : Sec.getSections()) {
     if (auto Res = VecMgr.readByte(); unlikely(!Res)) {
       spdlog::error(Res.error());
@@ -324,6 +366,14 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     } else {
       std::get<2>(Section) = *Res;
     }
+    // The padding aligns the content in the file for mapping.
+    if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
+      spdlog::error(Res.error());
+      spdlog::error("    AOT section padding read error:{}", Res.error());
+      return Unexpect(Res);
+    } else {
+      VecMgr.seek(VecMgr.getOffset() + *Res);
+    }
     uint32_t ContentSize;
     if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
       spdlog::error(Res.error());
@@ -332,6 +382,7 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     } else {
       ContentSize = *Res;
     }
+    Sec.getContentOffsets().push_back(VecMgr.getOffset());
     if (auto Res = VecMgr.readBytes(ContentSize); unlikely(!Res)) {
       spdlog::error(Res.error());
       spdlog::error("    AOT section data read error:{}", Res.error());
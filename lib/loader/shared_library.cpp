@@ -3,6 +3,7 @@
 
 #include "loader/shared_library.h"
 
+#include "common/config.h"
 #include "common/log.h"
 #include "system/allocator.h"
 
@@ -10,6 +11,9 @@
 #include <cerrno>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
 #include <tuple>
 #include <utility>
 
@@ -18,8 +22,18 @@
 #include <boost/winapi/error_handling.hpp>
 #include <boost/winapi/local_memory.hpp>
 namespace winapi = boost::winapi;
-#elif WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#elif WASMEDGE_OS_LINUX
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif WASMEDGE_OS_MACOS
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #else
 #error Unsupported os!
 #endif
@@ -41,6 +55,54 @@ inline constexpr uint64_t roundUpPageBoundary(const uint64_t Value) {
   return roundDownPageBoundary(Value + UINT64_C(4095));
 #endif
 }
+
+#if defined(HAVE_MMAP)
+/// Map a text section from the file over its pages in the binary, so the
+/// processes loading the same file share the code in the page cache. Only
+/// possible if the content is at the same offset in a page as the section,
+/// and no other section shares the pages. The compiler replaces its outputs
+/// by renaming, so a mapped file is never truncated under the process.
+/// Returns false if the content should be copied instead.
+WasmEdge::Expect<bool> mapText(int File, uint64_t FileSize,
+                               const WasmEdge::AST::AOTSection &AOTSec,
+                               size_t Index, uint8_t *Binary) noexcept {
+  const auto &Sections = AOTSec.getSections();
+  const auto Offset = std::get<1>(Sections[Index]);
+  const auto Size = std::get<2>(Sections[Index]);
+  const auto FileOffset = AOTSec.getContentOffsets()[Index];
+  const auto O = roundDownPageBoundary(Offset);
+  const auto S = roundUpPageBoundary(Size + (Offset - O));
+  if (std::get<3>(Sections[Index]).size() != Size ||
+      FileOffset < Offset - O || FileOffset + Size > FileSize ||
+      roundDownPageBoundary(FileOffset - (Offset - O)) !=
+          FileOffset - (Offset - O)) {
+    return false;
+  }
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const auto OtherOffset = std::get<1>(Sections[I]);
+    const auto OtherSize = std::get<2>(Sections[I]);
+    if (I != Index && OtherSize > 0 && OtherOffset < O + S &&
+        O < OtherOffset + OtherSize) {
+      return false;
+    }
+  }
+
+  if (::mmap(Binary + O, S, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_FIXED,
+             File, static_cast<off_t>(FileOffset - (Offset - O))) ==
+      MAP_FAILED) {
+    // The pages may be unmapped by the failed mapping. Map them again for
+    // copying the content.
+    if (::mmap(Binary + O, S, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+      spdlog::error(WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+      spdlog::error("    mmap failed:{}", std::strerror(errno));
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+    }
+    return false;
+  }
+  return true;
+}
+#endif
 } // namespace
 
 namespace WasmEdge {
@@ -79,7 +141,8 @@ Expect<void> SharedLibrary::load(const std::filesystem::path &Path) noexcept {
   return {};
 }
 
-Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
+Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec,
+                                  int File) noexcept {
   BinarySize = 0;
   for (const auto &Section : AOTSec.getSections()) {
     BinarySize =
@@ -93,17 +156,45 @@ Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
 
+#if defined(HAVE_MMAP)
+  uint64_t FileSize = 0;
+  if (AOTSec.getContentOffsets().size() != AOTSec.getSections().size()) {
+    File = -1;
+  } else if (struct stat Stat; File >= 0 && ::fstat(File, &Stat) == 0) {
+    FileSize = static_cast<uint64_t>(Stat.st_size);
+  } else {
+    File = -1;
+  }
+#else
+  static_cast<void>(File);
+#endif
+
   std::vector<std::pair<uint8_t *, uint64_t>> ExecutableRanges;
-  for (const auto &Section : AOTSec.getSections()) {
+  TextRanges.clear();
+  const auto &Sections = AOTSec.getSections();
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const auto &Section = Sections[I];
     const auto Offset = std::get<1>(Section);
     const auto Size = std::get<2>(Section);
     const auto &Content = std::get<3>(Section);
+#if defined(HAVE_MMAP)
+    if (std::get<0>(Section) == 1 && File >= 0) {
+      if (auto Res = mapText(File, FileSize, AOTSec, I, Binary);
+          unlikely(!Res)) {
+        return Unexpect(Res);
+      } else if (*Res) {
+        TextRanges.emplace_back(Offset, Size);
+        continue;
+      }
+    }
+#endif
     std::copy(Content.begin(), Content.end(), Binary + Offset);
     switch (std::get<0>(Section)) {
     case 1: { // Text
       const auto O = roundDownPageBoundary(Offset);
       const auto S = roundUpPageBoundary(Size + (Offset - O));
       ExecutableRanges.emplace_back(Binary + O, S);
+      TextRanges.emplace_back(Offset, Size);
       break;
     }
     case 2: // Data
@@ -112,7 +203,6 @@ Expect<void> SharedLibrary::load(const AST::AOTSection &AOTSec) noexcept {
       break;
     }
   }
-
   for (const auto &[Pointer, Size] : ExecutableRanges) {
     if (!Allocator::set_chunk_executable(Pointer, Size)) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -160,5 +250,43 @@ uintptr_t SharedLibrary::getOffset() const noexcept {
   return reinterpret_cast<uintptr_t>(Binary);
 }
 
+void SharedLibrary::writePerfMap(
+    Span<const std::string> Symbols) const noexcept {
+#if WASMEDGE_OS_LINUX
+  if (!Binary) {
+    return;
+  }
+  // A code ends at the next code or at the end of its text section.
+  std::vector<uint64_t> Ends;
+  for (const auto &[Offset, Size] : TextRanges) {
+    Ends.push_back(Offset + Size);
+  }
+  for (const auto Address : CodesAddress) {
+    Ends.push_back(Address);
+  }
+  std::sort(Ends.begin(), Ends.end());
+
+  // Libraries of different modules may be loaded concurrently.
+  static std::mutex Mutex;
+  std::unique_lock Lock(Mutex);
+  const auto Path =
+      std::string("/tmp/perf-") + std::to_string(::getpid()) + ".map";
+  std::ofstream OS(Path, std::ios::app);
+  if (!OS) {
+    spdlog::error("    open perf map {} failed:{}", Path, std::strerror(errno));
+    return;
+  }
+  OS << std::hex;
+  for (size_t I = 0; I < CodesAddress.size() && I < Symbols.size(); ++I) {
+    const auto Address = CodesAddress[I];
+    const auto End = std::upper_bound(Ends.begin(), Ends.end(), Address);
+    const uint64_t Size = End == Ends.end() ? 0 : *End - Address;
+    OS << getOffset() + Address << ' ' << Size << ' ' << Symbols[I] << '\n';
+  }
+#else
+  static_cast<void>(Symbols);
+#endif
+}
+
 } // namespace Loader
 } // namespace WasmEdge
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/cpu.h"
+
+#include "common/defines.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#elif defined(__aarch64__) && WASMEDGE_OS_LINUX
+#include <sys/auxv.h>
+#endif
+
+namespace WasmEdge {
+namespace CPU {
+
+namespace {
+
+using namespace std::literals;
+
+#if defined(__x86_64__)
+
+enum Register : uint8_t { EAX, EBX, ECX, EDX };
+
+/// XCR0 bits of the register states saved by the OS.
+static inline constexpr uint64_t kAVXState = 0x06;
+static inline constexpr uint64_t kAVX512State = 0xe6;
+
+struct FeatureInfo {
+  std::string_view Name;
+  uint32_t Leaf;
+  Register Reg;
+  uint8_t Bit;
+  uint64_t State;
+};
+
+static inline constexpr std::array kFeatures = {
+    FeatureInfo{"sse3"sv, 1, ECX, 0, 0},
+    FeatureInfo{"pclmul"sv, 1, ECX, 1, 0},
+    FeatureInfo{"ssse3"sv, 1, ECX, 9, 0},
+    FeatureInfo{"fma"sv, 1, ECX, 12, kAVXState},
+    FeatureInfo{"cx16"sv, 1, ECX, 13, 0},
+    FeatureInfo{"sse4.1"sv, 1, ECX, 19, 0},
+    FeatureInfo{"sse4.2"sv, 1, ECX, 20, 0},
+    FeatureInfo{"movbe"sv, 1, ECX, 22, 0},
+    FeatureInfo{"popcnt"sv, 1, ECX, 23, 0},
+    FeatureInfo{"aes"sv, 1, ECX, 25, 0},
+    FeatureInfo{"xsave"sv, 1, ECX, 26, 0},
+    FeatureInfo{"avx"sv, 1, ECX, 28, kAVXState},
+    FeatureInfo{"f16c"sv, 1, ECX, 29, kAVXState},
+    FeatureInfo{"rdrnd"sv, 1, ECX, 30, 0},
+    FeatureInfo{"sse2"sv, 1, EDX, 26, 0},
+    FeatureInfo{"bmi"sv, 7, EBX, 3, 0},
+    FeatureInfo{"avx2"sv, 7, EBX, 5, kAVXState},
+    FeatureInfo{"bmi2"sv, 7, EBX, 8, 0},
+    FeatureInfo{"avx512f"sv, 7, EBX, 16, kAVX512State},
+    FeatureInfo{"avx512dq"sv, 7, EBX, 17, kAVX512State},
+    FeatureInfo{"rdseed"sv, 7, EBX, 18, 0},
+    FeatureInfo{"adx"sv, 7, EBX, 19, 0},
+    FeatureInfo{"avx512cd"sv, 7, EBX, 28, kAVX512State},
+    FeatureInfo{"sha"sv, 7, EBX, 29, 0},
+    FeatureInfo{"avx512bw"sv, 7, EBX, 30, kAVX512State},
+    FeatureInfo{"avx512vl"sv, 7, EBX, 31, kAVX512State},
+    FeatureInfo{"avx512vbmi"sv, 7, ECX, 1, kAVX512State},
+    FeatureInfo{"avx512vbmi2"sv, 7, ECX, 6, kAVX512State},
+    FeatureInfo{"gfni"sv, 7, ECX, 8, 0},
+    FeatureInfo{"vaes"sv, 7, ECX, 9, kAVXState},
+    FeatureInfo{"vpclmulqdq"sv, 7, ECX, 10, kAVXState},
+    FeatureInfo{"avx512vnni"sv, 7, ECX, 11, kAVX512State},
+    FeatureInfo{"avx512bitalg"sv, 7, ECX, 12, kAVX512State},
+    FeatureInfo{"avx512vpopcntdq"sv, 7, ECX, 14, kAVX512State},
+    FeatureInfo{"lzcnt"sv, 0x80000001, ECX, 5, 0},
+    FeatureInfo{"sse4a"sv, 0x80000001, ECX, 6, 0},
+    FeatureInfo{"xop"sv, 0x80000001, ECX, 11, kAVXState},
+    FeatureInfo{"fma4"sv, 0x80000001, ECX, 16, kAVXState},
+};
+
+uint64_t detect() noexcept {
+  uint64_t XCR0 = 0;
+  {
+    std::array<uint32_t, 4> Regs = {};
+    // The OS saves the extended register states only if OSXSAVE is set.
+    if (__get_cpuid(1, &Regs[EAX], &Regs[EBX], &Regs[ECX], &Regs[EDX]) &&
+        (Regs[ECX] & (UINT32_C(1) << 27))) {
+      uint32_t Lo, Hi;
+      asm volatile("xgetbv" : "=a"(Lo), "=d"(Hi) : "c"(0));
+      XCR0 = (uint64_t(Hi) << 32) | Lo;
+    }
+  }
+
+  uint64_t Supported = 0;
+  for (size_t I = 0; I < kFeatures.size(); ++I) {
+    const auto &Info = kFeatures[I];
+    std::array<uint32_t, 4> Regs = {};
+    if (!__get_cpuid_count(Info.Leaf, 0, &Regs[EAX], &Regs[EBX], &Regs[ECX],
+                           &Regs[EDX])) {
+      continue;
+    }
+    if ((Regs[Info.Reg] & (UINT32_C(1) << Info.Bit)) &&
+        (XCR0 & Info.State) == Info.State) {
+      Supported |= UINT64_C(1) << I;
+    }
+  }
+  return Supported;
+}
+
+#elif defined(__aarch64__)
+
+struct FeatureInfo {
+  std::string_view Name;
+  uint8_t Bit;
+};
+
+/// Bits of the Linux AT_HWCAP auxiliary vector entry.
+static inline constexpr std::array kFeatures = {
+    FeatureInfo{"neon"sv, 1},    FeatureInfo{"aes"sv, 3},
+    FeatureInfo{"sha2"sv, 6},    FeatureInfo{"crc"sv, 7},
+    FeatureInfo{"lse"sv, 8},     FeatureInfo{"fullfp16"sv, 10},
+    FeatureInfo{"rdm"sv, 12},    FeatureInfo{"dotprod"sv, 20},
+    FeatureInfo{"sve"sv, 22},
+};
+
+uint64_t detect() noexcept {
+  uint64_t Supported = 0;
+#if WASMEDGE_OS_LINUX
+  const uint64_t HWCap = getauxval(AT_HWCAP);
+  for (size_t I = 0; I < kFeatures.size(); ++I) {
+    if (HWCap & (UINT64_C(1) << kFeatures[I].Bit)) {
+      Supported |= UINT64_C(1) << I;
+    }
+  }
+#else
+  // Only the baseline NEON is assumed on the other systems.
+  Supported |= UINT64_C(1);
+#endif
+  return Supported;
+}
+
+#else
+
+struct FeatureInfo {
+  std::string_view Name;
+};
+
+static inline constexpr std::array<FeatureInfo, 0> kFeatures = {};
+
+uint64_t detect() noexcept { return 0; }
+
+#endif
+
+static_assert(kFeatures.size() <= 64);
+
+/// Index of the feature in kFeatures, or kFeatures.size() if unknown.
+size_t findFeature(std::string_view Feature) noexcept {
+  size_t I = 0;
+  while (I < kFeatures.size() && kFeatures[I].Name != Feature) {
+    ++I;
+  }
+  return I;
+}
+
+uint64_t supported() noexcept {
+  static const uint64_t Supported = detect();
+  return Supported;
+}
+
+} // namespace
+
+[[gnu::visibility("default")]] bool
+hasFeature(std::string_view Feature) noexcept {
+  const size_t I = findFeature(Feature);
+  return I < kFeatures.size() && (supported() & (UINT64_C(1) << I));
+}
+
+[[gnu::visibility("default")]] bool
+isKnownFeature(std::string_view Feature) noexcept {
+  return findFeature(Feature) < kFeatures.size();
+}
+
+[[gnu::visibility("default")]] std::vector<std::string_view> features() {
+  std::vector<std::string_view> Features;
+  for (size_t I = 0; I < kFeatures.size(); ++I) {
+    if (supported() & (UINT64_C(1) << I)) {
+      Features.push_back(kFeatures[I].Name);
+    }
+  }
+  return Features;
+}
+
+[[gnu::visibility("default")]] std::vector<std::string_view> knownFeatures() {
+  std::vector<std::string_view> Features;
+  Features.reserve(kFeatures.size());
+  for (const auto &Info : kFeatures) {
+    Features.push_back(Info.Name);
+  }
+  return Features;
+}
+
+} // namespace CPU
+} // namespace WasmEdge
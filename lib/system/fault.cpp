@@ -193,6 +193,10 @@ Fault::~Fault() noexcept {
   localHandler = std::exchange(Prev, nullptr);
 }
 
+Fault *Fault::exchangeLocalHandler(Fault *Handler) noexcept {
+  return std::exchange(localHandler, Handler);
+}
+
 [[noreturn]] inline void Fault::emitFault(ErrCode Error) {
   assuming(localHandler != nullptr);
   longjmp(localHandler->Buffer, static_cast<int>(Error.operator uint32_t()));
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/fiber.h"
+
+#include "common/log.h"
+#include "system/fault.h"
+
+#include <utility>
+
+#if WASMEDGE_OS_LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+
+namespace {
+thread_local Fiber *CurrentFiber = nullptr;
+} // namespace
+
+bool Fiber::isSupported() noexcept { return WASMEDGE_OS_LINUX; }
+
+Fiber *Fiber::current() noexcept { return CurrentFiber; }
+
+void Fiber::setWaitCondition(const WaitCondition &Cond) noexcept {
+  if (CurrentFiber != nullptr) {
+    CurrentFiber->Wait = Cond;
+  }
+}
+
+#if WASMEDGE_OS_LINUX
+Fiber::Fiber(std::function<void()> Func, size_t Size)
+    : Entry(std::move(Func)) {
+  const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  Size = (Size + PageSize - 1) / PageSize * PageSize;
+  // One extra inaccessible page below the stack catches overflows.
+  void *Pointer = mmap(nullptr, Size + PageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (Pointer == MAP_FAILED) {
+    spdlog::error("fiber stack allocation failed, running in place");
+    return;
+  }
+  Stack = static_cast<uint8_t *>(Pointer);
+  StackSize = Size + PageSize;
+  mprotect(Stack, PageSize, PROT_NONE);
+
+  getcontext(&Context);
+  Context.uc_stack.ss_sp = Stack + PageSize;
+  Context.uc_stack.ss_size = Size;
+  // Falling off the end of trampoline() switches back to the resumer.
+  Context.uc_link = &ReturnContext;
+  makecontext(&Context, &Fiber::trampoline, 0);
+}
+
+Fiber::~Fiber() noexcept {
+  // The frames of an unfinished fiber are discarded without unwinding.
+  if (Stack) {
+    munmap(Stack, StackSize);
+  }
+}
+
+void Fiber::trampoline() noexcept {
+  Fiber *Self = CurrentFiber;
+  Self->Entry();
+  Self->Finished = true;
+}
+
+void Fiber::resume() noexcept {
+  if (Finished) {
+    return;
+  }
+  if (unlikely(!Stack)) {
+    Entry();
+    Finished = true;
+    return;
+  }
+  Wait = WaitCondition{};
+  Parent = std::exchange(CurrentFiber, this);
+  Fault *Outer = Fault::exchangeLocalHandler(FaultHandler);
+  swapcontext(&ReturnContext, &Context);
+  FaultHandler = Fault::exchangeLocalHandler(Outer);
+  CurrentFiber = std::exchange(Parent, nullptr);
+}
+
+void Fiber::yield() noexcept {
+  if (Fiber *Self = CurrentFiber; Self != nullptr) {
+    swapcontext(&Self->Context, &Self->ReturnContext);
+  }
+}
+#else
+Fiber::Fiber(std::function<void()> Func, size_t) : Entry(std::move(Func)) {}
+
+Fiber::~Fiber() noexcept = default;
+
+void Fiber::resume() noexcept {
+  if (!Finished) {
+    Entry();
+    Finished = true;
+  }
+}
+
+void Fiber::yield() noexcept {}
+#endif
+
+} // namespace WasmEdge
@@ -139,6 +139,17 @@ void *MMap::address() const noexcept {
   return reinterpret_cast<const Implement *>(Handle)->Address;
 }
 
+int MMap::descriptor() const noexcept {
+#ifdef HAVE_MMAP
+  if (!Handle) {
+    return -1;
+  }
+  return reinterpret_cast<const Implement *>(Handle)->File;
+#else
+  return -1;
+#endif
+}
+
 bool MMap::supported() noexcept { return kSupported; }
 
 } // namespace WasmEdge
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "vm/fiberloop.h"
+#include "common/defines.h"
+#include "common/log.h"
+#include "vm/vm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <optional>
+#include <string>
+
+#if WASMEDGE_OS_LINUX
+#include <cerrno>
+#include <poll.h>
+#endif
+
+namespace WasmEdge {
+namespace VM {
+
+void FiberLoop::spawn(std::function<void()> Task) {
+  Ready.push_back(std::make_unique<Fiber>(std::move(Task), StackSize));
+}
+
+std::future<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+FiberLoop::spawnExecute(VM &TargetVM, std::string_view Func,
+                        Span<const ValVariant> Params,
+                        Span<const ValType> ParamTypes) {
+  using ResultT = Expect<std::vector<std::pair<ValVariant, ValType>>>;
+  auto Promise = std::make_shared<std::promise<ResultT>>();
+  auto Future = Promise->get_future();
+  spawn([&TargetVM, Promise, FuncName = std::string(Func),
+         ParamsVec = std::vector<ValVariant>(Params.begin(), Params.end()),
+         TypesVec = std::vector<ValType>(ParamTypes.begin(),
+                                         ParamTypes.end())]() {
+    TargetVM.newThread();
+    Promise->set_value(TargetVM.execute(FuncName, ParamsVec, TypesVec));
+  });
+  return Future;
+}
+
+void FiberLoop::run() {
+  while (!Ready.empty() || !Waiting.empty()) {
+    // Only run the fibers which were ready at the start of this round, so
+    // that a fiber that keeps yielding can not starve the waiting ones.
+    for (size_t Count = Ready.size(); Count > 0; --Count) {
+      std::unique_ptr<Fiber> Current = std::move(Ready.front());
+      Ready.pop_front();
+      Current->resume();
+      if (Current->isFinished()) {
+        continue;
+      }
+      const auto &Cond = Current->getWaitCondition();
+      if (Cond.Fd < 0 && !Cond.Until) {
+        Ready.push_back(std::move(Current));
+      } else {
+        Waiting.push_back(std::move(Current));
+      }
+    }
+    if (!Waiting.empty()) {
+      pollWaiting();
+    }
+  }
+}
+
+void FiberLoop::pollWaiting() {
+#if WASMEDGE_OS_LINUX
+  using namespace std::chrono;
+  std::vector<struct pollfd> PollFds;
+  PollFds.reserve(Waiting.size());
+  std::optional<Fiber::TimePoint> Earliest;
+  for (const auto &Waiter : Waiting) {
+    const auto &Cond = Waiter->getWaitCondition();
+    // poll() ignores the entries with a negative fd.
+    PollFds.push_back(
+        {Cond.Fd, static_cast<short>(Cond.Write ? POLLOUT : POLLIN), 0});
+    if (Cond.Until && (!Earliest || *Cond.Until < *Earliest)) {
+      Earliest = Cond.Until;
+    }
+  }
+
+  // Do not block if other fibers are still runnable.
+  int Timeout = Ready.empty() ? -1 : 0;
+  if (Earliest && Timeout != 0) {
+    const auto Remain = ceil<milliseconds>(*Earliest - steady_clock::now());
+    Timeout = static_cast<int>(
+        std::clamp<milliseconds::rep>(Remain.count(), 0, INT_MAX));
+  }
+  if (::poll(PollFds.data(), PollFds.size(), Timeout) < 0 && errno != EINTR) {
+    // Let the host functions retry and report the error by themselves.
+    spdlog::error("fiber loop: poll failed, errno {}", errno);
+    for (auto &Waiter : Waiting) {
+      Ready.push_back(std::move(Waiter));
+    }
+    Waiting.clear();
+    return;
+  }
+
+  const auto Now = steady_clock::now();
+  size_t Kept = 0;
+  for (size_t I = 0; I < Waiting.size(); ++I) {
+    const auto &Cond = Waiting[I]->getWaitCondition();
+    if (PollFds[I].revents != 0 || (Cond.Until && *Cond.Until <= Now)) {
+      Ready.push_back(std::move(Waiting[I]));
+    } else {
+      Waiting[Kept++] = std::move(Waiting[I]);
+    }
+  }
+  Waiting.resize(Kept);
+#else
+  // Fibers never suspend on this platform.
+  for (auto &Waiter : Waiting) {
+    Ready.push_back(std::move(Waiter));
+  }
+  Waiting.clear();
+#endif
+}
+
+} // namespace VM
+} // namespace WasmEdge
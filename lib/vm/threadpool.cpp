@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "vm/threadpool.h"
+#include "common/defines.h"
+#include "common/log.h"
+
+#if WASMEDGE_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace WasmEdge {
+namespace VM {
+
+namespace {
+/// Pool of the worker running on this thread.
+thread_local const ThreadPool *CurrentPool = nullptr;
+} // namespace
+
+ThreadPool::ThreadPool(uint32_t ThreadCount, uint32_t QueueLimit,
+                       bool Affinity)
+    : QueueLimit(QueueLimit) {
+  const uint32_t CPUCount = std::max(1U, std::thread::hardware_concurrency());
+  Workers.reserve(ThreadCount);
+  for (uint32_t I = 0; I < ThreadCount; ++I) {
+    Workers.emplace_back([this]() noexcept { run(); });
+    if (Affinity) {
+#if WASMEDGE_OS_LINUX
+      cpu_set_t Set;
+      CPU_ZERO(&Set);
+      CPU_SET(I % CPUCount, &Set);
+      if (pthread_setaffinity_np(Workers.back().native_handle(), sizeof(Set),
+                                 &Set) != 0) {
+        spdlog::warn("Failed to set the CPU affinity of async worker {}", I);
+      }
+#else
+      static_cast<void>(CPUCount);
+#endif
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopping = true;
+  }
+  NotEmpty.notify_all();
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+}
+
+bool ThreadPool::submit(std::packaged_task<void()> Task) {
+  {
+    std::unique_lock Lock(Mutex);
+    auto HasRoom = [this]() {
+      return QueueLimit == 0 || Queue.size() < QueueLimit;
+    };
+    if (CurrentPool == this) {
+      if (!HasRoom()) {
+        spdlog::error("The async queue is full, and a worker of the pool can "
+                      "not wait for it.");
+        return false;
+      }
+    } else {
+      NotFull.wait(Lock, HasRoom);
+    }
+    Queue.push_back(std::move(Task));
+  }
+  NotEmpty.notify_one();
+  return true;
+}
+
+void ThreadPool::run() noexcept {
+  CurrentPool = this;
+  while (true) {
+    std::packaged_task<void()> Task;
+    {
+      std::unique_lock Lock(Mutex);
+      NotEmpty.wait(Lock, [this]() { return Stopping || !Queue.empty(); });
+      if (Queue.empty()) {
+        // Stopping and drained.
+        return;
+      }
+      Task = std::move(Queue.front());
+      Queue.pop_front();
+    }
+    NotFull.notify_one();
+    Task();
+  }
+}
+
+} // namespace VM
+} // namespace WasmEdge
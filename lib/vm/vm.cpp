@@ -27,6 +27,14 @@ VM::VM(const Configure &Conf, Runtime::StoreManager &S)
 
 void VM::unsafeInitVM() {
   using namespace std::literals::string_view_literals;
+  // Create the asynchronous execution thread pool.
+  if (const auto &RuntimeConf = Conf.getRuntimeConfigure();
+      RuntimeConf.getAsyncThreadPoolSize() > 0) {
+    AsyncPool = std::make_unique<ThreadPool>(
+        RuntimeConf.getAsyncThreadPoolSize(), RuntimeConf.getAsyncQueueLimit(),
+        RuntimeConf.isAsyncThreadAffinity());
+  }
+
   // Create import modules from configuration.
   if (Conf.hasHostRegistration(HostRegistration::Wasi)) {
     std::unique_ptr<Runtime::Instance::ModuleInstance> WasiMod =
@@ -365,6 +373,65 @@ VM::unsafeExecute(const Runtime::Instance::ModuleInstance *ModInst,
   }
 }
 
+Expect<void> VM::unsafeExecuteBatch(std::string_view Func, uint32_t Count,
+                                    Span<const ValVariant> Params,
+                                    Span<ValVariant> Returns,
+                                    Span<ErrCode> Errors) {
+  if (ActiveModInst) {
+    // Execute function with the module instance.
+    return unsafeExecuteBatch(ActiveModInst.get(), Func, Count, Params,
+                              Returns, Errors);
+  } else {
+    spdlog::error(ErrCode::Value::WrongInstanceAddress);
+    spdlog::error(ErrInfo::InfoExecuting("", Func));
+    return Unexpect(ErrCode::Value::WrongInstanceAddress);
+  }
+}
+
+Expect<void> VM::unsafeExecuteBatch(std::string_view ModName,
+                                    std::string_view Func, uint32_t Count,
+                                    Span<const ValVariant> Params,
+                                    Span<ValVariant> Returns,
+                                    Span<ErrCode> Errors) {
+  // Find module instance by name.
+  const auto *FindModInst = StoreRef.findModule(ModName);
+  if (FindModInst != nullptr) {
+    // Execute function with the module instance.
+    return unsafeExecuteBatch(FindModInst, Func, Count, Params, Returns,
+                              Errors);
+  } else {
+    spdlog::error(ErrCode::Value::WrongInstanceAddress);
+    spdlog::error(ErrInfo::InfoExecuting(ModName, Func));
+    return Unexpect(ErrCode::Value::WrongInstanceAddress);
+  }
+}
+
+Expect<void>
+VM::unsafeExecuteBatch(const Runtime::Instance::ModuleInstance *ModInst,
+                       std::string_view Func, uint32_t Count,
+                       Span<const ValVariant> Params, Span<ValVariant> Returns,
+                       Span<ErrCode> Errors) {
+  // Find exported function by name once for the whole batch.
+  Runtime::Instance::FunctionInstance *FuncInst =
+      ModInst->findFuncExports(Func);
+  if (unlikely(FuncInst == nullptr)) {
+    spdlog::error(ErrCode::Value::FuncNotFound);
+    spdlog::error(ErrInfo::InfoExecuting(ModInst->getModuleName(), Func));
+    return Unexpect(ErrCode::Value::FuncNotFound);
+  }
+
+  // Execute function.
+  if (auto Res = ExecutorEngine.invokeBatch(*FuncInst, Count, Params, Returns,
+                                            Errors);
+      unlikely(!Res)) {
+    if (Res.error() != ErrCode::Value::Terminated) {
+      spdlog::error(ErrInfo::InfoExecuting(ModInst->getModuleName(), Func));
+    }
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
 VM::asyncExecute(std::string_view Func, Span<const ValVariant> Params,
                  Span<const ValType> ParamTypes) {
@@ -13,13 +13,21 @@
 //===----------------------------------------------------------------------===//
 
 #include "aot/cache.h"
+#include "aot/compiler.h"
 
 #include "common/filesystem.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
 
+#include <array>
+#include <chrono>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
 namespace {
 
@@ -99,6 +107,150 @@ TEST(CacheTest, LocalKey) {
   EXPECT_EQ(Part.parent_path().filename().u8string(), "key"s);
 }
 
+WasmEdge::Expect<std::filesystem::path> getLocalPath(std::string_view Key,
+                                                     std::string_view Data) {
+  return WasmEdge::AOT::Cache::getPath(
+      WasmEdge::Span<const WasmEdge::Byte>(
+          reinterpret_cast<const WasmEdge::Byte *>(Data.data()), Data.size()),
+      WasmEdge::AOT::Cache::StorageScope::Local, Key);
+}
+
+/// Compile the data to a temporary file with the content, and commit it.
+std::filesystem::path commitEntry(std::string_view Key, std::string_view Data,
+                                  std::string_view Content) {
+  const auto Path = getLocalPath(Key, Data);
+  EXPECT_TRUE(Path);
+  std::error_code ErrCode;
+  std::filesystem::create_directories(Path->parent_path(), ErrCode);
+  auto Compiled = *Path;
+  Compiled += ".tmp"sv;
+  {
+    std::ofstream OS(Compiled, std::ios::binary);
+    OS << Content;
+  }
+  EXPECT_TRUE(WasmEdge::AOT::Cache::commit(
+      Compiled, *Path, WasmEdge::AOT::Cache::StorageScope::Local));
+  EXPECT_FALSE(std::filesystem::exists(Compiled));
+  return *Path;
+}
+
+TEST(CacheTest, Verify) {
+  const auto Scope = WasmEdge::AOT::Cache::StorageScope::Local;
+  WasmEdge::AOT::Cache::clear(Scope, "verify"sv);
+  const auto Path = commitEntry("verify"sv, "data"sv, "compiled"sv);
+
+  // A verified entry is kept.
+  EXPECT_EQ(*getLocalPath("verify"sv, "data"sv), Path);
+  EXPECT_TRUE(std::filesystem::exists(Path));
+
+  // An entry of the recorded size and modification time is not hashed.
+  const auto ModifiedTime = std::filesystem::last_write_time(Path);
+  {
+    std::ofstream OS(Path, std::ios::binary | std::ios::trunc);
+    OS << "corrupt!"sv;
+  }
+  std::filesystem::last_write_time(Path, ModifiedTime);
+  EXPECT_EQ(*getLocalPath("verify"sv, "data"sv), Path);
+  EXPECT_TRUE(std::filesystem::exists(Path));
+
+  // A corrupt entry of the same size is removed.
+  std::filesystem::last_write_time(Path,
+                                   ModifiedTime + std::chrono::seconds(1));
+  EXPECT_EQ(*getLocalPath("verify"sv, "data"sv), Path);
+  EXPECT_FALSE(std::filesystem::exists(Path));
+
+  // An entry without the metadata is removed.
+  {
+    std::ofstream OS(Path, std::ios::binary);
+    OS << "compiled"sv;
+  }
+  EXPECT_EQ(*getLocalPath("verify"sv, "data"sv), Path);
+  EXPECT_FALSE(std::filesystem::exists(Path));
+  WasmEdge::AOT::Cache::clear(Scope, "verify"sv);
+}
+
+TEST(CacheTest, Evict) {
+  const auto Scope = WasmEdge::AOT::Cache::StorageScope::Local;
+  WasmEdge::AOT::Cache::clear(Scope, "evict"sv);
+  const std::array Paths = {commitEntry("evict"sv, "a"sv, "compiled"sv),
+                            commitEntry("evict"sv, "b"sv, "compiled"sv),
+                            commitEntry("evict"sv, "c"sv, "compiled"sv)};
+  const auto Now = std::filesystem::file_time_type::clock::now();
+  for (size_t I = 0; I < Paths.size(); ++I) {
+    auto MetaPath = Paths[I];
+    MetaPath += ".meta"sv;
+    std::filesystem::last_write_time(
+        MetaPath, Now - std::chrono::hours(Paths.size() - I));
+  }
+  const auto Size = [&]() {
+    uint64_t Total = 0;
+    for (const auto &Entry :
+         std::filesystem::directory_iterator(Paths[0].parent_path())) {
+      Total += Entry.file_size();
+    }
+    return Total;
+  };
+
+  // Only the least recently used entry is evicted.
+  WasmEdge::AOT::Cache::evict(Scope, Size() - 1, "evict"sv);
+  EXPECT_FALSE(std::filesystem::exists(Paths[0]));
+  EXPECT_TRUE(std::filesystem::exists(Paths[1]));
+  EXPECT_TRUE(std::filesystem::exists(Paths[2]));
+
+  // Using an entry keeps it from the eviction.
+  EXPECT_TRUE(getLocalPath("evict"sv, "b"sv));
+  WasmEdge::AOT::Cache::evict(Scope, Size() - 1, "evict"sv);
+  EXPECT_TRUE(std::filesystem::exists(Paths[1]));
+  EXPECT_FALSE(std::filesystem::exists(Paths[2]));
+  WasmEdge::AOT::Cache::clear(Scope, "evict"sv);
+}
+
+TEST(CacheTest, Compile) {
+  const auto Scope = WasmEdge::AOT::Cache::StorageScope::Local;
+  WasmEdge::AOT::Cache::clear(Scope, "compile"sv);
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setCacheSizeLimit(1);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator Validator(Conf);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  const auto Compile = [&](std::vector<WasmEdge::Byte> Data) {
+    auto Module = Loader.parseModule(Data);
+    EXPECT_TRUE(Module);
+    EXPECT_TRUE(Validator.validate(**Module));
+    auto Path = Compiler.compile(Data, **Module, Scope, "compile"sv);
+    EXPECT_TRUE(Path);
+    return *Path;
+  };
+  const std::vector<WasmEdge::Byte> Empty = {0x00, 0x61, 0x73, 0x6d,
+                                             0x01, 0x00, 0x00, 0x00};
+  // (type (func))
+  const std::vector<WasmEdge::Byte> Type = {0x00, 0x61, 0x73, 0x6d, 0x01,
+                                            0x00, 0x00, 0x00, 0x01, 0x04,
+                                            0x01, 0x60, 0x00, 0x00};
+
+  // The compiled entry is committed with the metadata.
+  const auto Path = Compile(Empty);
+  auto MetaPath = Path;
+  MetaPath += ".meta"sv;
+  EXPECT_TRUE(std::filesystem::exists(Path));
+  EXPECT_TRUE(std::filesystem::exists(MetaPath));
+  EXPECT_EQ(std::distance(
+                std::filesystem::directory_iterator(Path.parent_path()), {}),
+            2);
+
+  // A verified entry is not compiled again.
+  const auto ModifiedTime = std::filesystem::last_write_time(Path);
+  EXPECT_EQ(Compile(Empty), Path);
+  EXPECT_EQ(std::filesystem::last_write_time(Path), ModifiedTime);
+
+  // The size limit evicts the other entries, but never the committed one.
+  const auto OtherPath = Compile(Type);
+  EXPECT_NE(OtherPath, Path);
+  EXPECT_TRUE(std::filesystem::exists(OtherPath));
+  EXPECT_FALSE(std::filesystem::exists(Path));
+  WasmEdge::AOT::Cache::clear(Scope, "compile"sv);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/aot/AOTLinkTest.cpp - linked modules unit tests -----===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of compiling with linked modules.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/defines.h"
+#include "common/filesystem.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <system_error>
+
+namespace {
+
+// (func (export "add") (param i32) (result i32)
+//   (i32.add (local.get 0) (i32.const 1)))
+std::array<WasmEdge::Byte, 40> AddOne{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01, 0x03,
+    0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20, 0x00,
+    0x41, 0x01, 0x6a, 0x0b,
+};
+
+// (func (export "add") (param i32) (result i32)
+//   (i32.add (local.get 0) (i32.const 2)))
+std::array<WasmEdge::Byte, 40> AddTwo{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01, 0x03,
+    0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20, 0x00,
+    0x41, 0x02, 0x6a, 0x0b,
+};
+
+// (import "math" "add" (func (param i32) (result i32)))
+// (func (export "run") (param i32) (result i32) (call 0 (local.get 0)))
+std::array<WasmEdge::Byte, 53> CallAdd{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0c, 0x01, 0x04, 0x6d, 0x61, 0x74, 0x68,
+    0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07,
+    0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x08, 0x01, 0x06, 0x00,
+    0x20, 0x00, 0x10, 0x00, 0x0b,
+};
+
+std::unique_ptr<WasmEdge::AST::Module>
+parse(const WasmEdge::Configure &Conf,
+      WasmEdge::Span<const WasmEdge::Byte> Code) {
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator Validator(Conf);
+  auto Module = Loader.parseModule(Code);
+  EXPECT_TRUE(Module);
+  EXPECT_TRUE(Validator.validate(**Module));
+  return std::move(*Module);
+}
+
+TEST(LinkTest, CodeHash) {
+  WasmEdge::Configure Conf;
+  const auto One = parse(Conf, AddOne);
+  const auto Two = parse(Conf, AddTwo);
+  EXPECT_NE(One->getCodeHash(), 0U);
+  EXPECT_EQ(parse(Conf, AddOne)->getCodeHash(), One->getCodeHash());
+  EXPECT_NE(Two->getCodeHash(), One->getCodeHash());
+}
+
+TEST(LinkTest, Instantiate) {
+  WasmEdge::Configure Conf;
+  const auto Linked = parse(Conf, AddOne);
+  const auto Module = parse(Conf, CallAdd);
+  const auto Path = std::filesystem::temp_directory_path() / "AOTLinkTest.wasm";
+  {
+    WasmEdge::AOT::Compiler Compiler(Conf);
+    Compiler.addLinkedModule("math", *Linked);
+    ASSERT_TRUE(Compiler.compile(CallAdd, *Module, Path));
+  }
+
+  // The linked module is registered, and the import is compiled in.
+  {
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.registerModule("math", AddOne));
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const auto *FuncInst = VM.getActiveModule()->findFuncExports("run");
+    ASSERT_NE(FuncInst, nullptr);
+    EXPECT_TRUE(FuncInst->isCompiledFunction());
+    auto Result = VM.execute(
+        "run", std::initializer_list<WasmEdge::ValVariant>{UINT32_C(41)},
+        {WasmEdge::ValType::I32});
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 42U);
+  }
+
+  // Another module registered by the name is rejected, since the compiled
+  // copy of the import would not call it.
+  {
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.registerModule("math", AddTwo));
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    auto Res = VM.instantiate();
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::IncompatibleImportType);
+  }
+
+  std::error_code ErrCode;
+  std::filesystem::remove(Path, ErrCode);
+}
+
+TEST(LinkTest, NativeOutput) {
+  // The native library can not record the linked modules.
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setOutputFormat(
+      WasmEdge::CompilerConfigure::OutputFormat::Native);
+  const auto Linked = parse(Conf, AddOne);
+  const auto Module = parse(Conf, CallAdd);
+  const auto Path = std::filesystem::temp_directory_path() /
+                    ("AOTLinkTest" WASMEDGE_LIB_EXTENSION);
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  Compiler.addLinkedModule("math", *Linked);
+  EXPECT_FALSE(Compiler.compile(CallAdd, *Module, Path));
+  std::error_code ErrCode;
+  std::filesystem::remove(Path, ErrCode);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
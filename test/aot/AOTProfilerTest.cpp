@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/aot/AOTProfilerTest.cpp - AOT instrumentation tests -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the instrumented AOT code.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "executor/profiler.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <system_error>
+
+namespace {
+
+using namespace std::literals;
+
+// (func (export "count") (param i32) (result i32) (local i32)
+//   (loop
+//     (if (i32.and (local.get 0) (i32.const 1))
+//       (then (local.set 1 (i32.add (local.get 1) (i32.const 1)))))
+//     (br_if 0 (local.tee 0 (i32.sub (local.get 0) (i32.const 1)))))
+//   (local.get 1))
+std::array<WasmEdge::Byte, 68> CountOdd{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x09, 0x01, 0x05,
+    0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00, 0x00, 0x0a, 0x23, 0x01, 0x21, 0x01,
+    0x01, 0x7f, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01, 0x71, 0x04, 0x40, 0x20,
+    0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x6b,
+    0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b,
+};
+
+/// Compile the module with the instrumentation into a universal wasm file.
+void compileCountOdd(const std::filesystem::path &Path) {
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setInstrumentation(true);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator Validator(Conf);
+  auto Module = Loader.parseModule(CountOdd);
+  ASSERT_TRUE(Module);
+  ASSERT_TRUE(Validator.validate(**Module));
+  WasmEdge::AOT::Compiler Compiler(Conf);
+  ASSERT_TRUE(Compiler.compile(CountOdd, **Module, Path));
+}
+
+/// Count the odd numbers from 1 to \p Times.
+void runCountOdd(WasmEdge::VM::VM &VM, uint32_t Times) {
+  const auto *FuncInst = VM.getActiveModule()->findFuncExports("count");
+  ASSERT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isCompiledFunction());
+  auto Result = VM.execute(
+      "count", std::initializer_list<WasmEdge::ValVariant>{Times},
+      {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), (Times + 1) / 2);
+}
+
+TEST(AOTProfiler, Instrumentation) {
+  const auto Path =
+      std::filesystem::temp_directory_path() / "AOTProfilerTest.wasm";
+  compileCountOdd(Path);
+
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof;
+  Prof.setInstrumentation(true);
+  VM.getExecutor().setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  runCountOdd(VM, 10);
+
+  // The compiled code counts the same opcodes as the interpreter, and every
+  // counted instruction in one block.
+  uint64_t OpCodeTotal = 0;
+  for (uint32_t I = 0; I <= UINT16_MAX; ++I) {
+    OpCodeTotal += Prof.getOpCodeCount(static_cast<WasmEdge::OpCode>(I));
+  }
+  uint64_t BlockTotal = 0;
+  for (const auto &[Key, Count] : Prof.getBlocks()) {
+    EXPECT_EQ(Prof.symbolize(*Key.first), "count"sv);
+    EXPECT_GT(Count.Count, 0U);
+    BlockTotal += Count.Instrs;
+  }
+  EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::Br_if), 10U);
+  EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::Local__get), 26U);
+  EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::If), 10U);
+  EXPECT_GT(BlockTotal, 0U);
+  EXPECT_EQ(OpCodeTotal, BlockTotal);
+
+  std::error_code ErrCode;
+  std::filesystem::remove(Path, ErrCode);
+}
+
+TEST(AOTProfiler, WithoutProfiler) {
+  const auto Path =
+      std::filesystem::temp_directory_path() / "AOTProfilerTest.wasm";
+  compileCountOdd(Path);
+
+  // The instrumented code runs without an instrumenting profiler, and counts
+  // nothing into a sampling one.
+  WasmEdge::Configure Conf;
+  {
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    runCountOdd(VM, 10);
+  }
+  {
+    WasmEdge::VM::VM VM(Conf);
+    WasmEdge::Executor::Profiler Prof;
+    VM.getExecutor().setProfiler(&Prof);
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    runCountOdd(VM, 10);
+    EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::Br_if), 0U);
+    EXPECT_TRUE(Prof.getBlocks().empty());
+  }
+
+  std::error_code ErrCode;
+  std::filesystem::remove(Path, ErrCode);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
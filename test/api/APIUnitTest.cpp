@@ -423,6 +423,23 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureSetMaxMemoryPage(Conf, 1234U);
   EXPECT_NE(WasmEdge_ConfigureGetMaxMemoryPage(ConfNull), 1234U);
   EXPECT_EQ(WasmEdge_ConfigureGetMaxMemoryPage(Conf), 1234U);
+  // Tests for asynchronous execution thread pool.
+  WasmEdge_ConfigureSetAsyncThreadPoolSize(ConfNull, 4U);
+  WasmEdge_ConfigureSetAsyncThreadPoolSize(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureGetAsyncThreadPoolSize(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetAsyncThreadPoolSize(Conf), 4U);
+  WasmEdge_ConfigureSetAsyncQueueLimit(ConfNull, 16U);
+  WasmEdge_ConfigureSetAsyncQueueLimit(Conf, 16U);
+  EXPECT_NE(WasmEdge_ConfigureGetAsyncQueueLimit(ConfNull), 16U);
+  EXPECT_EQ(WasmEdge_ConfigureGetAsyncQueueLimit(Conf), 16U);
+  WasmEdge_ConfigureSetAsyncThreadAffinity(ConfNull, true);
+  WasmEdge_ConfigureSetAsyncThreadAffinity(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsAsyncThreadAffinity(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureIsAsyncThreadAffinity(Conf));
+  WasmEdge_ConfigureSetPerfMap(ConfNull, true);
+  WasmEdge_ConfigureSetPerfMap(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsPerfMap(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureIsPerfMap(Conf));
   // Tests for AOT compiler configurations.
   WasmEdge_ConfigureCompilerSetOptimizationLevel(
       ConfNull, WasmEdge_CompilerOptimizationLevel_Os);
@@ -452,6 +469,10 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureCompilerSetInterruptible(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureCompilerIsInterruptible(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureCompilerIsInterruptible(Conf), true);
+  WasmEdge_ConfigureCompilerSetCacheSizeLimit(ConfNull, 1024);
+  WasmEdge_ConfigureCompilerSetCacheSizeLimit(Conf, 1024);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetCacheSizeLimit(ConfNull), 0U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetCacheSizeLimit(Conf), 1024U);
   // Tests for Statistics configurations.
   WasmEdge_ConfigureStatisticsSetInstructionCounting(ConfNull, true);
   WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
@@ -472,6 +493,46 @@ TEST(APICoreTest, Configure) {
   EXPECT_TRUE(true);
 }
 
+TEST(APICoreTest, Metrics) {
+  WasmEdge_MetricsSetEnabled(true);
+  EXPECT_TRUE(WasmEdge_MetricsIsEnabled());
+  WasmEdge_MetricsSetEnabled(false);
+  EXPECT_FALSE(WasmEdge_MetricsIsEnabled());
+  // Creating a module instance is counted.
+  WasmEdge_String ModName = WasmEdge_StringCreateByCString("metrics");
+  WasmEdge_ModuleInstanceDelete(WasmEdge_ModuleInstanceCreate(ModName));
+  WasmEdge_StringDelete(ModName);
+
+  WasmEdge_MetricsSnapshotContext *SnapCxt = WasmEdge_MetricsSnapshotCreate();
+  EXPECT_NE(SnapCxt, nullptr);
+  uint32_t Len = WasmEdge_MetricsSnapshotGetLength(SnapCxt);
+  EXPECT_GT(Len, 0U);
+  bool Found = false;
+  for (uint32_t I = 0; I < Len; I++) {
+    WasmEdge_String Name = WasmEdge_MetricsSnapshotGetName(SnapCxt, I);
+    if (std::string_view(Name.Buf, Name.Length) ==
+        std::string_view("wasmedge_instances_created_total")) {
+      Found = true;
+      EXPECT_EQ(WasmEdge_MetricsSnapshotGetLabels(SnapCxt, I).Length, 0U);
+      EXPECT_GE(WasmEdge_MetricsSnapshotGetValue(SnapCxt, I), 1.0);
+    }
+  }
+  EXPECT_TRUE(Found);
+  EXPECT_EQ(WasmEdge_MetricsSnapshotGetName(SnapCxt, Len).Length, 0U);
+  EXPECT_EQ(WasmEdge_MetricsSnapshotGetLength(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_MetricsSnapshotGetValue(nullptr, 0), 0.0);
+  WasmEdge_MetricsSnapshotDelete(SnapCxt);
+  WasmEdge_MetricsSnapshotDelete(nullptr);
+  EXPECT_TRUE(true);
+
+  uint32_t TextLen = WasmEdge_MetricsDumpPrometheus(nullptr, 0);
+  EXPECT_GT(TextLen, 0U);
+  std::string Text(TextLen, '\0');
+  EXPECT_EQ(WasmEdge_MetricsDumpPrometheus(Text.data(), TextLen), TextLen);
+  EXPECT_NE(Text.find("# TYPE wasmedge_instances_created_total counter\n"),
+            std::string::npos);
+}
+
 TEST(APICoreTest, FunctionType) {
   std::vector<WasmEdge_ValType> Param = {
       WasmEdge_ValType_I32,  WasmEdge_ValType_I64, WasmEdge_ValType_ExternRef,
@@ -1398,6 +1459,44 @@ TEST(APICoreTest, ExecutorWithStatistics) {
       isErrMatch(WasmEdge_ErrCategory_UserLevelError, 0x5678U,
                  WasmEdge_ExecutorInvoke(ExecCxt, FuncCxt, nullptr, 0, R, 1)));
 
+  // Invoke function by the function handle
+  FuncName = WasmEdge_StringCreateByCString("func-add");
+  FuncCxt = WasmEdge_ModuleInstanceFindFunction(HostMod, FuncName);
+  EXPECT_NE(FuncCxt, nullptr);
+  WasmEdge_StringDelete(FuncName);
+  EXPECT_EQ(WasmEdge_FunctionHandleCreate(nullptr, FuncCxt), nullptr);
+  EXPECT_EQ(WasmEdge_FunctionHandleCreate(ExecCxt, nullptr), nullptr);
+  WasmEdge_FunctionHandleContext *Handle =
+      WasmEdge_FunctionHandleCreate(ExecCxt, FuncCxt);
+  EXPECT_NE(Handle, nullptr);
+  EXPECT_EQ(WasmEdge_FunctionHandleGetFunctionType(Handle),
+            WasmEdge_FunctionInstanceGetFunctionType(FuncCxt));
+  EXPECT_EQ(WasmEdge_FunctionHandleGetFunctionType(nullptr), nullptr);
+  EXPECT_EQ(WasmEdge_FunctionHandleGetParametersLength(Handle), 2U);
+  EXPECT_EQ(WasmEdge_FunctionHandleGetParametersLength(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_FunctionHandleGetReturnsLength(Handle), 1U);
+  EXPECT_EQ(WasmEdge_FunctionHandleGetReturnsLength(nullptr), 0U);
+  TestValue = 5000;
+  uint128_t Slots[3] = {WasmEdge_ValueGenExternRef(&TestValue).Value,
+                        WasmEdge_ValueGenI32(1500).Value,
+                        WasmEdge_ValueGenI32(0).Value};
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_FunctionHandleInvoke(Handle, Slots, 2, Slots + 2, 1)));
+  EXPECT_EQ(6500, WasmEdge_ValueGetI32(
+                      WasmEdge_Value{Slots[2], WasmEdge_ValType_I32}));
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_FuncSigMismatch,
+      WasmEdge_FunctionHandleInvoke(Handle, Slots, 1, Slots + 2, 1)));
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_FuncSigMismatch,
+      WasmEdge_FunctionHandleInvoke(Handle, Slots, 2, Slots + 2, 0)));
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_WrongVMWorkflow,
+      WasmEdge_FunctionHandleInvoke(nullptr, Slots, 2, Slots + 2, 1)));
+  WasmEdge_FunctionHandleDelete(Handle);
+  WasmEdge_FunctionHandleDelete(nullptr);
+  EXPECT_TRUE(true);
+
   // Statistics get instruction count
   EXPECT_GT(WasmEdge_StatisticsGetInstrCount(Stat), 0ULL);
   EXPECT_EQ(WasmEdge_StatisticsGetInstrCount(nullptr), 0ULL);
@@ -2944,6 +3043,89 @@ TEST(APICoreTest, VM) {
   EXPECT_TRUE(
       WasmEdge_ResultOK(WasmEdge_VMExecute(VM, FuncName, P, 2, nullptr, 1)));
 
+  // VM function handle
+  {
+    EXPECT_EQ(WasmEdge_VMGetFunctionHandle(nullptr, FuncName), nullptr);
+    EXPECT_EQ(WasmEdge_VMGetFunctionHandle(VM, FuncName2), nullptr);
+    EXPECT_EQ(WasmEdge_VMGetFunctionHandleRegistered(VM, ModName, FuncName2),
+              nullptr);
+    WasmEdge_FunctionHandleContext *Handle =
+        WasmEdge_VMGetFunctionHandle(VM, FuncName);
+    EXPECT_NE(Handle, nullptr);
+    uint128_t Slots[4] = {P[0].Value, P[1].Value, 0, 0};
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_FunctionHandleInvoke(Handle, Slots, 2, Slots + 2, 2)));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{Slots[2], WasmEdge_ValType_I32}));
+    EXPECT_EQ(912, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{Slots[3], WasmEdge_ValType_I32}));
+    // Batch of two calls
+    uint128_t BatchParams[4] = {P[0].Value, P[1].Value, P[1].Value,
+                                P[0].Value};
+    uint128_t BatchReturns[4] = {0, 0, 0, 0};
+    WasmEdge_Result BatchResults[2];
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_FunctionHandleInvokeBatch(
+        Handle, BatchParams, BatchReturns, 2, nullptr)));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{BatchReturns[0], WasmEdge_ValType_I32}));
+    EXPECT_EQ(912, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{BatchReturns[1], WasmEdge_ValType_I32}));
+    EXPECT_EQ(912, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{BatchReturns[2], WasmEdge_ValType_I32}));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{BatchReturns[3], WasmEdge_ValType_I32}));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_FunctionHandleInvokeBatch(
+        Handle, BatchParams, BatchReturns, 2, BatchResults)));
+    EXPECT_TRUE(WasmEdge_ResultOK(BatchResults[0]));
+    EXPECT_TRUE(WasmEdge_ResultOK(BatchResults[1]));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_FunctionHandleInvokeBatch(
+        Handle, nullptr, nullptr, 0, nullptr)));
+    EXPECT_TRUE(isErrMatch(
+        WasmEdge_ErrCode_WrongVMWorkflow,
+        WasmEdge_FunctionHandleInvokeBatch(nullptr, BatchParams, BatchReturns,
+                                           2, nullptr)));
+    WasmEdge_FunctionHandleDelete(Handle);
+    // Batch with a trapping call. The table slot 0 is uninitialized.
+    WasmEdge_String CallIndName =
+        WasmEdge_StringCreateByCString("func-call-indirect");
+    Handle = WasmEdge_VMGetFunctionHandle(VM, CallIndName);
+    WasmEdge_StringDelete(CallIndName);
+    EXPECT_NE(Handle, nullptr);
+    uint128_t TrapParams[3] = {WasmEdge_ValueGenI32(2).Value,
+                               WasmEdge_ValueGenI32(0).Value,
+                               WasmEdge_ValueGenI32(3).Value};
+    uint128_t TrapReturns[3] = {0, 0, 0};
+    WasmEdge_Result TrapResults[3];
+    // The trap is recorded for its call, and the batch goes on.
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_FunctionHandleInvokeBatch(
+        Handle, TrapParams, TrapReturns, 3, TrapResults)));
+    EXPECT_TRUE(WasmEdge_ResultOK(TrapResults[0]));
+    EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_UninitializedElement,
+                           TrapResults[1]));
+    EXPECT_TRUE(WasmEdge_ResultOK(TrapResults[2]));
+    EXPECT_EQ(1, WasmEdge_ValueGetI32(
+                     WasmEdge_Value{TrapReturns[0], WasmEdge_ValType_I32}));
+    EXPECT_EQ(2, WasmEdge_ValueGetI32(
+                     WasmEdge_Value{TrapReturns[2], WasmEdge_ValType_I32}));
+    // Without the results, the batch stops at the trap and returns it.
+    TrapReturns[0] = TrapReturns[1] = TrapReturns[2] = 0;
+    EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_UninitializedElement,
+                           WasmEdge_FunctionHandleInvokeBatch(
+                               Handle, TrapParams, TrapReturns, 3, nullptr)));
+    EXPECT_EQ(1, WasmEdge_ValueGetI32(
+                     WasmEdge_Value{TrapReturns[0], WasmEdge_ValType_I32}));
+    EXPECT_EQ(0, WasmEdge_ValueGetI32(
+                     WasmEdge_Value{TrapReturns[2], WasmEdge_ValType_I32}));
+    WasmEdge_FunctionHandleDelete(Handle);
+    Handle = WasmEdge_VMGetFunctionHandleRegistered(VM, ModName, FuncName);
+    EXPECT_NE(Handle, nullptr);
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_FunctionHandleInvoke(Handle, Slots, 2, Slots + 2, 2)));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(
+                       WasmEdge_Value{Slots[2], WasmEdge_ValType_I32}));
+    WasmEdge_FunctionHandleDelete(Handle);
+  }
+
   // VM execute registered
   R[0] = WasmEdge_ValueGenI32(0);
   R[1] = WasmEdge_ValueGenI32(0);
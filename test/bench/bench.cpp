@@ -0,0 +1,406 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/bench/bench.cpp - Benchmark suite -------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmark suite of the interpreter and the AOT
+/// runtime. The results are written in JSON.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/log.h"
+#include "common/version.h"
+#include "executor/executor.h"
+#include "kernels.h"
+#include "loader/loader.h"
+#include "po/argument_parser.h"
+#include "runtime/instance/module.h"
+#include "runtime/storemgr.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+#include "aot/compiler.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+using Clock = std::chrono::steady_clock;
+
+class HostInc : public Runtime::HostFunction<HostInc> {
+public:
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t X) {
+    return X + 1;
+  }
+};
+
+class HostEnv : public Runtime::Instance::ModuleInstance {
+public:
+  HostEnv() : ModuleInstance("env") {
+    addHostFunc("inc", std::make_unique<HostInc>());
+  }
+  ~HostEnv() noexcept override = default;
+};
+
+const std::array<ValType, 1> RunTypes = {ValType::I32};
+
+/// Get the least seconds of a call over the repeats.
+template <typename FuncT> double measure(uint32_t Repeat, FuncT &&Func) {
+  auto Best = Clock::duration::max();
+  for (uint32_t I = 0; I < std::max(Repeat, UINT32_C(1)); ++I) {
+    const auto Start = Clock::now();
+    Func();
+    Best = std::min(Best, Clock::now() - Start);
+  }
+  return std::chrono::duration<double>(Best).count();
+}
+
+struct Throughput {
+  uint32_t Iterations = 0;
+  double Seconds = 0.0;
+  uint64_t Checksum = 0;
+};
+
+/// Run `run(Iterations)` of the instantiated module.
+Expect<Throughput> runKernel(VM::VM &VM, uint32_t Iterations,
+                             uint32_t Repeat) {
+  Throughput Result;
+  Result.Iterations = Iterations;
+  const std::array<ValVariant, 1> Args = {Iterations};
+  Expect<void> Status;
+  Result.Seconds = measure(Repeat, [&]() {
+    if (auto Res = VM.execute("run"sv, Args, RunTypes); !Res) {
+      Status = Unexpect(Res);
+    } else {
+      Result.Checksum = (*Res)[0].first.get<uint64_t>();
+    }
+  });
+  if (!Status) {
+    return Unexpect(Status);
+  }
+  return Result;
+}
+
+/// Write the fields of the throughput, without the closing brace.
+void writeThroughput(std::ostream &OS, const Throughput &Result) {
+  OS << "{\"iterations\": " << Result.Iterations
+     << ", \"seconds\": " << Result.Seconds << ", \"iterations_per_second\": "
+     << Result.Iterations / Result.Seconds
+     << ", \"checksum\": " << Result.Checksum;
+}
+
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+/// Compile the kernel into a universal wasm file with the AOT section.
+Expect<std::filesystem::path> compileKernel(const Configure &Conf,
+                                            const Bench::Kernel &Kernel,
+                                            double &Seconds) {
+  Loader::Loader Load(Conf);
+  Validator::Validator Valid(Conf);
+  AOT::Compiler Compiler(Conf);
+  auto Path = std::filesystem::temp_directory_path() /
+              std::filesystem::u8path("wasmedge-bench-"s + Kernel.Name +
+                                      ".wasm"s);
+  const auto Start = Clock::now();
+  auto Mod = Load.parseModule(Kernel.Wasm);
+  if (!Mod) {
+    return Unexpect(Mod);
+  }
+  if (auto Res = Valid.validate(**Mod); !Res) {
+    return Unexpect(Res);
+  }
+  if (auto Res = Compiler.compile(Kernel.Wasm, **Mod, Path); !Res) {
+    return Unexpect(Res);
+  }
+  Seconds = std::chrono::duration<double>(Clock::now() - Start).count();
+  return Path;
+}
+
+/// Compile the kernel with the configuration, and run it in AOT.
+Expect<Throughput> runAOTKernel(const Configure &Conf,
+                                const Bench::Kernel &Kernel,
+                                uint32_t Iterations, uint32_t Repeat,
+                                double &CompileSeconds) {
+  auto Path = compileKernel(Conf, Kernel, CompileSeconds);
+  if (!Path) {
+    return Unexpect(Path);
+  }
+  VM::VM AOTVM(Conf);
+  Expect<Throughput> AOT = Unexpect(ErrCode::Value::WrongVMWorkflow);
+  if (AOTVM.loadWasm(*Path) && AOTVM.validate() && AOTVM.instantiate()) {
+    AOT = runKernel(AOTVM, Iterations, Repeat);
+  }
+  std::error_code Error;
+  std::filesystem::remove(*Path, Error);
+  return AOT;
+}
+#endif
+
+/// Benchmark the stages and the execution of a kernel.
+bool benchKernel(std::ostream &OS, const Configure &Conf,
+                 const Bench::Kernel &Kernel, uint32_t Scale, uint32_t Repeat,
+                 bool EnableAOT) {
+  constexpr uint32_t StageRepeat = 100;
+  Loader::Loader Load(Conf);
+  Validator::Validator Valid(Conf);
+  Executor::Executor Exec(Conf);
+  Runtime::StoreManager Store;
+
+  auto Mod = Load.parseModule(Kernel.Wasm);
+  if (!Mod || !Valid.validate(**Mod)) {
+    spdlog::error("Kernel {} is invalid", Kernel.Name);
+    return false;
+  }
+  const double LoadSeconds =
+      measure(StageRepeat, [&]() { Load.parseModule(Kernel.Wasm); });
+  const double ValidateSeconds =
+      measure(StageRepeat, [&]() { Valid.validate(**Mod); });
+  const double InstantiateSeconds =
+      measure(StageRepeat, [&]() { Exec.instantiateModule(Store, **Mod); });
+
+  VM::VM VM(Conf);
+  if (!VM.loadWasm(**Mod) || !VM.validate() || !VM.instantiate()) {
+    spdlog::error("Kernel {} failed to instantiate", Kernel.Name);
+    return false;
+  }
+  auto Interpreter = runKernel(VM, Kernel.Iterations * Scale, Repeat);
+  if (!Interpreter) {
+    spdlog::error("Kernel {} failed: {}", Kernel.Name, Interpreter.error());
+    return false;
+  }
+
+  OS << "    {\"name\": \"" << Kernel.Name << "\", \"description\": \""
+     << Kernel.Description << "\",\n     \"load_seconds\": " << LoadSeconds
+     << ", \"validate_seconds\": " << ValidateSeconds
+     << ", \"instantiate_seconds\": " << InstantiateSeconds
+     << ",\n     \"interpreter\": ";
+  writeThroughput(OS, *Interpreter);
+  OS << "},\n     \"aot\": ";
+
+  bool Succeeded = true;
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  const uint32_t Iterations = Kernel.Iterations * Scale;
+  double CompileSeconds = 0.0;
+  if (!EnableAOT) {
+    OS << "null";
+  } else if (auto AOT = runAOTKernel(Conf, Kernel, Iterations, Repeat,
+                                     CompileSeconds);
+             !AOT) {
+    spdlog::error("Kernel {} failed in AOT: {}", Kernel.Name, AOT.error());
+    OS << "null";
+    Succeeded = false;
+  } else {
+    writeThroughput(OS, *AOT);
+    OS << ", \"compile_seconds\": " << CompileSeconds
+       << ", \"speedup\": " << Interpreter->Seconds / AOT->Seconds;
+    if (AOT->Checksum != Interpreter->Checksum) {
+      spdlog::error("Kernel {} checksum mismatch in AOT", Kernel.Name);
+      Succeeded = false;
+    }
+
+    // Again with the instruction counting and the gas measuring compiled in.
+    Configure MeteredConf(Conf);
+    MeteredConf.getStatisticsConfigure().setInstructionCounting(true);
+    MeteredConf.getStatisticsConfigure().setCostMeasuring(true);
+    double MeteredCompileSeconds = 0.0;
+    OS << ",\n     \"metered\": ";
+    if (auto Metered = runAOTKernel(MeteredConf, Kernel, Iterations, Repeat,
+                                    MeteredCompileSeconds);
+        !Metered) {
+      spdlog::error("Kernel {} failed in metered AOT: {}", Kernel.Name,
+                    Metered.error());
+      OS << "null";
+      Succeeded = false;
+    } else {
+      writeThroughput(OS, *Metered);
+      OS << ", \"overhead\": " << Metered->Seconds / AOT->Seconds << '}';
+      if (Metered->Checksum != Interpreter->Checksum) {
+        spdlog::error("Kernel {} checksum mismatch in metered AOT",
+                      Kernel.Name);
+        Succeeded = false;
+      }
+    }
+    OS << '}';
+  }
+#else
+  static_cast<void>(EnableAOT);
+  OS << "null";
+#endif
+  OS << '}';
+  return Succeeded;
+}
+
+/// Benchmark the round trip of calling a host function from wasm.
+bool benchHostCall(std::ostream &OS, const Configure &Conf, uint32_t Scale,
+                   uint32_t Repeat) {
+  HostEnv Env;
+  VM::VM VM(Conf);
+  if (!VM.registerModule(Env) || !VM.loadWasm(Bench::getHostCallModule()) ||
+      !VM.validate() || !VM.instantiate()) {
+    spdlog::error("Host call module failed to instantiate");
+    return false;
+  }
+  const uint32_t Calls = 100000 * Scale;
+  auto Result = runKernel(VM, Calls, Repeat);
+  if (!Result || Result->Checksum != Calls) {
+    spdlog::error("Host call module failed");
+    return false;
+  }
+  OS << "{\"calls\": " << Calls
+     << ", \"nanoseconds_per_call\": " << Result->Seconds * 1e9 / Calls << '}';
+  return true;
+}
+
+/// Benchmark the overhead of dispatching an execution to a new thread.
+bool benchAsync(std::ostream &OS, const Configure &Conf,
+                const Bench::Kernel &Kernel, uint32_t Scale,
+                uint32_t Repeat) {
+  VM::VM VM(Conf);
+  if (!VM.loadWasm(Kernel.Wasm) || !VM.validate() || !VM.instantiate()) {
+    spdlog::error("Async module failed to instantiate");
+    return false;
+  }
+  const uint32_t Calls = 1000 * Scale;
+  const std::array<ValVariant, 1> Args = {UINT32_C(0)};
+  bool Succeeded = true;
+  const double SyncSeconds = measure(Repeat, [&]() {
+    for (uint32_t I = 0; I < Calls; ++I) {
+      Succeeded &= static_cast<bool>(VM.execute("run"sv, Args, RunTypes));
+    }
+  });
+  const double AsyncSeconds = measure(Repeat, [&]() {
+    for (uint32_t I = 0; I < Calls; ++I) {
+      Succeeded &=
+          static_cast<bool>(VM.asyncExecute("run"sv, Args, RunTypes).get());
+    }
+  });
+  if (!Succeeded) {
+    spdlog::error("Async execution failed");
+    return false;
+  }
+  OS << "{\"calls\": " << Calls << ", \"sync_microseconds_per_call\": "
+     << SyncSeconds * 1e6 / Calls << ", \"async_microseconds_per_call\": "
+     << AsyncSeconds * 1e6 / Calls << '}';
+  return true;
+}
+
+} // namespace
+
+int main(int Argc, const char *Argv[]) {
+  namespace PO = WasmEdge::PO;
+  std::ios::sync_with_stdio(false);
+  WasmEdge::Log::setErrorLoggingLevel();
+
+  PO::List<std::string> Names(
+      PO::Description("Kernels to run, all kernels if none"sv),
+      PO::MetaVar("KERNELS"sv));
+  PO::Option<std::string> Output(
+      PO::Description("Write the JSON results to `OUTPUT_PATH` instead of "
+                      "the standard output."sv),
+      PO::MetaVar("OUTPUT_PATH"sv), PO::DefaultValue<std::string>(""));
+  PO::Option<uint64_t> Scale(
+      PO::Description("Multiply the iterations of every benchmark."sv),
+      PO::MetaVar("SCALE"sv), PO::DefaultValue<uint64_t>(1));
+  PO::Option<uint64_t> Repeat(
+      PO::Description("Repeat every measurement and keep the fastest."sv),
+      PO::MetaVar("REPEAT"sv), PO::DefaultValue<uint64_t>(3));
+  PO::Option<PO::Toggle> DisableAOT(
+      PO::Description("Only benchmark the interpreter."sv));
+  PO::Option<PO::Toggle> ListKernels(
+      PO::Description("List the bundled kernels."sv));
+
+  auto Parser = PO::ArgumentParser();
+  Parser.add_option(Names)
+      .add_option("output"sv, Output)
+      .add_option("scale"sv, Scale)
+      .add_option("repeat"sv, Repeat)
+      .add_option("disable-aot"sv, DisableAOT)
+      .add_option("list"sv, ListKernels);
+  if (!Parser.parse(Argc, Argv)) {
+    return EXIT_FAILURE;
+  }
+  if (Parser.isVersion()) {
+    std::cout << Argv[0] << " version "sv << WasmEdge::kVersionString << '\n';
+    return EXIT_SUCCESS;
+  }
+
+  const auto Kernels = WasmEdge::Bench::getKernels();
+  if (ListKernels.value()) {
+    for (const auto &Kernel : Kernels) {
+      std::cout << Kernel.Name << ": " << Kernel.Description << '\n';
+    }
+    return EXIT_SUCCESS;
+  }
+  std::vector<const WasmEdge::Bench::Kernel *> Selected;
+  for (const auto &Kernel : Kernels) {
+    if (Names.value().empty() ||
+        std::find(Names.value().begin(), Names.value().end(), Kernel.Name) !=
+            Names.value().end()) {
+      Selected.push_back(&Kernel);
+    }
+  }
+  if (Selected.size() < Names.value().size()) {
+    spdlog::error("Unknown kernel name, use --list to show the kernels");
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream File;
+  if (!Output.value().empty()) {
+    File.open(std::filesystem::u8path(Output.value()));
+    if (!File) {
+      spdlog::error("Failed to open output {}", Output.value());
+      return EXIT_FAILURE;
+    }
+  }
+  std::ostream &OS = Output.value().empty() ? std::cout : File;
+
+  WasmEdge::Configure Conf;
+#ifdef WASMEDGE_BUILD_AOT_RUNTIME
+  const bool EnableAOT = !DisableAOT.value();
+#else
+  const bool EnableAOT = false;
+#endif
+  const auto ScaleValue =
+      static_cast<uint32_t>(std::clamp<uint64_t>(Scale.value(), 1, 1000));
+  const auto RepeatValue =
+      static_cast<uint32_t>(std::clamp<uint64_t>(Repeat.value(), 1, 1000));
+
+  bool Succeeded = true;
+  OS << "{\n  \"version\": \"" << WasmEdge::kVersionString
+     << "\",\n  \"aot\": " << (EnableAOT ? "true" : "false")
+     << ",\n  \"scale\": " << ScaleValue << ",\n  \"kernels\": [\n";
+  const char *Sep = "";
+  for (const auto *Kernel : Selected) {
+    OS << Sep;
+    Succeeded &= benchKernel(OS, Conf, *Kernel, ScaleValue, RepeatValue,
+                             EnableAOT);
+    Sep = ",\n";
+  }
+  OS << "\n  ],\n  \"host_call\": ";
+  Succeeded &= benchHostCall(OS, Conf, ScaleValue, RepeatValue);
+  OS << ",\n  \"async_dispatch\": ";
+  // The near empty run of the last kernel.
+  Succeeded &= benchAsync(OS, Conf, Kernels.back(), ScaleValue, RepeatValue);
+  OS << "\n}\n";
+  return Succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
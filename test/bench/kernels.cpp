@@ -0,0 +1,543 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "kernels.h"
+
+#include <array>
+
+namespace WasmEdge {
+namespace Bench {
+
+namespace {
+
+using namespace std::literals;
+
+/// Block type of the blocks without results.
+constexpr uint32_t kEmptyBlock = 0x40U;
+
+void writeU32(std::vector<Byte> &Bytes, uint32_t Value) {
+  do {
+    Byte B = Value & 0x7FU;
+    Value >>= 7;
+    if (Value != 0) {
+      B |= 0x80U;
+    }
+    Bytes.push_back(B);
+  } while (Value != 0);
+}
+
+void writeS64(std::vector<Byte> &Bytes, int64_t Value) {
+  while (true) {
+    const Byte B = Value & 0x7F;
+    Value >>= 7;
+    if ((Value == 0 && (B & 0x40U) == 0) || (Value == -1 && (B & 0x40U))) {
+      Bytes.push_back(B);
+      return;
+    }
+    Bytes.push_back(B | 0x80U);
+  }
+}
+
+void writeName(std::vector<Byte> &Bytes, std::string_view Name) {
+  writeU32(Bytes, static_cast<uint32_t>(Name.size()));
+  Bytes.insert(Bytes.end(), Name.begin(), Name.end());
+}
+
+void writeTypes(std::vector<Byte> &Bytes, const std::vector<ValType> &Types) {
+  writeU32(Bytes, static_cast<uint32_t>(Types.size()));
+  for (const auto Type : Types) {
+    Bytes.push_back(static_cast<Byte>(Type));
+  }
+}
+
+void writeSection(std::vector<Byte> &Bytes, Byte Id,
+                  const std::vector<Byte> &Content) {
+  Bytes.push_back(Id);
+  writeU32(Bytes, static_cast<uint32_t>(Content.size()));
+  Bytes.insert(Bytes.end(), Content.begin(), Content.end());
+}
+
+/// Offset expression `i32.const Offset end`.
+void writeOffset(std::vector<Byte> &Bytes, uint32_t Offset) {
+  Bytes.push_back(static_cast<Byte>(OpCode::I32__const));
+  writeS64(Bytes, static_cast<int32_t>(Offset));
+  Bytes.push_back(static_cast<Byte>(OpCode::End));
+}
+
+/// 32x32 i32 matrix multiplication.
+Kernel matmul() {
+  constexpr int32_t Dim = 32;
+  constexpr uint32_t A = 0, B = 4096, C = 8192;
+  // Locals: 0 n, 1 r, 2 i, 3 j, 4 k, 5 sum, 6 acc.
+  Code Body;
+  Body.forConst(2, Dim * Dim, [](Code &F) {
+    F.get(2).i32Const(2).op(OpCode::I32__shl).get(2).store32(A);
+    F.get(2).i32Const(2).op(OpCode::I32__shl);
+    F.get(2).i32Const(3).op(OpCode::I32__mul).i32Const(1);
+    F.op(OpCode::I32__add).store32(B);
+  });
+  Body.forLocal(1, 0, [](Code &R) {
+    R.forConst(2, Dim, [](Code &I) {
+      I.forConst(3, Dim, [](Code &J) {
+        J.i32Const(0).set(5);
+        J.forConst(4, Dim, [](Code &K) {
+          // sum += a[i][k] * b[k][j]
+          K.get(2).i32Const(5).op(OpCode::I32__shl).get(4);
+          K.op(OpCode::I32__add).i32Const(2).op(OpCode::I32__shl).load32(A);
+          K.get(4).i32Const(5).op(OpCode::I32__shl).get(3);
+          K.op(OpCode::I32__add).i32Const(2).op(OpCode::I32__shl).load32(B);
+          K.op(OpCode::I32__mul).get(5).op(OpCode::I32__add).set(5);
+        });
+        // c[i][j] = sum, acc += sum
+        J.get(2).i32Const(5).op(OpCode::I32__shl).get(3);
+        J.op(OpCode::I32__add).i32Const(2).op(OpCode::I32__shl);
+        J.get(5).store32(C);
+        J.get(6).get(5).op(OpCode::I64__extend_i32_u);
+        J.op(OpCode::I64__add).set(6);
+      });
+    });
+  });
+  Body.get(6);
+
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I64});
+  Builder.setMemory(1);
+  Builder.addExport("run"sv,
+                    Builder.addFunction(Type,
+                                        {ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I64},
+                                        Body));
+  return Kernel{"matmul", "32x32 i32 matrix multiplication", Builder.build(),
+                4};
+}
+
+/// ChaCha20 quarter rounds over four state words.
+Kernel chacha20() {
+  // Locals: 0 n, 1 r, 2 i, 3 a, 4 b, 5 c, 6 d.
+  auto Step = [](Code &F, uint32_t X, uint32_t Y, uint32_t Z, int32_t Rot) {
+    // x += y; z ^= x; z = rotl(z, Rot)
+    F.get(X).get(Y).op(OpCode::I32__add).set(X);
+    F.get(Z).get(X).op(OpCode::I32__xor).i32Const(Rot);
+    F.op(OpCode::I32__rotl).set(Z);
+  };
+  Code Body;
+  Body.i32Const(0x61707865).set(3).i32Const(0x3320646e).set(4);
+  Body.i32Const(0x79622d32).set(5).i32Const(0x6b206574).set(6);
+  Body.forLocal(1, 0, [&Step](Code &R) {
+    R.forConst(2, 4096, [&Step](Code &I) {
+      I.get(3).get(2).op(OpCode::I32__add).set(3);
+      Step(I, 3, 4, 6, 16);
+      Step(I, 5, 6, 4, 12);
+      Step(I, 3, 4, 6, 8);
+      Step(I, 5, 6, 4, 7);
+    });
+  });
+  Body.get(3).get(4).op(OpCode::I32__xor).op(OpCode::I64__extend_i32_u);
+  Body.i64Const(32).op(OpCode::I64__shl);
+  Body.get(5).get(6).op(OpCode::I32__xor).op(OpCode::I64__extend_i32_u);
+  Body.op(OpCode::I64__or);
+
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I64});
+  Builder.addExport("run"sv,
+                    Builder.addFunction(Type,
+                                        {ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I32},
+                                        Body));
+  return Kernel{"chacha20", "ChaCha20 quarter rounds", Builder.build(), 16};
+}
+
+/// Bitwise CRC-32 over a 4 KiB buffer.
+Kernel crc32() {
+  constexpr int32_t Size = 4096;
+  // Locals: 0 n, 1 r, 2 i, 3 k, 4 crc, 5 acc.
+  Code Body;
+  Body.forConst(2, Size, [](Code &F) {
+    F.get(2).get(2).i32Const(7).op(OpCode::I32__mul).store8(0);
+  });
+  Body.forLocal(1, 0, [](Code &R) {
+    R.i32Const(-1).set(4);
+    R.forConst(2, Size, [](Code &I) {
+      I.get(4).get(2).load8(0).op(OpCode::I32__xor).set(4);
+      I.forConst(3, 8, [](Code &K) {
+        // crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1))
+        K.get(4).i32Const(1).op(OpCode::I32__shr_u);
+        K.i32Const(static_cast<int32_t>(0xEDB88320U));
+        K.i32Const(0).get(4).i32Const(1).op(OpCode::I32__and);
+        K.op(OpCode::I32__sub).op(OpCode::I32__and);
+        K.op(OpCode::I32__xor).set(4);
+      });
+    });
+    R.get(5).get(4).i32Const(-1).op(OpCode::I32__xor);
+    R.op(OpCode::I64__extend_i32_u).op(OpCode::I64__add).set(5);
+  });
+  Body.get(5);
+
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I64});
+  Builder.setMemory(1);
+  Builder.addExport("run"sv,
+                    Builder.addFunction(Type,
+                                        {ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I32,
+                                         ValType::I64},
+                                        Body));
+  return Kernel{"crc32", "Bitwise CRC-32 of a 4 KiB buffer", Builder.build(),
+                8};
+}
+
+/// Tokenizer of a JSON text, dispatching on the byte classes by br_table.
+Kernel json() {
+  std::string Text;
+  while (Text.size() < 3000) {
+    Text += R"({"id":12345,"tags":["wasm","edge"],"pos":[1,22,333],)"
+            R"("ok":true,"name":"item"},)";
+  }
+  Text.back() = ']';
+  Text.insert(Text.begin(), '[');
+  constexpr uint32_t ClassOffset = 4096;
+  // Classes: 0 other, 1 open, 2 close, 3 quote, 4 digit, 5 separator.
+  std::vector<Byte> Classes(256, 0);
+  Classes['{'] = Classes['['] = 1;
+  Classes['}'] = Classes[']'] = 2;
+  Classes['"'] = 3;
+  for (char C = '0'; C <= '9'; ++C) {
+    Classes[static_cast<Byte>(C)] = 4;
+  }
+  Classes[','] = Classes[':'] = 5;
+
+  // Locals: 0 n, 1 r, 2 i, 3 c, 4 depth, 5 num, 6 acc.
+  Code Body;
+  Body.forLocal(1, 0, [&Text](Code &R) {
+    R.forConst(2, static_cast<int32_t>(Text.size()), [](Code &I) {
+      I.get(2).load8(0).set(3);
+      for (uint32_t B = 0; B < 7; ++B) {
+        I.op(OpCode::Block).u32(kEmptyBlock);
+      }
+      I.get(3).load8(ClassOffset);
+      I.op(OpCode::Br_table).u32(6);
+      for (uint32_t L = 0; L < 6; ++L) {
+        I.u32(L);
+      }
+      I.u32(0);
+      // Other.
+      I.op(OpCode::End).op(OpCode::Br).u32(5);
+      // Open: acc += ++depth
+      I.op(OpCode::End);
+      I.get(4).i32Const(1).op(OpCode::I32__add).set(4);
+      I.get(6).get(4).op(OpCode::I64__extend_i32_u);
+      I.op(OpCode::I64__add).set(6);
+      I.op(OpCode::Br).u32(4);
+      // Close: --depth
+      I.op(OpCode::End);
+      I.get(4).i32Const(1).op(OpCode::I32__sub).set(4);
+      I.op(OpCode::Br).u32(3);
+      // Quote: acc += 7
+      I.op(OpCode::End);
+      I.get(6).i64Const(7).op(OpCode::I64__add).set(6);
+      I.op(OpCode::Br).u32(2);
+      // Digit: num = num * 10 + c - '0'
+      I.op(OpCode::End);
+      I.get(5).i32Const(10).op(OpCode::I32__mul).get(3);
+      I.op(OpCode::I32__add).i32Const('0').op(OpCode::I32__sub).set(5);
+      I.op(OpCode::Br).u32(1);
+      // Separator: acc += num, num = 0
+      I.op(OpCode::End);
+      I.get(6).get(5).op(OpCode::I64__extend_i32_u);
+      I.op(OpCode::I64__add).set(6);
+      I.i32Const(0).set(5);
+      I.op(OpCode::End);
+    });
+  });
+  Body.get(6);
+
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType({ValType::I32}, {ValType::I64});
+  Builder.setMemory(1);
+  Builder.addData(0, std::vector<Byte>(Text.begin(), Text.end()));
+  Builder.addData(ClassOffset, std::move(Classes));
+  Builder.addExport("run"sv,
+                    Builder.addFunction(Type,
+                                        {ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I32,
+                                         ValType::I32, ValType::I64},
+                                        Body));
+  return Kernel{"json", "JSON tokenizer dispatching by br_table",
+                Builder.build(), 32};
+}
+
+/// Virtual calls through a table of small functions.
+Kernel callIndirect() {
+  ModuleBuilder Builder;
+  const auto RunType = Builder.addType({ValType::I32}, {ValType::I64});
+  const auto FuncType = Builder.addType({ValType::I32}, {ValType::I32});
+  std::vector<uint32_t> Funcs;
+  {
+    Code F;
+    F.get(0).i32Const(3).op(OpCode::I32__mul).i32Const(1);
+    F.op(OpCode::I32__add);
+    Funcs.push_back(Builder.addFunction(FuncType, {}, F));
+  }
+  {
+    Code F;
+    F.get(0).get(0).i32Const(3).op(OpCode::I32__shr_u).op(OpCode::I32__xor);
+    Funcs.push_back(Builder.addFunction(FuncType, {}, F));
+  }
+  {
+    Code F;
+    F.get(0).i32Const(static_cast<int32_t>(0x9E3779B9U));
+    F.op(OpCode::I32__add);
+    Funcs.push_back(Builder.addFunction(FuncType, {}, F));
+  }
+  {
+    Code F;
+    F.get(0).i32Const(7).op(OpCode::I32__rotl);
+    Funcs.push_back(Builder.addFunction(FuncType, {}, F));
+  }
+  Builder.setTable(Funcs);
+
+  // Locals: 0 n, 1 r, 2 i, 3 x.
+  Code Body;
+  Body.i32Const(1).set(3);
+  Body.forLocal(1, 0, [FuncType](Code &R) {
+    R.forConst(2, 4096, [FuncType](Code &I) {
+      // x = table[i & 3](x + i)
+      I.get(3).get(2).op(OpCode::I32__add);
+      I.get(2).i32Const(3).op(OpCode::I32__and);
+      I.op(OpCode::Call_indirect).u32(FuncType).u32(0).set(3);
+    });
+  });
+  Body.get(3).op(OpCode::I64__extend_i32_u);
+  Builder.addExport(
+      "run"sv,
+      Builder.addFunction(
+          RunType, {ValType::I32, ValType::I32, ValType::I32}, Body));
+  return Kernel{"call_indirect", "Indirect calls through a function table",
+                Builder.build(), 32};
+}
+
+} // namespace
+
+Code &Code::op(OpCode Op) {
+  Bytes.push_back(static_cast<Byte>(Op));
+  return *this;
+}
+
+Code &Code::u32(uint32_t Value) {
+  writeU32(Bytes, Value);
+  return *this;
+}
+
+Code &Code::i32Const(int32_t Value) {
+  op(OpCode::I32__const);
+  writeS64(Bytes, Value);
+  return *this;
+}
+
+Code &Code::i64Const(int64_t Value) {
+  op(OpCode::I64__const);
+  writeS64(Bytes, Value);
+  return *this;
+}
+
+Code &Code::load8(uint32_t Offset) {
+  return op(OpCode::I32__load8_u).u32(0).u32(Offset);
+}
+
+Code &Code::load32(uint32_t Offset) {
+  return op(OpCode::I32__load).u32(2).u32(Offset);
+}
+
+Code &Code::store8(uint32_t Offset) {
+  return op(OpCode::I32__store8).u32(0).u32(Offset);
+}
+
+Code &Code::store32(uint32_t Offset) {
+  return op(OpCode::I32__store).u32(2).u32(Offset);
+}
+
+Code &Code::forConst(uint32_t Var, int32_t Limit,
+                     const std::function<void(Code &)> &Body) {
+  return forLoop(
+      Var, [Limit](Code &C) { C.i32Const(Limit); }, Body);
+}
+
+Code &Code::forLocal(uint32_t Var, uint32_t Limit,
+                     const std::function<void(Code &)> &Body) {
+  return forLoop(
+      Var, [Limit](Code &C) { C.get(Limit); }, Body);
+}
+
+Code &Code::forLoop(uint32_t Var, const std::function<void(Code &)> &Limit,
+                    const std::function<void(Code &)> &Body) {
+  i32Const(0).set(Var);
+  op(OpCode::Block).u32(kEmptyBlock);
+  op(OpCode::Loop).u32(kEmptyBlock);
+  get(Var);
+  Limit(*this);
+  op(OpCode::I32__ge_u).op(OpCode::Br_if).u32(1);
+  Body(*this);
+  get(Var).i32Const(1).op(OpCode::I32__add).set(Var);
+  op(OpCode::Br).u32(0);
+  op(OpCode::End);
+  op(OpCode::End);
+  return *this;
+}
+
+uint32_t ModuleBuilder::addType(std::vector<ValType> Params,
+                                std::vector<ValType> Returns) {
+  Types.emplace_back(std::move(Params), std::move(Returns));
+  return static_cast<uint32_t>(Types.size() - 1);
+}
+
+uint32_t ModuleBuilder::addImport(std::string_view Module,
+                                  std::string_view Name, uint32_t TypeIdx) {
+  Imports.emplace_back(std::string(Module), std::string(Name), TypeIdx);
+  return static_cast<uint32_t>(Imports.size() - 1);
+}
+
+uint32_t ModuleBuilder::addFunction(uint32_t TypeIdx,
+                                    std::vector<ValType> Locals,
+                                    const Code &Body) {
+  std::vector<Byte> Func;
+  writeU32(Func, static_cast<uint32_t>(Locals.size()));
+  for (const auto Type : Locals) {
+    writeU32(Func, 1);
+    Func.push_back(static_cast<Byte>(Type));
+  }
+  Func.insert(Func.end(), Body.bytes().begin(), Body.bytes().end());
+  Func.push_back(static_cast<Byte>(OpCode::End));
+  FuncTypes.push_back(TypeIdx);
+  Bodies.push_back(std::move(Func));
+  return static_cast<uint32_t>(Imports.size() + Bodies.size() - 1);
+}
+
+void ModuleBuilder::addExport(std::string_view Name, uint32_t FuncIdx) {
+  Exports.emplace_back(std::string(Name), FuncIdx);
+}
+
+void ModuleBuilder::addData(uint32_t Offset, std::vector<Byte> Data) {
+  Datas.emplace_back(Offset, std::move(Data));
+}
+
+std::vector<Byte> ModuleBuilder::build() const {
+  std::vector<Byte> Bytes = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  std::vector<Byte> Sec;
+
+  writeU32(Sec, static_cast<uint32_t>(Types.size()));
+  for (const auto &[Params, Returns] : Types) {
+    Sec.push_back(0x60U);
+    writeTypes(Sec, Params);
+    writeTypes(Sec, Returns);
+  }
+  writeSection(Bytes, 1, Sec);
+
+  if (!Imports.empty()) {
+    Sec.clear();
+    writeU32(Sec, static_cast<uint32_t>(Imports.size()));
+    for (const auto &[Module, Name, TypeIdx] : Imports) {
+      writeName(Sec, Module);
+      writeName(Sec, Name);
+      Sec.push_back(0x00U);
+      writeU32(Sec, TypeIdx);
+    }
+    writeSection(Bytes, 2, Sec);
+  }
+
+  Sec.clear();
+  writeU32(Sec, static_cast<uint32_t>(FuncTypes.size()));
+  for (const auto TypeIdx : FuncTypes) {
+    writeU32(Sec, TypeIdx);
+  }
+  writeSection(Bytes, 3, Sec);
+
+  if (!TableElems.empty()) {
+    Sec.clear();
+    writeU32(Sec, 1);
+    Sec.push_back(static_cast<Byte>(RefType::FuncRef));
+    Sec.push_back(0x00U);
+    writeU32(Sec, static_cast<uint32_t>(TableElems.size()));
+    writeSection(Bytes, 4, Sec);
+  }
+
+  if (MemoryPages > 0) {
+    Sec.clear();
+    writeU32(Sec, 1);
+    Sec.push_back(0x00U);
+    writeU32(Sec, MemoryPages);
+    writeSection(Bytes, 5, Sec);
+  }
+
+  Sec.clear();
+  writeU32(Sec, static_cast<uint32_t>(Exports.size()));
+  for (const auto &[Name, FuncIdx] : Exports) {
+    writeName(Sec, Name);
+    Sec.push_back(0x00U);
+    writeU32(Sec, FuncIdx);
+  }
+  writeSection(Bytes, 7, Sec);
+
+  if (!TableElems.empty()) {
+    Sec.clear();
+    writeU32(Sec, 1);
+    writeU32(Sec, 0);
+    writeOffset(Sec, 0);
+    writeU32(Sec, static_cast<uint32_t>(TableElems.size()));
+    for (const auto FuncIdx : TableElems) {
+      writeU32(Sec, FuncIdx);
+    }
+    writeSection(Bytes, 9, Sec);
+  }
+
+  Sec.clear();
+  writeU32(Sec, static_cast<uint32_t>(Bodies.size()));
+  for (const auto &Body : Bodies) {
+    writeU32(Sec, static_cast<uint32_t>(Body.size()));
+    Sec.insert(Sec.end(), Body.begin(), Body.end());
+  }
+  writeSection(Bytes, 10, Sec);
+
+  if (!Datas.empty()) {
+    Sec.clear();
+    writeU32(Sec, static_cast<uint32_t>(Datas.size()));
+    for (const auto &[Offset, Data] : Datas) {
+      writeU32(Sec, 0);
+      writeOffset(Sec, Offset);
+      writeU32(Sec, static_cast<uint32_t>(Data.size()));
+      Sec.insert(Sec.end(), Data.begin(), Data.end());
+    }
+    writeSection(Bytes, 11, Sec);
+  }
+  return Bytes;
+}
+
+std::vector<Kernel> getKernels() {
+  std::vector<Kernel> Kernels;
+  Kernels.push_back(matmul());
+  Kernels.push_back(chacha20());
+  Kernels.push_back(crc32());
+  Kernels.push_back(json());
+  Kernels.push_back(callIndirect());
+  return Kernels;
+}
+
+std::vector<Byte> getHostCallModule() {
+  ModuleBuilder Builder;
+  const auto RunType = Builder.addType({ValType::I32}, {ValType::I64});
+  const auto IncType = Builder.addType({ValType::I32}, {ValType::I32});
+  const auto Inc = Builder.addImport("env"sv, "inc"sv, IncType);
+  // Locals: 0 n, 1 i, 2 x.
+  Code Body;
+  Body.forLocal(1, 0, [Inc](Code &I) {
+    I.get(2).op(OpCode::Call).u32(Inc).set(2);
+  });
+  Body.get(2).op(OpCode::I64__extend_i32_u);
+  Builder.addExport(
+      "run"sv, Builder.addFunction(RunType, {ValType::I32, ValType::I32}, Body));
+  return Builder.build();
+}
+
+} // namespace Bench
+} // namespace WasmEdge
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/bench/kernels.h - Benchmark kernels -----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the wasm module builder and the benchmark kernels.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/enum_ast.hpp"
+#include "common/enum_types.hpp"
+#include "common/types.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Bench {
+
+/// Encoder of a function body.
+class Code {
+public:
+  Code &op(OpCode Op);
+  Code &u32(uint32_t Value);
+  Code &i32Const(int32_t Value);
+  Code &i64Const(int64_t Value);
+  Code &get(uint32_t Local) { return op(OpCode::Local__get).u32(Local); }
+  Code &set(uint32_t Local) { return op(OpCode::Local__set).u32(Local); }
+  /// Memory accesses with the natural alignment.
+  Code &load8(uint32_t Offset);
+  Code &load32(uint32_t Offset);
+  Code &store8(uint32_t Offset);
+  Code &store32(uint32_t Offset);
+
+  /// `for (Var = 0; Var < Limit; ++Var) Body`, where the limit is a constant
+  /// or a local.
+  Code &forConst(uint32_t Var, int32_t Limit,
+                 const std::function<void(Code &)> &Body);
+  Code &forLocal(uint32_t Var, uint32_t Limit,
+                 const std::function<void(Code &)> &Body);
+
+  const std::vector<Byte> &bytes() const noexcept { return Bytes; }
+
+private:
+  Code &forLoop(uint32_t Var, const std::function<void(Code &)> &Limit,
+                const std::function<void(Code &)> &Body);
+
+  std::vector<Byte> Bytes;
+};
+
+/// Builder of a wasm module in the binary format.
+class ModuleBuilder {
+public:
+  /// Add a function type and return its index.
+  uint32_t addType(std::vector<ValType> Params, std::vector<ValType> Returns);
+  /// Add an imported function and return its function index. Must be called
+  /// before adding any function.
+  uint32_t addImport(std::string_view Module, std::string_view Name,
+                     uint32_t TypeIdx);
+  /// Add a function with its locals besides the parameters, and return its
+  /// function index. The body is terminated by the builder.
+  uint32_t addFunction(uint32_t TypeIdx, std::vector<ValType> Locals,
+                       const Code &Body);
+  void addExport(std::string_view Name, uint32_t FuncIdx);
+  void setMemory(uint32_t Pages) { MemoryPages = Pages; }
+  /// Set the table and its elements at offset 0.
+  void setTable(std::vector<uint32_t> Elems) { TableElems = std::move(Elems); }
+  void addData(uint32_t Offset, std::vector<Byte> Data);
+
+  std::vector<Byte> build() const;
+
+private:
+  std::vector<std::pair<std::vector<ValType>, std::vector<ValType>>> Types;
+  std::vector<std::tuple<std::string, std::string, uint32_t>> Imports;
+  std::vector<uint32_t> FuncTypes;
+  std::vector<std::vector<Byte>> Bodies;
+  std::vector<std::pair<std::string, uint32_t>> Exports;
+  uint32_t MemoryPages = 0;
+  std::vector<uint32_t> TableElems;
+  std::vector<std::pair<uint32_t, std::vector<Byte>>> Datas;
+};
+
+/// A benchmark kernel. The module exports `run(i32 n) -> i64`, which repeats
+/// the work `n` times and returns a checksum.
+struct Kernel {
+  std::string Name;
+  std::string Description;
+  std::vector<Byte> Wasm;
+  /// Argument of `run` for one iteration of roughly equal cost.
+  uint32_t Iterations;
+};
+
+/// Get the bundled benchmark kernels.
+std::vector<Kernel> getKernels();
+
+/// Module importing `env.inc(i32) -> i32` and exporting `run(i32 n) -> i64`,
+/// which calls the host function `n` times.
+std::vector<Byte> getHostCallModule();
+
+} // namespace Bench
+} // namespace WasmEdge
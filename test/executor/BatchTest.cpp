@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/executor/BatchTest.cpp - Batch execution unit tests -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains unit tests of the executions with a batch of inputs.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/log.h"
+#include "vm/vm.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+namespace {
+
+// (func (export "div") (param i32 i32) (result i32)
+//   (i32.div_u (local.get 0) (local.get 1)))
+std::array<WasmEdge::Byte, 41> Div{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07,
+    0x07, 0x01, 0x03, 0x64, 0x69, 0x76, 0x00, 0x00, 0x0a, 0x09, 0x01,
+    0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6e, 0x0b,
+};
+
+// Three calls, and the second one divides by zero.
+const std::array<WasmEdge::ValVariant, 6> Params{
+    UINT32_C(6), UINT32_C(2), UINT32_C(1), UINT32_C(0), UINT32_C(9),
+    UINT32_C(3)};
+constexpr uint32_t Untouched = UINT32_C(0xDEADBEEF);
+
+void instantiateDiv(WasmEdge::VM::VM &VM) {
+  ASSERT_TRUE(VM.loadWasm(Div));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+}
+
+TEST(BatchTest, ExecuteBatch) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  instantiateDiv(VM);
+  const std::array<WasmEdge::ValVariant, 4> Inputs{
+      UINT32_C(6), UINT32_C(2), UINT32_C(9), UINT32_C(3)};
+  std::array<WasmEdge::ValVariant, 2> Returns{Untouched, Untouched};
+  ASSERT_TRUE(VM.executeBatch("div", 2, Inputs, Returns));
+  EXPECT_EQ(Returns[0].get<uint32_t>(), 3U);
+  EXPECT_EQ(Returns[1].get<uint32_t>(), 3U);
+
+  // The inputs should match the function type, and the outputs hold every
+  // call.
+  EXPECT_EQ(VM.executeBatch("div", 3, Inputs, Returns).error(),
+            WasmEdge::ErrCode::Value::FuncSigMismatch);
+  EXPECT_EQ(VM.executeBatch("div", 3, Params, Returns).error(),
+            WasmEdge::ErrCode::Value::FuncSigMismatch);
+  EXPECT_EQ(VM.executeBatch("mul", 2, Inputs, Returns).error(),
+            WasmEdge::ErrCode::Value::FuncNotFound);
+}
+
+TEST(BatchTest, TrapWithErrors) {
+  // The trap is recorded for its call, and the batch goes on.
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  instantiateDiv(VM);
+  std::array<WasmEdge::ValVariant, 3> Returns{Untouched, Untouched, Untouched};
+  std::array<WasmEdge::ErrCode, 3> Errors;
+  ASSERT_TRUE(VM.executeBatch("div", 3, Params, Returns, Errors));
+  EXPECT_EQ(Returns[0].get<uint32_t>(), 3U);
+  EXPECT_EQ(Returns[1].get<uint32_t>(), Untouched);
+  EXPECT_EQ(Returns[2].get<uint32_t>(), 3U);
+  EXPECT_EQ(Errors[0], WasmEdge::ErrCode::Value::Success);
+  EXPECT_EQ(Errors[1], WasmEdge::ErrCode::Value::DivideByZero);
+  EXPECT_EQ(Errors[2], WasmEdge::ErrCode::Value::Success);
+}
+
+TEST(BatchTest, StopAtFirstTrap) {
+  // Without the error list, the batch stops at the trap and returns it.
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  instantiateDiv(VM);
+  std::array<WasmEdge::ValVariant, 3> Returns{Untouched, Untouched, Untouched};
+  auto Res = VM.executeBatch("div", 3, Params, Returns);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::DivideByZero);
+  EXPECT_EQ(Returns[0].get<uint32_t>(), 3U);
+  EXPECT_EQ(Returns[1].get<uint32_t>(), Untouched);
+  EXPECT_EQ(Returns[2].get<uint32_t>(), Untouched);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
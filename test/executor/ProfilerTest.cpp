@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/executor/ProfilerTest.cpp - Profiler unit tests -----===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains unit tests of the instrumentation of Executor::Profiler.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/log.h"
+#include "common/pgo.h"
+#include "executor/profiler.h"
+#include "vm/vm.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+
+// (func (export "count") (param i32) (result i32) (local i32)
+//   (loop
+//     (if (i32.and (local.get 0) (i32.const 1))
+//       (then (local.set 1 (i32.add (local.get 1) (i32.const 1)))))
+//     (br_if 0 (local.tee 0 (i32.sub (local.get 0) (i32.const 1)))))
+//   (local.get 1))
+std::array<WasmEdge::Byte, 68> CountOdd{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x09, 0x01, 0x05,
+    0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00, 0x00, 0x0a, 0x23, 0x01, 0x21, 0x01,
+    0x01, 0x7f, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01, 0x71, 0x04, 0x40, 0x20,
+    0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x6b,
+    0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b,
+};
+
+/// Count the odd numbers from 1 to \p Times.
+void runCountOdd(WasmEdge::VM::VM &VM, uint32_t Times) {
+  auto Result = VM.execute(
+      "count", std::initializer_list<WasmEdge::ValVariant>{Times},
+      {WasmEdge::ValType::I32});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), (Times + 1) / 2);
+}
+
+/// Split the CSV dump by the kinds of the rows.
+std::map<std::string, std::vector<std::vector<std::string>>>
+parseCSV(const std::string &CSV) {
+  std::map<std::string, std::vector<std::vector<std::string>>> Rows;
+  std::istringstream IS(CSV);
+  std::string Line;
+  std::getline(IS, Line);
+  EXPECT_EQ(Line, "kind,name,offset,count,instructions"sv);
+  while (std::getline(IS, Line)) {
+    std::vector<std::string> Fields;
+    std::istringstream LS(Line);
+    for (std::string Field; std::getline(LS, Field, ',');) {
+      Fields.push_back(Field);
+    }
+    EXPECT_EQ(Fields.size(), 5U);
+    Rows[Fields[0]].push_back(std::move(Fields));
+  }
+  return Rows;
+}
+
+TEST(Profiler, InstrumentationTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof;
+  Prof.setInstrumentation(true);
+  VM.getExecutor().setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(CountOdd));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  runCountOdd(VM, 10);
+
+  // Every executed instruction is counted in one opcode and one block.
+  uint64_t OpCodeTotal = 0;
+  for (uint32_t I = 0; I <= UINT16_MAX; ++I) {
+    OpCodeTotal += Prof.getOpCodeCount(static_cast<WasmEdge::OpCode>(I));
+  }
+  uint64_t BlockTotal = 0;
+  for (const auto &[Key, Count] : Prof.getBlocks()) {
+    EXPECT_EQ(Prof.symbolize(*Key.first), "count"sv);
+    EXPECT_GT(Count.Count, 0U);
+    BlockTotal += Count.Instrs;
+  }
+  EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::Br_if), 10U);
+  EXPECT_EQ(Prof.getOpCodeCount(WasmEdge::OpCode::Local__get), 26U);
+  EXPECT_GT(BlockTotal, 0U);
+  EXPECT_EQ(OpCodeTotal, BlockTotal);
+
+  std::ostringstream JSON;
+  Prof.dumpInstrJSON(JSON);
+  EXPECT_NE(JSON.str().find("\"name\": \"local.get\""), std::string::npos);
+
+  // The rows of every kind are ordered by the most executed first, as in the
+  // JSON dump.
+  std::ostringstream CSV;
+  Prof.dumpInstrCSV(CSV);
+  auto Rows = parseCSV(CSV.str());
+  ASSERT_EQ(Rows["function"].size(), 1U);
+  EXPECT_EQ(Rows["function"][0][1], "count"sv);
+  EXPECT_EQ(std::stoull(Rows["function"][0][4]), BlockTotal);
+  ASSERT_GT(Rows["opcode"].size(), 1U);
+  EXPECT_EQ(Rows["opcode"][0][1], "local.get"sv);
+  for (size_t I = 1; I < Rows["opcode"].size(); ++I) {
+    EXPECT_GE(std::stoull(Rows["opcode"][I - 1][3]),
+              std::stoull(Rows["opcode"][I][3]));
+  }
+  ASSERT_GT(Rows["block"].size(), 1U);
+  for (size_t I = 1; I < Rows["block"].size(); ++I) {
+    EXPECT_GE(std::stoull(Rows["block"][I - 1][4]),
+              std::stoull(Rows["block"][I][4]));
+  }
+}
+
+TEST(Profiler, PGOTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof;
+  Prof.setInstrumentation(true);
+  VM.getExecutor().setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(CountOdd));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  runCountOdd(VM, 10);
+  runCountOdd(VM, 10);
+
+  const auto Profile = Prof.getPGOProfile();
+  ASSERT_EQ(Profile.Modules.size(), 1U);
+  const auto &Mod = Profile.Modules.begin()->second;
+  ASSERT_EQ(Mod.Functions.size(), 1U);
+  const auto &Func = Mod.Functions.begin()->second;
+  EXPECT_EQ(Mod.Functions.begin()->first, 0U);
+  EXPECT_EQ(Func.EntryCount, 2U);
+  // The `if` takes the odd half of the iterations, and the `br_if` loops back
+  // in all of them but the last one.
+  ASSERT_EQ(Func.Branches.size(), 2U);
+  const auto &If = Func.Branches.begin()->second;
+  const auto &BrIf = Func.Branches.rbegin()->second;
+  EXPECT_EQ(If, (std::vector<uint64_t>{10, 10}));
+  EXPECT_EQ(BrIf, (std::vector<uint64_t>{18, 2}));
+
+  std::stringstream SS;
+  Profile.write(SS);
+  WasmEdge::PGO::Profile Read;
+  ASSERT_TRUE(Read.read(SS));
+  ASSERT_EQ(Read.Modules.size(), 1U);
+  EXPECT_EQ(Read.Modules.begin()->first, Profile.Modules.begin()->first);
+  const auto &ReadFunc = Read.Modules.begin()->second.Functions.at(0);
+  EXPECT_EQ(ReadFunc.EntryCount, Func.EntryCount);
+  EXPECT_EQ(ReadFunc.Branches, Func.Branches);
+
+  std::istringstream Malformed("wasmedge-profile 1\nfunction 0 1\n");
+  EXPECT_FALSE(WasmEdge::PGO::Profile().read(Malformed));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/executor/ProxyTest.cpp - Proxy unit tests -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains unit tests of the native host entries of the AOT code.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/log.h"
+#include "runtime/callingframe.h"
+#include "vm/vm.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+namespace {
+
+// (import "wasi_snapshot_preview1" "random_get"
+//   (func (param i32 i32) (result i32)))
+// (memory (export "memory") 1)
+std::array<WasmEdge::Byte, 73> RandomGet{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x25, 0x01, 0x16, 0x77, 0x61, 0x73,
+    0x69, 0x5f, 0x73, 0x6e, 0x61, 0x70, 0x73, 0x68, 0x6f, 0x74, 0x5f, 0x70,
+    0x72, 0x65, 0x76, 0x69, 0x65, 0x77, 0x31, 0x0a, 0x72, 0x61, 0x6e, 0x64,
+    0x6f, 0x6d, 0x5f, 0x67, 0x65, 0x74, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00,
+    0x01, 0x07, 0x0a, 0x01, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02,
+    0x00,
+};
+
+using NativeRandomGet = uint32_t (*)(WasmEdge::Runtime::HostFunctionBase *,
+                                     const WasmEdge::Runtime::CallingFrame &,
+                                     uint32_t, uint32_t);
+
+TEST(Proxy, HostNativeTest) {
+  WasmEdge::Configure Conf;
+  Conf.addHostRegistration(WasmEdge::HostRegistration::Wasi);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RandomGet));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  // The entry of the imported `random_get` is resolved at the instantiation.
+  const auto *Slots = VM.getExecutor().getHostNatives(*VM.getActiveModule());
+  ASSERT_NE(Slots, nullptr);
+  ASSERT_NE(Slots[0].Entry, nullptr);
+  ASSERT_NE(Slots[0].Self, nullptr);
+  const auto &CallFrame =
+      *reinterpret_cast<const WasmEdge::Runtime::CallingFrame *>(
+          Slots[0].Frame);
+  EXPECT_EQ(CallFrame.getModule(), VM.getActiveModule());
+
+  // The entry fills the buffer in the memory of the calling module.
+  auto *MemInst = CallFrame.getMemoryByIndex(0);
+  ASSERT_NE(MemInst, nullptr);
+  const uint32_t Errno = reinterpret_cast<NativeRandomGet>(Slots[0].Entry)(
+      Slots[0].Self, CallFrame, 16, 32);
+  EXPECT_EQ(Errno, 0U);
+  auto Buf = MemInst->getBytes(16, 32);
+  ASSERT_TRUE(Buf);
+  bool AllZero = true;
+  for (const auto B : *Buf) {
+    AllZero = AllZero && B == 0;
+  }
+  EXPECT_FALSE(AllZero);
+}
+
+TEST(Proxy, HostNativeTimeMeasuringTest) {
+  // The timed calls are left to the full path of the host functions.
+  WasmEdge::Configure Conf;
+  Conf.addHostRegistration(WasmEdge::HostRegistration::Wasi);
+  Conf.getStatisticsConfigure().setTimeMeasuring(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RandomGet));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_EQ(VM.getExecutor().getHostNatives(*VM.getActiveModule()), nullptr);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
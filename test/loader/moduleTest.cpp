@@ -13,12 +13,25 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "aot/version.h"
 #include "loader/loader.h"
+#include "loader/shared_library.h"
+#include "system/cpu.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 
+#if WASMEDGE_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 WasmEdge::Configure Conf;
@@ -108,6 +121,44 @@ TEST(ModuleTest, LoadStartSecModule) {
   EXPECT_FALSE(Ldr.parseModule(Vec));
 }
 
+TEST(ModuleTest, LoadFunctionNames) {
+  // The function names subsection is parsed, and the other subsections and
+  // custom sections are skipped.
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+      0x01U, 0x00U, 0x00U, 0x00U, // Version
+      0x00U, 0x03U, 0x01U, 0x61U, // Custom section "a"
+      0x00U,                      // Content
+      0x00U, 0x13U, 0x04U, 0x6EU, // Custom section "name"
+      0x61U, 0x6DU, 0x65U,        //
+      0x00U, 0x02U, 0x01U, 0x6DU, // Module name "m"
+      0x01U, 0x08U, 0x02U,        // Function names, 2 entries
+      0x00U, 0x01U, 0x66U,        // 0: "f"
+      0x03U, 0x02U, 0x67U, 0x68U  // 3: "gh"
+  };
+  auto Mod = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  const auto &Names = (*Mod)->getFunctionNames();
+  EXPECT_EQ(Names.size(), 2U);
+  EXPECT_EQ(Names.at(0), "f");
+  EXPECT_EQ(Names.at(3), "gh");
+
+  // The malformed names are dropped from the malformed one on.
+  Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+      0x01U, 0x00U, 0x00U, 0x00U, // Version
+      0x00U, 0x0DU, 0x04U, 0x6EU, // Custom section "name"
+      0x61U, 0x6DU, 0x65U,        //
+      0x01U, 0x06U, 0x02U,        // Function names, 2 entries
+      0x00U, 0x01U, 0x66U,        // 0: "f"
+      0x03U, 0x05U                // 3: name out of bounds
+  };
+  Mod = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  EXPECT_EQ((*Mod)->getFunctionNames().size(), 1U);
+  EXPECT_EQ((*Mod)->getFunctionNames().at(0), "f");
+}
+
 TEST(ModuleTest, LoadDupSecModule) {
   std::vector<uint8_t> Vec;
 
@@ -220,6 +271,133 @@ TEST(ModuleTest, LoadDupSecModule) {
   EXPECT_FALSE(Ldr.parseModule(Vec));
 }
 
+#if WASMEDGE_OS_LINUX && (defined(__x86_64__) || defined(__aarch64__))
+TEST(ModuleTest, SelectAOTSection) {
+  // Custom section of AOT code requiring the target features.
+  auto AOTSection = [](std::vector<std::string> Features) {
+    std::vector<WasmEdge::Byte> Content = {
+        0x08U, 'w', 'a', 's', 'm', 'e', 'd', 'g', 'e',
+        static_cast<WasmEdge::Byte>(WasmEdge::AOT::kBinaryVersion),
+        // Linux
+        0x01U,
+#if defined(__x86_64__)
+        0x01U,
+#else
+        0x02U,
+#endif
+        static_cast<WasmEdge::Byte>(Features.size())};
+    for (const auto &Feature : Features) {
+      Content.push_back(static_cast<WasmEdge::Byte>(Feature.size()));
+      Content.insert(Content.end(), Feature.begin(), Feature.end());
+    }
+    // No linked modules, no types and codes, and a text section of a `ret`
+    // instruction.
+    Content.insert(Content.end(),
+                   {0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x01U, 0x01U, 0x00U,
+                    0x01U, 0x00U, 0x01U, 0xC3U});
+    std::vector<WasmEdge::Byte> Sec = {
+        0x00U, static_cast<WasmEdge::Byte>(Content.size())};
+    Sec.insert(Sec.end(), Content.begin(), Content.end());
+    return Sec;
+  };
+
+  // The section for the unsupported feature is skipped, and the section
+  // requiring the most supported features is selected.
+  std::vector<WasmEdge::Byte> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+      0x01U, 0x00U, 0x00U, 0x00U  // Version
+  };
+  const std::string Supported =
+#if defined(__x86_64__)
+      "sse2";
+#else
+      "neon";
+#endif
+  ASSERT_TRUE(WasmEdge::CPU::isKnownFeature(Supported));
+  ASSERT_TRUE(WasmEdge::CPU::hasFeature(Supported));
+  ASSERT_FALSE(WasmEdge::CPU::hasFeature("no-such-feature"));
+  for (const auto &Features : std::vector<std::vector<std::string>>{
+           {}, {Supported}, {Supported, "no-such-feature"}, {}}) {
+    const auto Sec = AOTSection(Features);
+    Vec.insert(Vec.end(), Sec.begin(), Sec.end());
+  }
+  auto Mod = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  EXPECT_EQ((*Mod)->getAOTSection().getFeatures(),
+            std::vector<std::string>{Supported});
+}
+#endif
+
+#if WASMEDGE_OS_LINUX
+TEST(ModuleTest, WritePerfMap) {
+  // Two 1-byte codes and a 2-byte code in a text section of 4 bytes.
+  WasmEdge::AST::AOTSection AOTSec;
+  AOTSec.getCodesAddress() = {0, 1, 2};
+  AOTSec.getSections().emplace_back(
+      1, 0, 4, std::vector<WasmEdge::Byte>{0xC3U, 0xC3U, 0xC3U, 0xC3U});
+  auto Library = std::make_shared<WasmEdge::Loader::SharedLibrary>();
+  ASSERT_TRUE(Library->load(AOTSec));
+
+  const auto Path = "/tmp/perf-" + std::to_string(::getpid()) + ".map";
+  std::remove(Path.c_str());
+  Library->writePerfMap(std::vector<std::string>{
+      "wasm-function[1]:a", "wasm-function[2]", "wasm-function[3]:c"});
+
+  std::ifstream IS(Path);
+  ASSERT_TRUE(IS);
+  std::ostringstream Expected;
+  const auto Base = Library->getOffset();
+  Expected << std::hex << Base << " 1 wasm-function[1]:a\n"
+           << Base + 1 << " 1 wasm-function[2]\n"
+           << Base + 2 << " 2 wasm-function[3]:c\n";
+  std::ostringstream Content;
+  Content << IS.rdbuf();
+  EXPECT_EQ(Content.str(), Expected.str());
+  std::remove(Path.c_str());
+}
+
+TEST(ModuleTest, MapAOTText) {
+  // A text section at a page-aligned offset of the file is mapped from the
+  // file, and the one at a misaligned offset is copied.
+  const auto Path = "/tmp/wasmedge-map-" + std::to_string(::getpid());
+  {
+    std::ofstream OS(Path, std::ios::binary);
+    OS << std::string(8192, '\0') << std::string(4, '\xC3');
+  }
+  auto MappedPath = [](uintptr_t Address) {
+    std::ifstream IS("/proc/self/maps");
+    std::ostringstream Prefix;
+    Prefix << std::hex << Address << '-';
+    for (std::string Line; std::getline(IS, Line);) {
+      if (Line.rfind(Prefix.str(), 0) == 0) {
+        const auto Pos = Line.find('/');
+        return Pos == std::string::npos ? std::string() : Line.substr(Pos);
+      }
+    }
+    return std::string();
+  };
+
+  for (const uint64_t ContentOffset : {UINT64_C(8192), UINT64_C(8193)}) {
+    WasmEdge::AST::AOTSection AOTSec;
+    AOTSec.getSections().emplace_back(
+        1, 0, 4, std::vector<WasmEdge::Byte>{0xC3U, 0xC3U, 0xC3U, 0xC3U});
+    AOTSec.getContentOffsets() = {ContentOffset};
+    const int File = ::open(Path.c_str(), O_RDONLY);
+    ASSERT_GE(File, 0);
+    auto Library = std::make_shared<WasmEdge::Loader::SharedLibrary>();
+    ASSERT_TRUE(Library->load(AOTSec, File));
+    // The mapping keeps the file referenced.
+    ::close(File);
+    EXPECT_EQ(MappedPath(Library->getOffset()),
+              ContentOffset == 8192 ? Path : std::string());
+    for (uint64_t I = 0; I < 4; ++I) {
+      EXPECT_EQ(*Library->getPointer<const uint8_t>(I), 0xC3U);
+    }
+  }
+  std::remove(Path.c_str());
+}
+#endif
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
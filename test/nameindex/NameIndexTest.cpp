@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/nameindex/NameIndexTest.cpp - Name index unit tests -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the hashed name index.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/name_index.h"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+
+TEST(NameIndexTest, InsertFind) {
+  WasmEdge::NameIndex<int> Index;
+  std::array<int, 3> Values{};
+  EXPECT_EQ(Index.find("a"sv, WasmEdge::hashName("a"sv)), nullptr);
+  Index.erase("a"sv, WasmEdge::hashName("a"sv));
+  EXPECT_EQ(Index.size(), 0U);
+
+  Index.insert("a"sv, WasmEdge::hashName("a"sv), &Values[0]);
+  Index.insert("b"sv, WasmEdge::hashName("b"sv), &Values[1]);
+  EXPECT_EQ(Index.size(), 2U);
+  EXPECT_EQ(Index.find("a"sv, WasmEdge::hashName("a"sv)), &Values[0]);
+  EXPECT_EQ(Index.find("b"sv, WasmEdge::hashName("b"sv)), &Values[1]);
+  EXPECT_EQ(Index.find("c"sv, WasmEdge::hashName("c"sv)), nullptr);
+
+  // Inserting a name again assigns the pointer.
+  Index.insert("a"sv, WasmEdge::hashName("a"sv), &Values[2]);
+  EXPECT_EQ(Index.size(), 2U);
+  EXPECT_EQ(Index.find("a"sv, WasmEdge::hashName("a"sv)), &Values[2]);
+
+  // Names of the same hash are told apart.
+  Index.insert("c"sv, WasmEdge::hashName("a"sv), &Values[1]);
+  EXPECT_EQ(Index.find("c"sv, WasmEdge::hashName("a"sv)), &Values[1]);
+  EXPECT_EQ(Index.find("a"sv, WasmEdge::hashName("a"sv)), &Values[2]);
+
+  Index.clear();
+  EXPECT_EQ(Index.size(), 0U);
+  EXPECT_EQ(Index.find("a"sv, WasmEdge::hashName("a"sv)), nullptr);
+}
+
+TEST(NameIndexTest, EraseWrappedCluster) {
+  // The first insertion makes 16 slots, which hold up to 7 names. The hashes
+  // are chosen for their home slots, so the cluster runs over the table end:
+  // A, B and D at home 14 take 14, 15 and 1, C at home 15 takes 0, and E at
+  // home 0 takes 2.
+  struct Entry {
+    std::string_view Name;
+    uint64_t Hash;
+  };
+  const std::array<Entry, 5> Entries{{{"A"sv, 14U + 16U},
+                                      {"B"sv, 14U + 32U},
+                                      {"C"sv, 15U},
+                                      {"D"sv, 14U},
+                                      {"E"sv, 16U}}};
+  std::array<int, 5> Values{};
+  auto Fill = [&](WasmEdge::NameIndex<int> &Index) {
+    Index.clear();
+    for (size_t I = 0; I < Entries.size(); ++I) {
+      Index.insert(Entries[I].Name, Entries[I].Hash, &Values[I]);
+    }
+    ASSERT_EQ(Index.size(), Entries.size());
+  };
+
+  // Erase each name from the full cluster, and the others are still found
+  // after the entries shifted back over the table end.
+  for (size_t Erased = 0; Erased < Entries.size(); ++Erased) {
+    WasmEdge::NameIndex<int> Index;
+    Fill(Index);
+    Index.erase(Entries[Erased].Name, Entries[Erased].Hash);
+    EXPECT_EQ(Index.size(), Entries.size() - 1);
+    for (size_t I = 0; I < Entries.size(); ++I) {
+      EXPECT_EQ(Index.find(Entries[I].Name, Entries[I].Hash),
+                I == Erased ? nullptr : &Values[I])
+          << "erased " << Entries[Erased].Name << ", found "
+          << Entries[I].Name;
+    }
+  }
+
+  // Erase all of them one by one, and a missing name is a no-op.
+  WasmEdge::NameIndex<int> Index;
+  Fill(Index);
+  Index.erase("F"sv, 14U);
+  EXPECT_EQ(Index.size(), Entries.size());
+  for (size_t Erased = 0; Erased < Entries.size(); ++Erased) {
+    Index.erase(Entries[Erased].Name, Entries[Erased].Hash);
+    for (size_t I = Erased + 1; I < Entries.size(); ++I) {
+      EXPECT_EQ(Index.find(Entries[I].Name, Entries[I].Hash), &Values[I]);
+    }
+  }
+  EXPECT_EQ(Index.size(), 0U);
+}
+
+TEST(NameIndexTest, Rehash) {
+  // The names outlive the index.
+  std::vector<std::string> Names;
+  for (uint32_t I = 0; I < 1000; ++I) {
+    Names.push_back("name" + std::to_string(I));
+  }
+  std::vector<int> Values(Names.size());
+  WasmEdge::NameIndex<int> Index;
+  for (size_t I = 0; I < Names.size(); ++I) {
+    Index.insert(Names[I], WasmEdge::hashName(Names[I]), &Values[I]);
+    ASSERT_EQ(Index.size(), I + 1);
+  }
+  for (size_t I = 0; I < Names.size(); ++I) {
+    EXPECT_EQ(Index.find(Names[I], WasmEdge::hashName(Names[I])), &Values[I]);
+  }
+
+  // The entries of a grown table still erase and shift back.
+  for (size_t I = 0; I < Names.size(); I += 2) {
+    Index.erase(Names[I], WasmEdge::hashName(Names[I]));
+  }
+  EXPECT_EQ(Index.size(), Names.size() / 2);
+  for (size_t I = 0; I < Names.size(); ++I) {
+    EXPECT_EQ(Index.find(Names[I], WasmEdge::hashName(Names[I])),
+              I % 2 == 0 ? nullptr : &Values[I]);
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
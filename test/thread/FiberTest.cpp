@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/thread/FiberTest.cpp - Fiber execution tests --------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains tests of suspending executions on pending host functions
+/// and multiplexing them with the fiber loop.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/defines.h"
+#include "runtime/instance/module.h"
+#include "system/fiber.h"
+#include "vm/fiberloop.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if WASMEDGE_OS_LINUX
+#include <poll.h>
+#include <unistd.h>
+
+namespace {
+
+// Module importing `host.recv(fd: i32) -> i32` and exporting
+//   run(fd: i32) -> i32   ; recv(fd) + recv(fd)
+std::array<WasmEdge::Byte, 59> RecvWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0d, 0x01, 0x04, 0x68, 0x6f, 0x73, 0x74,
+    0x04, 0x72, 0x65, 0x63, 0x76, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07,
+    0x07, 0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x0d, 0x01, 0x0b,
+    0x00, 0x20, 0x00, 0x10, 0x00, 0x20, 0x00, 0x10, 0x00, 0x6a, 0x0b};
+
+const std::vector<WasmEdge::ValType> Types{WasmEdge::ValType::I32};
+
+/// Read one byte from a pipe, or suspend until the pipe is readable.
+class HostRecv : public WasmEdge::Runtime::HostFunction<HostRecv> {
+public:
+  HostRecv(uint32_t &Suspends) : Suspends(Suspends) {}
+  WasmEdge::Expect<uint32_t> body(const WasmEdge::Runtime::CallingFrame &,
+                                  uint32_t Fd) {
+    const int NativeFd = static_cast<int>(Fd);
+    struct pollfd PollFd = {NativeFd, POLLIN, 0};
+    if (::poll(&PollFd, 1, 0) == 0) {
+      WasmEdge::Fiber::WaitCondition Cond;
+      Cond.Fd = NativeFd;
+      WasmEdge::Fiber::setWaitCondition(Cond);
+      ++Suspends;
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::HostFuncPending);
+    }
+    uint8_t Byte = 0;
+    if (::read(NativeFd, &Byte, 1) != 1) {
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::HostFuncError);
+    }
+    return Byte;
+  }
+
+private:
+  uint32_t &Suspends;
+};
+
+class HostModule : public WasmEdge::Runtime::Instance::ModuleInstance {
+public:
+  HostModule(uint32_t &Suspends) : ModuleInstance("host") {
+    addHostFunc("recv", std::make_unique<HostRecv>(Suspends));
+  }
+  ~HostModule() noexcept override = default;
+};
+
+/// One guest instance reading from its own pipe.
+struct Instance {
+  Instance() : Host(Suspends), VM(WasmEdge::Configure()) {
+    EXPECT_EQ(::pipe(Pipe.data()), 0);
+    EXPECT_TRUE(VM.registerModule(Host));
+    EXPECT_TRUE(VM.loadWasm(RecvWasm));
+    EXPECT_TRUE(VM.validate());
+    EXPECT_TRUE(VM.instantiate());
+  }
+  ~Instance() noexcept {
+    ::close(Pipe[0]);
+    ::close(Pipe[1]);
+  }
+  std::vector<WasmEdge::ValVariant> args() const {
+    return {static_cast<uint32_t>(Pipe[0])};
+  }
+  void send(uint8_t Byte) { EXPECT_EQ(::write(Pipe[1], &Byte, 1), 1); }
+
+  uint32_t Suspends = 0;
+  HostModule Host;
+  WasmEdge::VM::VM VM;
+  std::array<int, 2> Pipe;
+};
+
+TEST(FiberLoop, ManyInstancesOneThread) {
+  constexpr size_t Count = 100;
+  std::vector<std::unique_ptr<Instance>> Instances;
+  std::vector<std::future<WasmEdge::Expect<
+      std::vector<std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>>>
+      Results;
+  WasmEdge::VM::FiberLoop Loop(256 * 1024);
+  for (size_t I = 0; I < Count; ++I) {
+    auto &Inst = *Instances.emplace_back(std::make_unique<Instance>());
+    Results.push_back(Loop.spawnExecute(Inst.VM, "run", Inst.args(), Types));
+  }
+  // The writer runs after every reader has suspended on its empty pipe.
+  Loop.spawn([&Instances]() {
+    for (auto &Inst : Instances) {
+      Inst->send(1);
+    }
+    WasmEdge::Fiber::yield();
+    for (size_t I = 0; I < Instances.size(); ++I) {
+      Instances[I]->send(static_cast<uint8_t>(I));
+    }
+  });
+  EXPECT_EQ(Loop.size(), Count + 1);
+  Loop.run();
+  EXPECT_EQ(Loop.size(), 0U);
+
+  for (size_t I = 0; I < Count; ++I) {
+    auto Res = Results[I].get();
+    ASSERT_TRUE(Res);
+    ASSERT_EQ(Res->size(), 1U);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), I + 1);
+    EXPECT_GE(Instances[I]->Suspends, 1U);
+  }
+}
+
+TEST(FiberLoop, PendingWithoutFiber) {
+  Instance Inst;
+  EXPECT_EQ(WasmEdge::Fiber::current(), nullptr);
+  auto Res = Inst.VM.execute("run", Inst.args(), Types);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::HostFuncPending);
+}
+
+TEST(FiberLoop, StopWhileSuspended) {
+  Instance Inst;
+  WasmEdge::VM::FiberLoop Loop;
+  auto Result = Loop.spawnExecute(Inst.VM, "run", Inst.args(), Types);
+  Loop.spawn([&Inst]() {
+    Inst.VM.stop();
+    Inst.send(1);
+  });
+  Loop.run();
+  auto Res = Result.get();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+}
+
+} // namespace
+#endif
@@ -13,6 +13,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/log.h"
+#include "common/metrics.h"
+#include "vm/threadpool.h"
 #include "vm/vm.h"
 
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
@@ -21,9 +23,13 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -223,6 +229,282 @@ TEST(AsyncExecute, GasThreadTest) {
   }
 }
 
+TEST(AsyncExecute, ThreadPoolTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setAsyncThreadPoolSize(2);
+  Conf.getRuntimeConfigure().setAsyncQueueLimit(1);
+  Conf.getRuntimeConfigure().setAsyncThreadAffinity(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_NE(VM.getAsyncThreadPool(), nullptr);
+  EXPECT_EQ(VM.getAsyncThreadPool()->size(), 2U);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  for (uint32_t Round = 0; Round < 2; ++Round) {
+    std::array<WasmEdge::VM::Async<WasmEdge::Expect<std::vector<
+                   std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>>,
+               4>
+        AsyncResults;
+    for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+      AsyncResults[Index] = VM.asyncExecute(
+          "mt19937",
+          std::initializer_list<WasmEdge::ValVariant>{
+              UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000) + Index},
+          {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+           WasmEdge::ValType::I64});
+    }
+    for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+      auto Result = AsyncResults[Index].get();
+      ASSERT_TRUE(Result);
+      ASSERT_EQ((*Result)[0].second, WasmEdge::ValType::I64);
+      EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[Index]);
+    }
+  }
+}
+
+TEST(AsyncExecute, ThreadPoolWorkerSubmit) {
+  // The only worker fills the queue and can not wait for room, since no one
+  // else would drain it.
+  WasmEdge::VM::ThreadPool Pool(1, 1, false);
+  std::atomic<uint32_t> Done = 0;
+  std::promise<std::pair<bool, bool>> Submitted;
+  auto Inner = [&]() { ++Done; };
+  ASSERT_TRUE(Pool.submit(std::packaged_task<void()>([&]() {
+    const bool First = Pool.submit(std::packaged_task<void()>(Inner));
+    const bool Second = Pool.submit(std::packaged_task<void()>(Inner));
+    Submitted.set_value({First, Second});
+  })));
+  const auto [First, Second] = Submitted.get_future().get();
+  EXPECT_TRUE(First);
+  EXPECT_FALSE(Second);
+  // The queued task still runs.
+  ASSERT_TRUE(Pool.submit(std::packaged_task<void()>(Inner)));
+  while (Done.load() < 2) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(Done.load(), 2U);
+}
+
+TEST(Statistics, TimerThreadTest) {
+  using namespace std::literals;
+  WasmEdge::Timer::Timer Timer;
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Threads.emplace_back([&Timer]() {
+      for (uint32_t J = 0; J < 1000; ++J) {
+        Timer.startRecord(WasmEdge::Timer::TimerTag::HostFunc);
+        Timer.stopRecord(WasmEdge::Timer::TimerTag::HostFunc);
+      }
+      Timer.startRecord(WasmEdge::Timer::TimerTag::Wasm);
+      std::this_thread::sleep_for(10ms);
+      Timer.stopRecord(WasmEdge::Timer::TimerTag::Wasm);
+      // A stop without a start records nothing.
+      Timer.stopRecord(WasmEdge::Timer::TimerTag::Wasm);
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_GE(Timer.getRecord(WasmEdge::Timer::TimerTag::Wasm), 40ms);
+  EXPECT_GT(Timer.getRecord(WasmEdge::Timer::TimerTag::HostFunc), 0ns);
+  Timer.clearRecord(WasmEdge::Timer::TimerTag::Wasm);
+  EXPECT_EQ(Timer.getRecord(WasmEdge::Timer::TimerTag::Wasm), 0ns);
+  EXPECT_GT(Timer.getRecord(WasmEdge::Timer::TimerTag::HostFunc), 0ns);
+  Timer.reset();
+  EXPECT_EQ(Timer.getRecord(WasmEdge::Timer::TimerTag::HostFunc), 0ns);
+
+  // The slots of the exited threads are retired, and a thread outliving a
+  // timer does not touch it on exit.
+  std::thread([&Timer]() {
+    Timer.startRecord(WasmEdge::Timer::TimerTag::Wasm);
+    std::this_thread::sleep_for(10ms);
+    Timer.stopRecord(WasmEdge::Timer::TimerTag::Wasm);
+    auto Local = std::make_unique<WasmEdge::Timer::Timer>();
+    Local->startRecord(WasmEdge::Timer::TimerTag::Wasm);
+    Local->stopRecord(WasmEdge::Timer::TimerTag::Wasm);
+    Local.reset();
+  }).join();
+  EXPECT_GE(Timer.getRecord(WasmEdge::Timer::TimerTag::Wasm), 10ms);
+}
+
+TEST(Profiler, ThreadTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof(std::chrono::microseconds(100));
+  VM.getExecutor().setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  Prof.start();
+  for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+    auto Result = VM.execute(
+        "mt19937",
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000) + Index},
+        {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+         WasmEdge::ValType::I64});
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[Index]);
+  }
+  Prof.stop();
+
+  ASSERT_GT(Prof.getSampleCount(), 0U);
+  uint64_t Total = 0;
+  for (const auto &[Stack, Count] : Prof.getSamples()) {
+    ASSERT_FALSE(Stack.empty());
+    EXPECT_EQ(Prof.symbolize(*Stack.front()), "mt19937"sv);
+    Total += Count;
+  }
+  EXPECT_EQ(Total, Prof.getSampleCount());
+  std::ostringstream OS;
+  Prof.dumpFolded(OS);
+  EXPECT_EQ(OS.str().rfind("mt19937", 0), 0U);
+}
+
+TEST(Profiler, InstrumentationThreadTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  WasmEdge::Executor::Profiler Prof;
+  Prof.setInstrumentation(true);
+  VM.getExecutor().setProfiler(&Prof);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  // Every run keeps its generator state at its own address.
+  auto Run = [&VM](uint32_t Index) {
+    auto Result = VM.execute(
+        "mt19937",
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(2504) * Index, UINT64_C(5489), UINT64_C(100000)},
+        {WasmEdge::ValType::I32, WasmEdge::ValType::I64,
+         WasmEdge::ValType::I64});
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[0]);
+  };
+
+  // The counters of every thread are merged when read.
+  Run(0);
+  const auto Blocks = Prof.getBlocks();
+  const auto Profile = Prof.getPGOProfile();
+  ASSERT_FALSE(Blocks.empty());
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 1; I <= 4; ++I) {
+    Threads.emplace_back(Run, I);
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  const auto AllBlocks = Prof.getBlocks();
+  ASSERT_EQ(AllBlocks.size(), Blocks.size());
+  for (const auto &[Key, Count] : Blocks) {
+    EXPECT_EQ(AllBlocks.at(Key).Count, Count.Count * 5);
+    EXPECT_EQ(AllBlocks.at(Key).Instrs, Count.Instrs * 5);
+  }
+  const auto AllProfile = Prof.getPGOProfile();
+  ASSERT_EQ(AllProfile.Modules.size(), 1U);
+  const auto &Funcs = Profile.Modules.begin()->second.Functions;
+  const auto &AllFuncs = AllProfile.Modules.begin()->second.Functions;
+  ASSERT_EQ(AllFuncs.size(), Funcs.size());
+  for (const auto &[Index, Func] : Funcs) {
+    EXPECT_EQ(AllFuncs.at(Index).EntryCount, Func.EntryCount * 5);
+    for (const auto &[Offset, Counts] : Func.Branches) {
+      const auto &AllCounts = AllFuncs.at(Index).Branches.at(Offset);
+      ASSERT_EQ(AllCounts.size(), Counts.size());
+      for (size_t I = 0; I < Counts.size(); ++I) {
+        EXPECT_EQ(AllCounts[I], Counts[I] * 5);
+      }
+    }
+  }
+}
+
+TEST(Metrics, ThreadTest) {
+  using namespace std::literals;
+  auto &Registry = WasmEdge::Metrics::Registry::global();
+  auto &Counter = Registry.counter("test_counter_total"sv, "Test counter."sv);
+  auto &Latency = Registry.histogram(
+      "test_duration_seconds"sv, "Test histogram."sv,
+      WasmEdge::Metrics::label("name"sv, "a\"b"sv));
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Threads.emplace_back([&Counter, &Latency]() {
+      for (uint32_t J = 0; J < 1000; ++J) {
+        Counter.add();
+        Latency.observe(2ms);
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Counter.get(), 4000U);
+  EXPECT_EQ(Latency.getCount(), 4000U);
+  EXPECT_EQ(Latency.getSum(), 8s);
+  // 2ms falls into the bucket up to 10ms.
+  EXPECT_EQ(Latency.getBucket(4), 4000U);
+  EXPECT_EQ(&Registry.counter("test_counter_total"sv, {}), &Counter);
+
+  const auto &Runtime = WasmEdge::Metrics::runtime();
+  const auto Created = Runtime.InstancesCreated.get();
+  const auto Instantiated = Runtime.InstantiationLatency.getCount();
+  const auto Pages = Runtime.MemoryPages.get();
+  {
+    WasmEdge::Configure Conf;
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    EXPECT_GT(Runtime.InstancesCreated.get(), Created);
+    EXPECT_GT(Runtime.InstantiationLatency.getCount(), Instantiated);
+    EXPECT_GT(Runtime.MemoryPages.get(), Pages);
+  }
+  EXPECT_EQ(Runtime.MemoryPages.get(), Pages);
+
+  std::ostringstream OS;
+  Registry.dumpPrometheus(OS);
+  const auto Text = OS.str();
+  EXPECT_NE(Text.find("# TYPE test_counter_total counter\n"
+                      "test_counter_total 4000\n"),
+            std::string::npos);
+  EXPECT_NE(Text.find("test_duration_seconds_bucket{name=\"a\\\"b\","
+                      "le=\"0.01\"} 4000\n"),
+            std::string::npos);
+  EXPECT_NE(Text.find("test_duration_seconds_sum{name=\"a\\\"b\"} 8\n"),
+            std::string::npos);
+  EXPECT_NE(Text.find("wasmedge_instances_created_total "), std::string::npos);
+}
+
+TEST(StoreManager, ThreadTest) {
+  using namespace std::literals;
+  WasmEdge::Configure Conf;
+  WasmEdge::Executor::Executor Executor(Conf);
+  WasmEdge::Runtime::StoreManager Store;
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env"sv);
+  ASSERT_TRUE(Executor.registerModule(Store, Env));
+
+  std::atomic_bool Done = false;
+  std::vector<std::thread> Readers;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Readers.emplace_back([&Store, &Env, &Done]() {
+      while (!Done.load(std::memory_order_relaxed)) {
+        EXPECT_EQ(Store.findModule("env"sv), &Env);
+        EXPECT_NE(Store.findModule("tmp"sv), &Env);
+      }
+    });
+  }
+  for (uint32_t I = 0; I < 1000; ++I) {
+    // Unregistered when destroyed.
+    WasmEdge::Runtime::Instance::ModuleInstance Tmp("tmp"sv);
+    ASSERT_TRUE(Executor.registerModule(Store, Tmp));
+    EXPECT_EQ(Store.getModuleListSize(), 2U);
+  }
+  Done.store(true, std::memory_order_relaxed);
+  for (auto &Reader : Readers) {
+    Reader.join();
+  }
+  EXPECT_EQ(Store.getModuleListSize(), 1U);
+  EXPECT_EQ(Store.findModule("tmp"sv), nullptr);
+}
+
 #ifdef WASMEDGE_BUILD_AOT_RUNTIME
 
 TEST(AOTAsyncExecute, ThreadTest) {
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/thread/WaitNotifyTest.cpp - Wait/notify tests -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains tests and a contention benchmark for the
+/// memory.atomic.wait and memory.atomic.notify instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Shared memory module with the exports:
+//   notify(addr: i32, count: i32) -> i32   ; memory.atomic.notify
+//   wait(addr: i32, expected: i32, timeout: i64) -> i32
+//                                           ; memory.atomic.wait32
+//   contend(iterations: i32)               ; lock a futex-style mutex at
+//                                           ; address 0, increment the i32 at
+//                                           ; address 4, unlock, repeat.
+//   counter() -> i32                        ; load the i32 at address 4
+std::array<WasmEdge::Byte, 230> WaitNotifyWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x16, 0x04, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x03, 0x7f, 0x7f, 0x7e, 0x01, 0x7f,
+    0x60, 0x01, 0x7f, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00,
+    0x01, 0x02, 0x03, 0x05, 0x04, 0x01, 0x03, 0x01, 0x01, 0x07, 0x25, 0x04,
+    0x06, 0x6e, 0x6f, 0x74, 0x69, 0x66, 0x79, 0x00, 0x00, 0x04, 0x77, 0x61,
+    0x69, 0x74, 0x00, 0x01, 0x07, 0x63, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x64,
+    0x00, 0x02, 0x07, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x65, 0x72, 0x00, 0x03,
+    0x0a, 0x8f, 0x01, 0x04, 0x0a, 0x00, 0x20, 0x00, 0x20, 0x01, 0xfe, 0x00,
+    0x02, 0x00, 0x0b, 0x0c, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfe,
+    0x01, 0x02, 0x00, 0x0b, 0x6d, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00,
+    0x45, 0x0d, 0x01, 0x02, 0x40, 0x41, 0x00, 0x41, 0x00, 0x41, 0x01, 0xfe,
+    0x48, 0x02, 0x00, 0x45, 0x0d, 0x00, 0x03, 0x40, 0x41, 0x00, 0x41, 0x02,
+    0xfe, 0x41, 0x02, 0x00, 0x45, 0x0d, 0x01, 0x41, 0x00, 0x41, 0x02, 0x42,
+    0x7f, 0xfe, 0x01, 0x02, 0x00, 0x1a, 0x0c, 0x00, 0x0b, 0x0b, 0x41, 0x04,
+    0x41, 0x04, 0x28, 0x02, 0x00, 0x41, 0x01, 0x6a, 0x36, 0x02, 0x00, 0x41,
+    0x00, 0x41, 0x01, 0xfe, 0x25, 0x02, 0x00, 0x41, 0x01, 0x47, 0x04, 0x40,
+    0x41, 0x00, 0x41, 0x00, 0xfe, 0x17, 0x02, 0x00, 0x41, 0x00, 0x41, 0x01,
+    0xfe, 0x00, 0x02, 0x00, 0x1a, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x21,
+    0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x0b, 0x07, 0x00, 0x41, 0x04, 0x28, 0x02,
+    0x00, 0x0b,
+};
+
+using namespace std::literals;
+
+using ResultT = WasmEdge::Expect<
+    std::vector<std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>;
+
+WasmEdge::Configure createConfigure() {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Threads);
+  return Conf;
+}
+
+uint32_t notify(WasmEdge::VM::VM &VM, uint32_t Address, uint32_t Count) {
+  auto Res = VM.execute("notify",
+                        std::initializer_list<WasmEdge::ValVariant>{
+                            Address, Count},
+                        {WasmEdge::ValType::I32, WasmEdge::ValType::I32});
+  EXPECT_TRUE(Res);
+  return Res ? (*Res)[0].first.get<uint32_t>() : UINT32_C(0);
+}
+
+uint32_t wait(WasmEdge::VM::VM &VM, uint32_t Address, uint32_t Expected,
+              int64_t Timeout) {
+  auto Res = VM.execute(
+      "wait",
+      std::initializer_list<WasmEdge::ValVariant>{Address, Expected, Timeout},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I32,
+       WasmEdge::ValType::I64});
+  EXPECT_TRUE(Res);
+  return Res ? (*Res)[0].first.get<uint32_t>() : UINT32_C(0);
+}
+
+TEST(WaitNotify, NotEqualAndTimeout) {
+  WasmEdge::VM::VM VM(createConfigure());
+  ASSERT_TRUE(VM.loadWasm(WaitNotifyWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_EQ(wait(VM, 8, 1, -1), 1U);
+  EXPECT_EQ(wait(VM, 8, 0, 0), 2U);
+  EXPECT_EQ(wait(VM, 8, 0, 1000000), 2U);
+  EXPECT_EQ(notify(VM, 8, 1), 0U);
+}
+
+TEST(WaitNotify, ExactNotifyCount) {
+  constexpr uint32_t WaiterCount = 8;
+  WasmEdge::VM::VM VM(createConfigure());
+  ASSERT_TRUE(VM.loadWasm(WaitNotifyWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  std::vector<WasmEdge::VM::Async<ResultT>> Waiters;
+  for (uint32_t I = 0; I < WaiterCount; ++I) {
+    Waiters.push_back(VM.asyncExecute(
+        "wait",
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(8), UINT32_C(0),
+                                                    INT64_C(-1)},
+        {WasmEdge::ValType::I32, WasmEdge::ValType::I32,
+         WasmEdge::ValType::I64}));
+  }
+  // Waiters on other addresses must never be counted.
+  EXPECT_EQ(notify(VM, 12, WaiterCount), 0U);
+
+  uint32_t Woken = 0;
+  const auto Deadline = std::chrono::steady_clock::now() + 30s;
+  while (Woken < WaiterCount && std::chrono::steady_clock::now() < Deadline) {
+    const uint32_t Res = notify(VM, 8, 3);
+    EXPECT_LE(Res, 3U);
+    Woken += Res;
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(Woken, WaiterCount);
+  for (auto &Waiter : Waiters) {
+    auto Res = Waiter.get();
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 0U);
+  }
+  EXPECT_EQ(notify(VM, 8, WaiterCount), 0U);
+}
+
+TEST(WaitNotify, StopWakesWaiters) {
+  WasmEdge::VM::VM VM(createConfigure());
+  ASSERT_TRUE(VM.loadWasm(WaitNotifyWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto Waiter = VM.asyncExecute(
+      "wait",
+      std::initializer_list<WasmEdge::ValVariant>{UINT32_C(8), UINT32_C(0),
+                                                  INT64_C(-1)},
+      {WasmEdge::ValType::I32, WasmEdge::ValType::I32,
+       WasmEdge::ValType::I64});
+  while (!Waiter.waitFor(10ms)) {
+    Waiter.cancel();
+  }
+  auto Res = Waiter.get();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+}
+
+/// Contention benchmark: several threads repeatedly take a wait/notify based
+/// mutex inside the guest. Reports the lock throughput and checks that no
+/// increment under the lock was lost.
+TEST(WaitNotify, ContentionBenchmark) {
+  const uint32_t ThreadCount =
+      std::max(4U, std::thread::hardware_concurrency());
+  constexpr uint32_t Iterations = 20000;
+  WasmEdge::VM::VM VM(createConfigure());
+  ASSERT_TRUE(VM.loadWasm(WaitNotifyWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  const auto Start = std::chrono::steady_clock::now();
+  std::vector<WasmEdge::VM::Async<ResultT>> Workers;
+  for (uint32_t I = 0; I < ThreadCount; ++I) {
+    Workers.push_back(VM.asyncExecute(
+        "contend", std::initializer_list<WasmEdge::ValVariant>{Iterations},
+        {WasmEdge::ValType::I32}));
+  }
+  for (auto &Worker : Workers) {
+    EXPECT_TRUE(Worker.get());
+  }
+  const auto Elapsed = std::chrono::steady_clock::now() - Start;
+
+  auto Res = VM.execute("counter");
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), ThreadCount * Iterations);
+
+  const auto Nano =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count();
+  std::cout << "[ BENCHMARK] " << ThreadCount << " threads x " << Iterations
+            << " lock/unlock: " << Nano / 1000000 << " ms, "
+            << Nano / (ThreadCount * Iterations) << " ns per lock\n";
+}
+
+} // namespace